@@ -0,0 +1,76 @@
+#ifndef LANTERN_BENCHMARK_UTILS_H
+#define LANTERN_BENCHMARK_UTILS_H
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/** Benchmark registered with BENCHMARK macro */
+class benchmark_info final
+{
+public:
+	/** Full benchmark name: group.name */
+	std::string name;
+
+	/** Benchmark body */
+	std::function<void()> function;
+};
+
+/** Gets all the registered benchmarks
+* @returns Benchmarks storage
+*/
+inline std::vector<benchmark_info>& get_benchmarks()
+{
+	static std::vector<benchmark_info> benchmarks;
+	return benchmarks;
+}
+
+/** Registers benchmark on construction, used by BENCHMARK macro */
+class benchmark_registrar final
+{
+public:
+	benchmark_registrar(char const* name, std::function<void()> const function)
+	{
+		get_benchmarks().push_back(benchmark_info{name, function});
+	}
+};
+
+/** Defines and registers benchmark function, works similar to gtest's TEST */
+#define BENCHMARK(group, name) \
+	static void benchmark_##group##_##name(); \
+	static benchmark_registrar const benchmark_registrar_##group##_##name{#group "." #name, &benchmark_##group##_##name}; \
+	static void benchmark_##group##_##name()
+
+/** Measures average time of function execution
+* @param iterations_count How many times to execute the function
+* @param function Function to measure
+* @returns Average execution time in milliseconds
+*/
+inline double measure_milliseconds(unsigned int const iterations_count, std::function<void()> const& function)
+{
+	// Warm up caches and lazily created resources
+	function();
+
+	std::chrono::high_resolution_clock::time_point const start{std::chrono::high_resolution_clock::now()};
+	for (unsigned int i{0}; i < iterations_count; ++i)
+	{
+		function();
+	}
+	std::chrono::high_resolution_clock::time_point const end{std::chrono::high_resolution_clock::now()};
+
+	return std::chrono::duration<double, std::milli>(end - start).count() / iterations_count;
+}
+
+/** Prints one measurement result
+* @param case_name Name of the measured case
+* @param value Measured value
+* @param units Value units
+*/
+inline void report_measurement(std::string const& case_name, double const value, char const* units)
+{
+	std::printf("  %-40s %12.3f %s\n", case_name.c_str(), value, units);
+}
+
+#endif // LANTERN_BENCHMARK_UTILS_H
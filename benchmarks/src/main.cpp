@@ -0,0 +1,22 @@
+#include <cstdio>
+#include <cstring>
+#include "benchmark_utils.h"
+
+/** Runs all the benchmarks, or only those which names start with the first argument */
+int main(int argc, char** argv)
+{
+	char const* const filter{argc > 1 ? argv[1] : ""};
+
+	for (benchmark_info const& benchmark : get_benchmarks())
+	{
+		if (std::strncmp(benchmark.name.c_str(), filter, std::strlen(filter)) != 0)
+		{
+			continue;
+		}
+
+		std::printf("[ %s ]\n", benchmark.name.c_str());
+		benchmark.function();
+	}
+
+	return 0;
+}
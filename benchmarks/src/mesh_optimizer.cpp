@@ -0,0 +1,140 @@
+#include <cmath>
+#include <string>
+#include <utility>
+#include "benchmark_utils.h"
+#include "mesh_optimizer.h"
+#include "obj_import.h"
+#include "renderer.h"
+#include "color_shader.h"
+
+using namespace lantern;
+
+/** Builds sphere mesh with per-vertex colors and triangles in random order, the way authoring tools often export them
+* @param rings_count Count of rings from pole to pole
+* @param segments_count Count of segments around the axis
+* @returns Mesh
+*/
+static mesh create_shuffled_sphere_mesh(unsigned int const rings_count, unsigned int const segments_count)
+{
+	std::vector<vector3f> vertices;
+	std::vector<color> colors;
+
+	for (unsigned int ring{0}; ring <= rings_count; ++ring)
+	{
+		float const theta{static_cast<float>(M_PI) * static_cast<float>(ring) / static_cast<float>(rings_count)};
+
+		for (unsigned int segment{0}; segment <= segments_count; ++segment)
+		{
+			float const phi{2.0f * static_cast<float>(M_PI) * static_cast<float>(segment) / static_cast<float>(segments_count)};
+
+			vector3f const direction{std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+			vertices.push_back(direction * 0.9f);
+			colors.push_back(color{direction.x * 0.5f + 0.5f, direction.y * 0.5f + 0.5f, direction.z * 0.5f + 0.5f, 1.0f});
+		}
+	}
+
+	std::vector<unsigned int> indices;
+	for (unsigned int ring{0}; ring < rings_count; ++ring)
+	{
+		for (unsigned int segment{0}; segment < segments_count; ++segment)
+		{
+			unsigned int const top_left{ring * (segments_count + 1) + segment};
+			unsigned int const bottom_left{top_left + segments_count + 1};
+
+			indices.insert(indices.end(), {top_left, bottom_left, top_left + 1});
+			indices.insert(indices.end(), {top_left + 1, bottom_left, bottom_left + 1});
+		}
+	}
+
+	// Shuffle triangles
+	//
+
+	unsigned int random_state{12345};
+	unsigned int const triangles_count{static_cast<unsigned int>(indices.size() / 3)};
+	for (unsigned int i{triangles_count - 1}; i > 0; --i)
+	{
+		random_state = random_state * 1103515245 + 12345;
+		unsigned int const j{(random_state >> 8) % (i + 1)};
+
+		for (unsigned int k{0}; k < 3; ++k)
+		{
+			std::swap(indices[i * 3 + k], indices[j * 3 + k]);
+		}
+	}
+
+	mesh result{vertices, indices};
+	result.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+
+	return result;
+}
+
+/** Builds unit cube mesh from .obj resource with per-vertex colors
+* @returns Mesh
+*/
+static mesh create_unit_cube_mesh()
+{
+	mesh result{compile_mesh(load_mesh_from_obj("resources/unit_cube_pos_texcoord_normal.obj", true, true))};
+
+	std::vector<color> colors;
+	for (vector3f const& v : result.get_vertices())
+	{
+		colors.push_back(color{v.x, v.y, v.z, 1.0f});
+	}
+
+	result.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+
+	return result;
+}
+
+/** Measures vertex cache efficiency and rendering time of a mesh before and after optimization
+* @param name Mesh name to report
+* @param source Mesh to optimize
+* @param model_matrix Matrix placing the mesh in normalized device coordinates
+*/
+static void measure_optimization(std::string const& name, mesh const& source, matrix4x4f const& model_matrix)
+{
+	unsigned int const width{1280};
+	unsigned int const height{720};
+	unsigned int const iterations_count{10};
+
+	mesh optimized{source};
+	optimize_mesh(optimized);
+
+	color_shader shader;
+	shader.set_mvp_matrix(model_matrix);
+
+	texture target_texture{width, height};
+	depth_buffer target_depth_buffer{width, height};
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+
+	auto measure_rendering = [&](mesh const& m)
+	{
+		return measure_milliseconds(
+			iterations_count,
+			[&]()
+			{
+				target_texture.clear(0);
+				target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+				r.render_mesh(m, shader, target_texture, target_depth_buffer);
+			});
+	};
+
+	report_measurement(name + ", ACMR before", get_average_cache_miss_ratio(source.get_indices(), DEFAULT_VERTEX_CACHE_SIZE), "vertices/triangle");
+	report_measurement(name + ", ACMR after", get_average_cache_miss_ratio(optimized.get_indices(), DEFAULT_VERTEX_CACHE_SIZE), "vertices/triangle");
+	report_measurement(name + ", rendering before", measure_rendering(source), "ms/frame");
+	report_measurement(name + ", rendering after", measure_rendering(optimized), "ms/frame");
+}
+
+BENCHMARK(mesh_optimizer, acmr_and_rendering_time)
+{
+	measure_optimization(
+		"unit cube",
+		create_unit_cube_mesh(),
+		matrix4x4f::translation(-0.5f, -0.5f, -0.5f) * matrix4x4f::rotation_around_y_axis(0.6f) * matrix4x4f::rotation_around_x_axis(0.4f));
+
+	measure_optimization("sphere", create_shuffled_sphere_mesh(256, 512), matrix4x4f::IDENTITY);
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "benchmark_utils.h"
+#include "obj_import.h"
+
+using namespace lantern;
+
+/** Reader ignoring all the definitions, measures parsing only */
+class null_obj_reader final : public obj_reader
+{
+};
+
+/** Writes .obj file of a grid with texcoords and normals, formatted the way exporters usually do it
+* @param path Path to write file to
+* @param size Count of quads along every side
+* @returns File size in bytes
+*/
+static size_t write_grid_obj(std::string const& path, unsigned int const size)
+{
+	std::ofstream file{path};
+
+	for (unsigned int y{0}; y <= size; ++y)
+	{
+		for (unsigned int x{0}; x <= size; ++x)
+		{
+			float const u{static_cast<float>(x) / static_cast<float>(size)};
+			float const v{static_cast<float>(y) / static_cast<float>(size)};
+
+			file << "v " << u * 2.0f - 1.0f << " " << v * 2.0f - 1.0f << " " << u * v * 0.25f << "\n";
+			file << "vt " << u << " " << v << "\n";
+			file << "vn " << -v * 0.25f << " " << -u * 0.25f << " " << 1.0f << "\n";
+		}
+	}
+
+	for (unsigned int y{0}; y < size; ++y)
+	{
+		for (unsigned int x{0}; x < size; ++x)
+		{
+			unsigned int const i0{y * (size + 1) + x + 1};
+			unsigned int const i1{i0 + 1};
+			unsigned int const i2{i0 + size + 1};
+			unsigned int const i3{i2 + 1};
+
+			file << "f " << i0 << "/" << i0 << "/" << i0 << " " << i1 << "/" << i1 << "/" << i1 << " " << i2 << "/" << i2 << "/" << i2 << "\n";
+			file << "f " << i1 << "/" << i1 << "/" << i1 << " " << i3 << "/" << i3 << "/" << i3 << " " << i2 << "/" << i2 << "/" << i2 << "\n";
+		}
+	}
+
+	return static_cast<size_t>(file.tellp());
+}
+
+BENCHMARK(obj_import, parse_throughput)
+{
+	std::string const path{"obj_import_benchmark.obj"};
+	unsigned int const iterations_count{5};
+
+	double const megabytes{static_cast<double>(write_grid_obj(path, 600)) / (1024.0 * 1024.0)};
+
+	null_obj_reader reader;
+	report_measurement(
+		"parsing",
+		megabytes / (measure_milliseconds(iterations_count, [&]() { reader.read(path); }) / 1000.0),
+		"MB/s");
+
+	report_measurement(
+		"importing mesh",
+		megabytes / (measure_milliseconds(iterations_count, [&]() { load_mesh_from_obj(path, true, true); }) / 1000.0),
+		"MB/s");
+
+	std::remove(path.c_str());
+}
+
+BENCHMARK(obj_import, parallel_importing_scaling)
+{
+	std::string const path{"obj_import_parallel_benchmark.obj"};
+	unsigned int const iterations_count{5};
+
+	double const megabytes{static_cast<double>(write_grid_obj(path, 1000)) / (1024.0 * 1024.0)};
+
+	report_measurement(
+		"serial",
+		megabytes / (measure_milliseconds(iterations_count, [&]() { load_mesh_from_obj(path, true, true); }) / 1000.0),
+		"MB/s");
+
+	unsigned int const max_threads_count{thread_pool::get_hardware_threads_count()};
+	for (unsigned int threads_count{1}; ; threads_count *= 2)
+	{
+		threads_count = std::min(threads_count, max_threads_count);
+
+		thread_pool pool{threads_count};
+		report_measurement(
+			"parallel, threads: " + std::to_string(threads_count),
+			megabytes / (measure_milliseconds(iterations_count, [&]() { load_mesh_from_obj(path, true, true, pool); }) / 1000.0),
+			"MB/s");
+
+		if (threads_count == max_threads_count)
+		{
+			break;
+		}
+	}
+
+	std::remove(path.c_str());
+}
+
+BENCHMARK(obj_import, binary_cache)
+{
+	std::string const path{"obj_import_cache_benchmark.obj"};
+	std::string const cache_path{path + ".lmesh"};
+	unsigned int const iterations_count{5};
+
+	write_grid_obj(path, 600);
+	std::remove(cache_path.c_str());
+
+	report_measurement(
+		"parsing .obj",
+		measure_milliseconds(iterations_count, [&]() { load_mesh_from_obj(path, true, true); }),
+		"ms");
+
+	for (obj_cache_validation_option const validation : {obj_cache_validation_option::modification_time, obj_cache_validation_option::content_hash})
+	{
+		// First load builds the cache
+		//
+		load_mesh_from_obj_cached(path, true, true, validation);
+
+		report_measurement(
+			validation == obj_cache_validation_option::modification_time ? "cached, modification time validation" : "cached, content hash validation",
+			measure_milliseconds(iterations_count, [&]() { load_mesh_from_obj_cached(path, true, true, validation); }),
+			"ms");
+	}
+
+	std::remove(path.c_str());
+	std::remove(cache_path.c_str());
+}
@@ -0,0 +1,151 @@
+#include <string>
+#include <vector>
+#include "benchmark_utils.h"
+#include "rasterizing_stage.h"
+
+using namespace lantern;
+
+/** Shader without any attributes, rasterizing stage doesn't call it */
+class empty_shader final
+{
+};
+
+/** Shader with a linearly interpolated color and a perspective corrected texture coordinates */
+class interpolated_shader final
+{
+public:
+	/** Color bind point */
+	color interpolated_color;
+
+	/** Texture coordinates bind point */
+	vector2f interpolated_uv;
+};
+
+/** Delegate counting pixels passed by rasterizing stage */
+class pixels_counter final
+{
+public:
+	template<typename TShader>
+	void process_rasterizing_stage_result(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture)
+	{
+		++pixels_count;
+	}
+
+	/** Count of processed pixels */
+	unsigned long long pixels_count;
+};
+
+/** Measures rasterization speed of large triangles without any per-pixel work
+* @param algorithm Algorithm to measure
+* @param name Name to report
+*/
+static void measure_fill_rate(rasterization_algorithm_option const algorithm, std::string const& name)
+{
+	unsigned int const width{1920};
+	unsigned int const height{1080};
+
+	texture target_texture{width, height};
+
+	// Large triangles in screen space, with the second half of bounding box empty as it usually is
+	//
+	std::vector<vector4f> const vertices{
+		vector4f{10.3f, 20.7f, 0.0f, 1.0f}, vector4f{15.1f, 1070.2f, 0.0f, 1.0f}, vector4f{1900.6f, 1060.4f, 0.0f, 1.0f},
+		vector4f{1910.2f, 15.5f, 0.0f, 1.0f}, vector4f{30.1f, 10.9f, 0.0f, 1.0f}, vector4f{1890.4f, 1030.3f, 0.0f, 1.0f},
+		vector4f{400.5f, 100.5f, 0.0f, 1.0f}, vector4f{200.2f, 900.8f, 0.0f, 1.0f}, vector4f{1500.7f, 700.1f, 0.0f, 1.0f}};
+
+	empty_shader shader;
+	binded_mesh_attributes const binded_attributes;
+	pixels_counter counter{0};
+
+	rasterizing_stage stage;
+	stage.set_rasterization_algorithm(algorithm);
+
+	double const milliseconds{measure_milliseconds(
+		20,
+		[&]()
+		{
+			for (size_t i{0}; i < vertices.size(); i += 3)
+			{
+				stage.invoke(vertices[i], vertices[i + 1], vertices[i + 2], 0, 0, 0, shader, binded_attributes, target_texture, counter);
+			}
+		})};
+
+	// Measurement executes frame 21 times including warm up
+	double const pixels_per_frame{static_cast<double>(counter.pixels_count) / 21.0};
+	report_measurement(name, pixels_per_frame / milliseconds / 1000.0, "Mpixels/s");
+}
+
+/** Measures cost of a covered pixel when rasterizer interpolates attributes
+* @param algorithm Algorithm to measure
+* @param name Name to report
+*/
+static void measure_interpolation_cost(rasterization_algorithm_option const algorithm, std::string const& name)
+{
+	unsigned int const width{1920};
+	unsigned int const height{1080};
+
+	texture target_texture{width, height};
+
+	std::vector<vector4f> const vertices{
+		vector4f{10.3f, 20.7f, 0.1f, 1.0f}, vector4f{15.1f, 1070.2f, 0.5f, 0.5f}, vector4f{1900.6f, 1060.4f, 0.9f, 0.25f},
+		vector4f{1910.2f, 15.5f, 0.2f, 0.8f}, vector4f{30.1f, 10.9f, 0.4f, 0.6f}, vector4f{1890.4f, 1030.3f, 0.6f, 0.3f}};
+
+	std::vector<unsigned int> const indices{0, 1, 2, 3, 4, 5};
+	mesh_attribute_info<color> const colors{
+		0,
+		std::vector<color>{color::RED, color::GREEN, color::BLUE, color::WHITE, color::BLACK, color::RED},
+		indices,
+		attribute_interpolation_option::linear};
+	mesh_attribute_info<vector2f> const uvs{
+		1,
+		std::vector<vector2f>{vector2f{0.0f, 0.0f}, vector2f{0.0f, 1.0f}, vector2f{1.0f, 1.0f}, vector2f{1.0f, 0.0f}, vector2f{0.0f, 0.0f}, vector2f{1.0f, 1.0f}},
+		indices,
+		attribute_interpolation_option::perspective_correct};
+
+	interpolated_shader shader;
+	std::vector<clipped_vertex_info> const clipped_vertices;
+
+	binded_mesh_attributes binded_attributes;
+	binded_attributes.color_attributes.push_back(binded_mesh_attribute_info<color>{colors, &shader.interpolated_color, &clipped_vertices});
+	binded_attributes.vector2f_attributes.push_back(binded_mesh_attribute_info<vector2f>{uvs, &shader.interpolated_uv, &clipped_vertices});
+
+	pixels_counter counter{0};
+
+	rasterizing_stage stage;
+	stage.set_rasterization_algorithm(algorithm);
+
+	double const milliseconds{measure_milliseconds(
+		10,
+		[&]()
+		{
+			for (size_t i{0}; i < vertices.size(); i += 3)
+			{
+				stage.invoke(vertices[i], vertices[i + 1], vertices[i + 2], i, i + 1, i + 2, shader, binded_attributes, target_texture, counter);
+			}
+		})};
+
+	// Measurement executes frame 11 times including warm up
+	double const pixels_per_frame{static_cast<double>(counter.pixels_count) / 11.0};
+	report_measurement(name, milliseconds * 1000000.0 / pixels_per_frame, "ns/pixel");
+}
+
+BENCHMARK(rasterizing_stage, fill_rate)
+{
+	measure_fill_rate(rasterization_algorithm_option::traversal_aabb, "traversal_aabb");
+	measure_fill_rate(rasterization_algorithm_option::traversal_aabb_fixed_point, "traversal_aabb_fixed_point");
+	measure_fill_rate(rasterization_algorithm_option::traversal_aabb_simd, "traversal_aabb_simd");
+	measure_fill_rate(rasterization_algorithm_option::traversal_hierarchical, "traversal_hierarchical");
+	measure_fill_rate(rasterization_algorithm_option::traversal_backtracking, "traversal_backtracking");
+	measure_fill_rate(rasterization_algorithm_option::traversal_zigzag, "traversal_zigzag");
+	measure_fill_rate(rasterization_algorithm_option::homogeneous, "homogeneous");
+}
+
+BENCHMARK(rasterizing_stage, interpolation_cost)
+{
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_aabb, "traversal_aabb");
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_aabb_fixed_point, "traversal_aabb_fixed_point");
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_aabb_simd, "traversal_aabb_simd");
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_hierarchical, "traversal_hierarchical");
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_backtracking, "traversal_backtracking");
+	measure_interpolation_cost(rasterization_algorithm_option::traversal_zigzag, "traversal_zigzag");
+}
@@ -0,0 +1,320 @@
+#include <string>
+#include "benchmark_utils.h"
+#include "renderer.h"
+#include "color_shader.h"
+#include "draw_list.h"
+
+using namespace lantern;
+
+/** Builds mesh of randomly placed overlapping triangles with per-vertex colors
+* @param triangles_count Count of triangles
+* @param max_size Max triangle size in normalized device coordinates
+* @returns Mesh
+*/
+static mesh create_random_triangles_mesh(unsigned int const triangles_count, float const max_size)
+{
+	std::vector<vector3f> vertices;
+	std::vector<unsigned int> indices;
+	std::vector<color> colors;
+
+	unsigned int random_state{12345};
+	auto next_random = [&random_state]()
+	{
+		random_state = random_state * 1103515245 + 12345;
+		return static_cast<float>((random_state >> 8) & 0xFFFF) / 65535.0f;
+	};
+
+	for (unsigned int i{0}; i < triangles_count; ++i)
+	{
+		vector3f const center{next_random() * 1.6f - 0.8f, next_random() * 1.6f - 0.8f, next_random() * 1.8f - 0.9f};
+
+		// Counterclockwise order so that every triangle is visible
+		//
+		float const size{max_size * (0.25f + 0.75f * next_random())};
+		vertices.push_back(vector3f{center.x - size / 2.0f, center.y - size / 2.0f, center.z});
+		vertices.push_back(vector3f{center.x + size / 2.0f, center.y - size / 2.0f, center.z});
+		vertices.push_back(vector3f{center.x, center.y + size / 2.0f, center.z});
+
+		for (unsigned int j{0}; j < 3; ++j)
+		{
+			colors.push_back(color{next_random(), next_random(), next_random(), 1.0f});
+			indices.push_back(i * 3 + j);
+		}
+	}
+
+	mesh result{vertices, indices};
+	result.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, indices, attribute_interpolation_option::linear});
+
+	return result;
+}
+
+BENCHMARK(renderer, tiled_mode_scaling)
+{
+	// Same scene is rendered serially and then in tiled mode with increasing threads count
+	//
+
+	unsigned int const width{1280};
+	unsigned int const height{720};
+	unsigned int const iterations_count{5};
+
+	mesh const scene{create_random_triangles_mesh(5000, 0.2f)};
+
+	color_shader shader;
+	shader.set_mvp_matrix(matrix4x4f::IDENTITY);
+
+	texture target_texture{width, height};
+	depth_buffer target_depth_buffer{width, height};
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+
+	auto render_frame = [&]()
+	{
+		target_texture.clear(0);
+		target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+		r.render_mesh(scene, shader, target_texture, target_depth_buffer);
+	};
+
+	r.set_rendering_mode(rendering_mode_option::serial);
+	report_measurement("serial", measure_milliseconds(iterations_count, render_frame), "ms/frame");
+
+	r.set_rendering_mode(rendering_mode_option::tiled);
+
+	unsigned int const max_threads_count{thread_pool::get_hardware_threads_count()};
+	for (unsigned int threads_count{1}; ; threads_count *= 2)
+	{
+		threads_count = std::min(threads_count, max_threads_count);
+
+		r.set_threads_count(threads_count);
+		report_measurement(
+			"tiled, threads: " + std::to_string(threads_count),
+			measure_milliseconds(iterations_count, render_frame),
+			"ms/frame");
+
+		if (threads_count == max_threads_count)
+		{
+			break;
+		}
+	}
+}
+
+/** Shader transforming vertices one by one, without batch method */
+class per_vertex_color_shader final
+{
+public:
+	per_vertex_color_shader(matrix4x4f const& mvp)
+		: m_mvp(mvp)
+	{
+
+	}
+
+	vector4f process_vertex(vector4f const& vertex)
+	{
+		return vertex * m_mvp;
+	}
+
+private:
+	matrix4x4f const m_mvp;
+};
+
+/** Drops triangles passed by geometry stage, so that only vertex processing and clipping are measured */
+class discarding_geometry_stage_delegate final
+{
+public:
+	template<typename TShader>
+	void process_geometry_stage_result(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		texture& target_texture)
+	{
+
+	}
+};
+
+BENCHMARK(renderer, vertex_processing)
+{
+	// Geometry stage alone, vertices processed one by one, by batches and taken from the cache
+	//
+
+	unsigned int const iterations_count{10};
+
+	mesh const scene{create_random_triangles_mesh(200000, 0.01f)};
+	size_t const vertices_count{scene.get_vertices().size()};
+
+	matrix4x4f const mvp{matrix4x4f::rotation_around_y_axis(0.1f) * matrix4x4f::translation(0.0f, 0.0f, 2.0f) * matrix4x4f::clip_space(1.5f, 1.0f, 0.5f, 10.0f)};
+
+	per_vertex_color_shader per_vertex_shader{mvp};
+
+	color_shader batched_shader;
+	batched_shader.set_mvp_matrix(mvp);
+
+	texture target_texture{1280, 720};
+	geometry_stage stage;
+	discarding_geometry_stage_delegate delegate;
+
+	auto report_throughput = [&](std::string const& case_name, double const milliseconds)
+	{
+		report_measurement(case_name, static_cast<double>(vertices_count) / milliseconds / 1000.0, "Mvertices/s");
+	};
+
+	report_throughput(
+		"one by one",
+		measure_milliseconds(
+			iterations_count,
+			[&]() { stage.invoke(scene, 0, scene.get_indices().size(), per_vertex_shader, true, target_texture, delegate); }));
+
+	report_throughput(
+		"batched",
+		measure_milliseconds(
+			iterations_count,
+			[&]() { stage.invoke(scene, 0, scene.get_indices().size(), batched_shader, true, target_texture, delegate); }));
+
+	// Nothing changes between iterations, so vertices are transformed once
+	//
+	stage.set_transformed_vertices_cache_size(1);
+	report_throughput(
+		"cached",
+		measure_milliseconds(
+			iterations_count,
+			[&]() { stage.invoke(scene, 0, scene.get_indices().size(), batched_shader, true, target_texture, delegate); }));
+}
+
+BENCHMARK(renderer, instanced_rendering)
+{
+	// Many small copies of the same mesh, drawn one by one and as instances
+	//
+
+	unsigned int const width{1280};
+	unsigned int const height{720};
+	unsigned int const iterations_count{5};
+	unsigned int const instances_count{2000};
+
+	mesh const instance_mesh{create_random_triangles_mesh(20, 0.5f)};
+
+	std::vector<matrix4x4f> instances;
+	for (unsigned int i{0}; i < instances_count; ++i)
+	{
+		float const x{static_cast<float>(i % 50) / 25.0f - 0.98f};
+		float const y{static_cast<float>(i / 50) / 20.0f - 0.98f};
+		instances.push_back(matrix4x4f::uniform_scale(0.05f) * matrix4x4f::translation(x, y, 0.0f));
+	}
+
+	color_shader shader;
+
+	texture target_texture{width, height};
+	depth_buffer target_depth_buffer{width, height};
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+
+	for (rendering_mode_option const mode : {rendering_mode_option::serial, rendering_mode_option::tiled})
+	{
+		r.set_rendering_mode(mode);
+		std::string const mode_name{(mode == rendering_mode_option::serial) ? "serial" : "tiled"};
+
+		report_measurement(
+			mode_name + ", one by one",
+			measure_milliseconds(
+				iterations_count,
+				[&]()
+				{
+					target_texture.clear(0);
+					target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+					for (matrix4x4f const& instance : instances)
+					{
+						shader.set_mvp_matrix(instance);
+						r.render_mesh(instance_mesh, shader, target_texture, target_depth_buffer);
+					}
+				}),
+			"ms/frame");
+
+		report_measurement(
+			mode_name + ", instanced",
+			measure_milliseconds(
+				iterations_count,
+				[&]()
+				{
+					target_texture.clear(0);
+					target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+					r.render_mesh_instanced(instance_mesh, shader, instances, target_texture, target_depth_buffer);
+				}),
+			"ms/frame");
+	}
+}
+
+BENCHMARK(renderer, sorted_draw_list)
+{
+	// Overlapping layers submitted from far to near, drawn in that order and sorted front-to-back by draw list
+	//
+
+	unsigned int const width{1280};
+	unsigned int const height{720};
+	unsigned int const iterations_count{5};
+	unsigned int const layers_count{16};
+
+	std::vector<unsigned int> const indices{0, 1, 2, 2, 1, 3};
+	std::vector<color> const colors{
+		color{1.0f, 0.0f, 0.0f, 1.0f}, color{0.0f, 1.0f, 0.0f, 1.0f}, color{0.0f, 0.0f, 1.0f, 1.0f}, color{1.0f, 1.0f, 1.0f, 1.0f}};
+
+	std::vector<mesh> layers;
+	std::vector<float> depths;
+	for (unsigned int i{0}; i < layers_count; ++i)
+	{
+		float const z{0.9f - 1.8f * static_cast<float>(i) / static_cast<float>(layers_count)};
+		float const size{0.6f + 0.3f * static_cast<float>(i % 2)};
+
+		mesh layer{
+			std::vector<vector3f>{vector3f{-size, -size, z}, vector3f{size, -size, z}, vector3f{-size, size, z}, vector3f{size, size, z}},
+			indices};
+		layer.get_color_attributes().push_back(
+			mesh_attribute_info<color>{COLOR_ATTR_ID, colors, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+
+		layers.push_back(layer);
+		depths.push_back(z + 1.0f);
+	}
+
+	color_shader shader;
+	shader.set_mvp_matrix(matrix4x4f::uniform_scale(1.0f));
+
+	texture target_texture{width, height};
+	depth_buffer target_depth_buffer{width, height};
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+
+	draw_list list;
+
+	report_measurement(
+		"submission order",
+		measure_milliseconds(
+			iterations_count,
+			[&]()
+			{
+				target_texture.clear(0);
+				target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+				for (mesh const& layer : layers)
+				{
+					r.render_mesh(layer, shader, target_texture, target_depth_buffer);
+				}
+			}),
+		"ms/frame");
+
+	report_measurement(
+		"draw list",
+		measure_milliseconds(
+			iterations_count,
+			[&]()
+			{
+				target_texture.clear(0);
+				target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+				for (size_t i{0}; i < layers.size(); ++i)
+				{
+					list.add_mesh(layers[i], shader, draw_settings{&target_texture, &target_depth_buffer, false, 0, depths[i]});
+				}
+
+				list.execute(r);
+			}),
+		"ms/frame");
+}
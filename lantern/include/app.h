@@ -5,6 +5,7 @@
 #include FT_FREETYPE_H
 #include <string>
 #include "SDL.h"
+#include "draw_list.h"
 #include "renderer.h"
 
 namespace lantern
@@ -60,11 +61,21 @@ namespace lantern
 		*/
 		texture& get_target_texture();
 
+		/** Gets depth buffer of the same size as a framebuffer, it's cleared every frame
+		* @returns Target depth buffer
+		*/
+		depth_buffer& get_target_depth_buffer();
+
 		/** Gets rendering pipeline
 		* @returns Pipeline
 		*/
 		renderer& get_renderer();
 
+		/** Gets list of draws executed in sorted order after the frame is handled, it's cleared every frame
+		* @returns Draw list
+		*/
+		draw_list& get_draw_list();
+
 		/** Sets target framerate
 		* @param fps Target framerate
 		*/
@@ -96,9 +107,15 @@ namespace lantern
 		/** Texture we are using as a framebuffer, gets copied into according SDL_Texture to be shown on a screen */
 		texture m_target_texture;
 
+		/** Depth buffer for a framebuffer texture */
+		depth_buffer m_target_depth_buffer;
+
 		/** Rendering pipeline */
 		renderer m_renderer;
 
+		/** Draws recorded during the frame */
+		draw_list m_draw_list;
+
 		/** Delay between frames to stick to the target framerate */
 		Uint32 m_target_framerate_delay;
 
@@ -0,0 +1,322 @@
+#ifndef LANTERN_ATTRIBUTES_INTERPOLATOR_H
+#define LANTERN_ATTRIBUTES_INTERPOLATOR_H
+
+#include <vector>
+#include "color.h"
+#include "vector2.h"
+#include "vector3.h"
+#include "binded_mesh_attributes.h"
+
+namespace lantern
+{
+	/** Describes how attribute value is split into float components for interpolation.
+	* Specialized for every attribute type mesh can have
+	* @ingroup Rendering
+	*/
+	template<typename TAttr>
+	class attribute_components;
+
+	/** Float attribute components */
+	template<>
+	class attribute_components<float> final
+	{
+	public:
+		/** Count of components */
+		static unsigned int const COUNT = 1;
+
+		/** Splits value into components
+		* @param value Value to split
+		* @param components Array to put components into
+		*/
+		static void split(float const value, float* const components)
+		{
+			components[0] = value;
+		}
+
+		/** Makes value from components
+		* @param components Array of components
+		* @returns Value
+		*/
+		static float join(float const* const components)
+		{
+			return components[0];
+		}
+	};
+
+	/** Vector2f attribute components */
+	template<>
+	class attribute_components<vector2f> final
+	{
+	public:
+		/** Count of components */
+		static unsigned int const COUNT = 2;
+
+		/** Splits value into components
+		* @param value Value to split
+		* @param components Array to put components into
+		*/
+		static void split(vector2f const& value, float* const components)
+		{
+			components[0] = value.x;
+			components[1] = value.y;
+		}
+
+		/** Makes value from components
+		* @param components Array of components
+		* @returns Value
+		*/
+		static vector2f join(float const* const components)
+		{
+			return vector2f{components[0], components[1]};
+		}
+	};
+
+	/** Vector3f attribute components */
+	template<>
+	class attribute_components<vector3f> final
+	{
+	public:
+		/** Count of components */
+		static unsigned int const COUNT = 3;
+
+		/** Splits value into components
+		* @param value Value to split
+		* @param components Array to put components into
+		*/
+		static void split(vector3f const& value, float* const components)
+		{
+			components[0] = value.x;
+			components[1] = value.y;
+			components[2] = value.z;
+		}
+
+		/** Makes value from components
+		* @param components Array of components
+		* @returns Value
+		*/
+		static vector3f join(float const* const components)
+		{
+			return vector3f{components[0], components[1], components[2]};
+		}
+	};
+
+	/** Color attribute components */
+	template<>
+	class attribute_components<color> final
+	{
+	public:
+		/** Count of components */
+		static unsigned int const COUNT = 4;
+
+		/** Splits value into components
+		* @param value Value to split
+		* @param components Array to put components into
+		*/
+		static void split(color const& value, float* const components)
+		{
+			components[0] = value.r;
+			components[1] = value.g;
+			components[2] = value.b;
+			components[3] = value.a;
+		}
+
+		/** Makes value from components
+		* @param components Array of components
+		* @returns Value
+		*/
+		static color join(float const* const components)
+		{
+			return color{components[0], components[1], components[2], components[3]};
+		}
+	};
+
+	/** Interpolates all the attributes binded for a triangle.
+	* Triangle setup gathers attributes values of its vertices into flat arrays of float components,
+	* linearly interpolated components first and perspective corrected ones after them,
+	* so that per-pixel work is a plain loop over floats regardless of attributes types and interpolation options.
+	* Every component is stored as a plane equation in barycentric coordinates: value = v1 + (v0 - v1) * b0 + (v2 - v1) * b2
+	* @ingroup Rendering
+	*/
+	class attributes_interpolator final
+	{
+	public:
+		/** Constructs interpolator without attributes */
+		attributes_interpolator();
+
+		/** Prepares interpolation of triangle attributes. Memory is reused between triangles
+		* @param binded_attributes Attributes to interpolate, must stay alive while triangle is rasterized
+		* @param index0 First triangle vertex index in a mesh
+		* @param index1 Second triangle vertex index in a mesh
+		* @param index2 Third triangle vertex index in a mesh
+		*/
+		void setup(binded_mesh_attributes const& binded_attributes, unsigned int const index0, unsigned int const index1, unsigned int const index2);
+
+		/** Interpolates attributes of current triangle and puts values into bind points
+		* @param b0 First barycentric coordinate
+		* @param b1 Second barycentric coordinate
+		* @param b2 Third barycentric coordinate
+		* @param z0_view_space_reciprocal 1/z-view for first vertex
+		* @param z1_view_space_reciprocal 1/z-view for second vertex
+		* @param z2_view_space_reciprocal 1/z-view for third vertex
+		*/
+		void interpolate(
+			float const b0, float const b1, float const b2,
+			float const z0_view_space_reciprocal, float const z1_view_space_reciprocal, float const z2_view_space_reciprocal);
+
+	private:
+		/** Gathers components of attributes with specified interpolation option
+		* @param binds List of binds
+		* @param index0 First triangle vertex index in a mesh
+		* @param index1 Second triangle vertex index in a mesh
+		* @param index2 Third triangle vertex index in a mesh
+		* @param interpolation_option Interpolation option of attributes to gather
+		* @param offsets Storage to put offset of every attribute's first component into
+		*/
+		template<typename TAttr>
+		void setup_attributes(
+			std::vector<binded_mesh_attribute_info<TAttr>> const& binds,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			attribute_interpolation_option const interpolation_option,
+			std::vector<unsigned int>& offsets);
+
+		/** Interpolates range of components
+		* @param from First component to interpolate
+		* @param to Component after the last one to interpolate
+		* @param b0 Weight of the first vertex
+		* @param b2 Weight of the third vertex
+		*/
+		void interpolate_components(unsigned int const from, unsigned int const to, float const b0, float const b2);
+
+		/** Puts interpolated values into bind points
+		* @param binds List of binds
+		* @param offsets Offset of every attribute's first component
+		*/
+		template<typename TAttr>
+		void set_bind_points_values(std::vector<binded_mesh_attribute_info<TAttr>> const& binds, std::vector<unsigned int> const& offsets) const;
+
+		/** Attributes of current triangle */
+		binded_mesh_attributes const* m_binded_attributes;
+
+		/** Components values in the second vertex */
+		std::vector<float> m_vertex1_values;
+
+		/** Differences between components values in the first and the second vertices */
+		std::vector<float> m_vertex0_differences;
+
+		/** Differences between components values in the third and the second vertices */
+		std::vector<float> m_vertex2_differences;
+
+		/** Interpolated components values */
+		std::vector<float> m_interpolated_values;
+
+		/** Count of linearly interpolated components, they go before perspective corrected ones */
+		unsigned int m_linear_components_count;
+
+		/** Offsets of color attributes components */
+		std::vector<unsigned int> m_color_offsets;
+
+		/** Offsets of float attributes components */
+		std::vector<unsigned int> m_float_offsets;
+
+		/** Offsets of vector2f attributes components */
+		std::vector<unsigned int> m_vector2f_offsets;
+
+		/** Offsets of vector3f attributes components */
+		std::vector<unsigned int> m_vector3f_offsets;
+	};
+
+	template<typename TAttr>
+	void attributes_interpolator::setup_attributes(
+		std::vector<binded_mesh_attribute_info<TAttr>> const& binds,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		attribute_interpolation_option const interpolation_option,
+		std::vector<unsigned int>& offsets)
+	{
+		unsigned int const components_count{attribute_components<TAttr>::COUNT};
+
+		size_t const binds_count{binds.size()};
+		for (size_t i{0}; i < binds_count; ++i)
+		{
+			binded_mesh_attribute_info<TAttr> const& binded_attr = binds[i];
+			if (binded_attr.info.get_interpolation_option() != interpolation_option)
+			{
+				continue;
+			}
+
+			offsets[i] = static_cast<unsigned int>(m_vertex1_values.size());
+
+			float value0[components_count];
+			float value1[components_count];
+			float value2[components_count];
+			attribute_components<TAttr>::split(binded_attr.get_vertex_value(index0), value0);
+			attribute_components<TAttr>::split(binded_attr.get_vertex_value(index1), value1);
+			attribute_components<TAttr>::split(binded_attr.get_vertex_value(index2), value2);
+
+			for (unsigned int j{0}; j < components_count; ++j)
+			{
+				m_vertex1_values.push_back(value1[j]);
+				m_vertex0_differences.push_back(value0[j] - value1[j]);
+				m_vertex2_differences.push_back(value2[j] - value1[j]);
+			}
+		}
+	}
+
+	inline void attributes_interpolator::interpolate(
+		float const b0, float const b1, float const b2,
+		float const z0_view_space_reciprocal, float const z1_view_space_reciprocal, float const z2_view_space_reciprocal)
+	{
+		unsigned int const components_count{static_cast<unsigned int>(m_vertex1_values.size())};
+		if (components_count == 0)
+		{
+			return;
+		}
+
+		interpolate_components(0, m_linear_components_count, b0, b2);
+
+		if (m_linear_components_count < components_count)
+		{
+			// Attribute divided by view z is an affine function of screen coordinates,
+			// so perspective corrected value uses weights b_i * (1/z_i) / (sum of b_j * (1/z_j))
+			//
+			float const zview_reciprocal_interpolated_inversed{
+				1.0f / (z0_view_space_reciprocal * b0 + z1_view_space_reciprocal * b1 + z2_view_space_reciprocal * b2)};
+
+			interpolate_components(
+				m_linear_components_count,
+				components_count,
+				z0_view_space_reciprocal * b0 * zview_reciprocal_interpolated_inversed,
+				z2_view_space_reciprocal * b2 * zview_reciprocal_interpolated_inversed);
+		}
+
+		set_bind_points_values(m_binded_attributes->color_attributes, m_color_offsets);
+		set_bind_points_values(m_binded_attributes->float_attributes, m_float_offsets);
+		set_bind_points_values(m_binded_attributes->vector2f_attributes, m_vector2f_offsets);
+		set_bind_points_values(m_binded_attributes->vector3f_attributes, m_vector3f_offsets);
+	}
+
+	inline void attributes_interpolator::interpolate_components(unsigned int const from, unsigned int const to, float const b0, float const b2)
+	{
+		float const* const vertex1_values{m_vertex1_values.data()};
+		float const* const vertex0_differences{m_vertex0_differences.data()};
+		float const* const vertex2_differences{m_vertex2_differences.data()};
+		float* const interpolated_values{m_interpolated_values.data()};
+
+		for (unsigned int i{from}; i < to; ++i)
+		{
+			interpolated_values[i] = vertex1_values[i] + vertex0_differences[i] * b0 + vertex2_differences[i] * b2;
+		}
+	}
+
+	template<typename TAttr>
+	inline void attributes_interpolator::set_bind_points_values(
+		std::vector<binded_mesh_attribute_info<TAttr>> const& binds, std::vector<unsigned int> const& offsets) const
+	{
+		size_t const binds_count{binds.size()};
+		for (size_t i{0}; i < binds_count; ++i)
+		{
+			(*binds[i].bind_point) = attribute_components<TAttr>::join(m_interpolated_values.data() + offsets[i]);
+		}
+	}
+}
+
+#endif // LANTERN_ATTRIBUTES_INTERPOLATOR_H
@@ -0,0 +1,97 @@
+#ifndef LANTERN_BINDED_MESH_ATTRIBUTES_H
+#define LANTERN_BINDED_MESH_ATTRIBUTES_H
+
+#include <vector>
+#include "color.h"
+#include "vector2.h"
+#include "vector3.h"
+#include "mesh_attribute_info.h"
+#include "clipped_vertex_info.h"
+
+namespace lantern
+{
+	/** Class that holds information about binded attribute: its info and bind point.
+	* It's required when we rasterize a triangle: we need to know where put each attribute's interpolated value
+	* @ingroup Rendering
+	*/
+	template<typename TAttr>
+	class binded_mesh_attribute_info final
+	{
+	public:
+		/** Attribute data */
+		mesh_attribute_info<TAttr> const& info;
+
+		/** Address of variable to put interpolated value into */
+		TAttr* bind_point;
+
+		/** Vertices created by clipping, referenced by indices with CLIPPED_VERTEX_INDEX_FLAG set */
+		std::vector<clipped_vertex_info> const* clipped_vertices;
+
+		/** Gets attribute value of a vertex
+		* @param index Mesh vertex index or clipped vertex index with CLIPPED_VERTEX_INDEX_FLAG set
+		* @returns Attribute value
+		*/
+		TAttr get_vertex_value(unsigned int const index) const;
+
+	private:
+		/** Gets attribute value of a mesh vertex
+		* @param index Mesh vertex index
+		* @returns Attribute value
+		*/
+		TAttr get_mesh_vertex_value(unsigned int const index) const;
+	};
+
+	template<typename TAttr>
+	inline TAttr binded_mesh_attribute_info<TAttr>::get_vertex_value(unsigned int const index) const
+	{
+		if ((index & CLIPPED_VERTEX_INDEX_FLAG) == 0)
+		{
+			return get_mesh_vertex_value(index);
+		}
+
+		clipped_vertex_info const& clipped_vertex = (*clipped_vertices)[index & ~CLIPPED_VERTEX_INDEX_FLAG];
+
+		return
+			get_mesh_vertex_value(clipped_vertex.indices[0]) * clipped_vertex.weights[0] +
+			get_mesh_vertex_value(clipped_vertex.indices[1]) * clipped_vertex.weights[1] +
+			get_mesh_vertex_value(clipped_vertex.indices[2]) * clipped_vertex.weights[2];
+	}
+
+	template<typename TAttr>
+	inline TAttr binded_mesh_attribute_info<TAttr>::get_mesh_vertex_value(unsigned int const index) const
+	{
+		std::vector<TAttr> const& data = info.get_data();
+		std::vector<unsigned int> const& indices = info.get_indices();
+
+		// Compiled meshes store attributes values per vertex
+		//
+		if (indices.empty())
+		{
+			return data[index];
+		}
+
+		return data[indices[index]];
+	}
+
+	/** Container for all the binds
+	* @ingroup Rendering
+	*/
+	class binded_mesh_attributes final
+	{
+	public:
+		std::vector<binded_mesh_attribute_info<color>> color_attributes;
+		std::vector<binded_mesh_attribute_info<float>> float_attributes;
+		std::vector<binded_mesh_attribute_info<vector2f>> vector2f_attributes;
+		std::vector<binded_mesh_attribute_info<vector3f>> vector3f_attributes;
+
+		/** Checks if there are no binds at all, e.g. when shader only outputs depth or a constant color
+		* @returns True if there are no binds
+		*/
+		bool empty() const
+		{
+			return color_attributes.empty() && float_attributes.empty() && vector2f_attributes.empty() && vector3f_attributes.empty();
+		}
+	};
+}
+
+#endif // LANTERN_BINDED_MESH_ATTRIBUTES_H
@@ -0,0 +1,24 @@
+#ifndef LANTERN_CLIPPED_VERTEX_INFO_H
+#define LANTERN_CLIPPED_VERTEX_INFO_H
+
+namespace lantern
+{
+	/** Flag marking vertex index that refers to a vertex created by clipping rather than to a mesh vertex */
+	unsigned int const CLIPPED_VERTEX_INDEX_FLAG = 0x80000000;
+
+	/** Vertex created by geometry stage while clipping a triangle.
+	* It lies in the plane of the original triangle, so its attributes are a weighted sum of the triangle vertices attributes
+	* @ingroup Rendering
+	*/
+	class clipped_vertex_info final
+	{
+	public:
+		/** Mesh vertices indices of the original triangle */
+		unsigned int indices[3];
+
+		/** Weights of the original triangle vertices, in clip space */
+		float weights[3];
+	};
+}
+
+#endif // LANTERN_CLIPPED_VERTEX_INFO_H
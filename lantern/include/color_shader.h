@@ -1,13 +1,13 @@
 #ifndef LANTERN_COLOR_SHADER_H
 #define LANTERN_COLOR_SHADER_H
 
-#include <vector>
 #include "shader_bind_point_info.h"
 #include "color.h"
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
 #include "matrix4x4.h"
+#include "state_version.h"
 #include "mesh_attribute_info.h"
 
 namespace lantern
@@ -18,25 +18,33 @@ namespace lantern
 	class color_shader final
 	{
 	public:
+		/** Constructs shader */
+		color_shader();
+
 		/** Gets info about color bind points required by shader
 		* @returns Required color bind points
 		*/
-		std::vector<shader_bind_point_info<color>> get_color_bind_points();
+		static shader_bind_points<color_shader, color> get_color_bind_points();
 
 		/** Gets info about float bind points required by shader
 		* @returns Required float bind points
 		*/
-		std::vector<shader_bind_point_info<float>> get_float_bind_points();
+		static shader_bind_points<color_shader, float> get_float_bind_points();
 
 		/** Gets info about vector2f bind points required by shader
 		* @returns Required vector2f bind points
 		*/
-		std::vector<shader_bind_point_info<vector2f>> get_vector2f_bind_points();
+		static shader_bind_points<color_shader, vector2f> get_vector2f_bind_points();
 
 		/** Gets info about vector3ff bind points required by shader
 		* @returns Required vector3f bind points
 		*/
-		std::vector<shader_bind_point_info<vector3f>> get_vector3f_bind_points();
+		static shader_bind_points<color_shader, vector3f> get_vector3f_bind_points();
+
+		/** Gets instance bind point, every instance gets its own model-view-projection matrix
+		* @returns Method setting model-view-projection matrix
+		*/
+		static shader_instance_bind_point<color_shader, matrix4x4f> get_instance_bind_point();
 
 		/** Processes vertex
 		* @param vertex Vertex in local space
@@ -44,6 +52,18 @@ namespace lantern
 		*/
 		vector4f process_vertex(vector4f const& vertex);
 
+		/** Processes vertices at once, giving the same results as process_vertex does
+		* @param input Vertices in local space
+		* @param output Storage for processed vertices in homogeneous clip space
+		* @param count Count of vertices
+		*/
+		void process_vertices(vector4f const* const input, vector4f* const output, size_t const count);
+
+		/** Gets version of the state vertex processing depends on, it changes every time the state does
+		* @returns State version
+		*/
+		uint64_t get_vertex_state_version() const;
+
 		/** Processes pixel
 		* @param pixel Pixel coordinates on screen
 		* @returns Final pixel color
@@ -59,13 +79,23 @@ namespace lantern
 		/** Movel-view-projection matrix */
 		matrix4x4f m_mvp;
 
+		/** Version of model-view-projection matrix */
+		uint64_t m_vertex_state_version;
+
 		/** Color bind point, contains interpolated color value */
 		color m_color;
 	};
 
+	inline color_shader::color_shader()
+		: m_vertex_state_version{get_next_state_version()}
+	{
+
+	}
+
 	inline void color_shader::set_mvp_matrix(matrix4x4f const& mvp)
 	{
 		m_mvp = mvp;
+		m_vertex_state_version = get_next_state_version();
 	}
 
 	inline vector4f color_shader::process_vertex(vector4f const& vertex)
@@ -73,31 +103,48 @@ namespace lantern
 		return vertex * m_mvp;
 	}
 
+	inline void color_shader::process_vertices(vector4f const* const input, vector4f* const output, size_t const count)
+	{
+		transform_vectors(input, output, count, m_mvp);
+	}
+
+	inline uint64_t color_shader::get_vertex_state_version() const
+	{
+		return m_vertex_state_version;
+	}
+
 	inline color color_shader::process_pixel(vector2ui const& pixel)
 	{
 		// Just return interpolated color value
 		return m_color;
 	}
 
-	inline std::vector<shader_bind_point_info<color>> color_shader::get_color_bind_points()
+	inline shader_bind_points<color_shader, color> color_shader::get_color_bind_points()
+	{
+		static shader_bind_point_info<color_shader, color> const bind_points[]{
+			shader_bind_point_info<color_shader, color>{COLOR_ATTR_ID, &color_shader::m_color}};
+
+		return shader_bind_points<color_shader, color>{bind_points};
+	}
+
+	inline shader_bind_points<color_shader, float> color_shader::get_float_bind_points()
 	{
-		return std::vector<shader_bind_point_info<color>>{
-			shader_bind_point_info<color> { COLOR_ATTR_ID, &m_color }};
+		return shader_bind_points<color_shader, float>{};
 	}
 
-	inline std::vector<shader_bind_point_info<float>> color_shader::get_float_bind_points()
+	inline shader_bind_points<color_shader, vector2f> color_shader::get_vector2f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<float>>{};
+		return shader_bind_points<color_shader, vector2f>{};
 	}
 
-	inline std::vector<shader_bind_point_info<vector2f>> color_shader::get_vector2f_bind_points()
+	inline shader_bind_points<color_shader, vector3f> color_shader::get_vector3f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector2f>>{};
+		return shader_bind_points<color_shader, vector3f>{};
 	}
 
-	inline std::vector<shader_bind_point_info<vector3f>> color_shader::get_vector3f_bind_points()
+	inline shader_instance_bind_point<color_shader, matrix4x4f> color_shader::get_instance_bind_point()
 	{
-		return std::vector<shader_bind_point_info<vector3f>>{};
+		return &color_shader::set_mvp_matrix;
 	}
 }
 
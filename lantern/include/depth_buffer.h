@@ -0,0 +1,73 @@
+#ifndef LANTERN_DEPTH_BUFFER_H
+#define LANTERN_DEPTH_BUFFER_H
+
+#include <vector>
+#include "vector2.h"
+
+namespace lantern
+{
+	/** Class representing depth render target: it holds one screen space depth value per pixel
+	* @ingroup Rendering
+	*/
+	class depth_buffer final
+	{
+	public:
+		/** Constructs depth buffer with given width and height, filled with the farthest depth value
+		* @param width Buffer's width
+		* @param height Buffer's height
+		*/
+		depth_buffer(unsigned int const width, unsigned int const height);
+
+		/** Gets buffer width
+		* @returns Buffer width
+		*/
+		unsigned int get_width() const;
+
+		/** Gets buffer height
+		* @returns Buffer height
+		*/
+		unsigned int get_height() const;
+
+		/** Gets depth value at specified position
+		* @param point Pixel coordinates to get depth at
+		* @returns Depth value
+		*/
+		float get_depth(vector2ui const& point) const;
+
+		/** Sets depth value at specified position
+		* @param point Pixel coordinates to set depth at
+		* @param depth Depth value to set
+		*/
+		void set_depth(vector2ui const& point, float const depth);
+
+		/** Fills buffer with specified depth value
+		* @param depth Depth value to fill buffer with
+		*/
+		void clear(float const depth);
+
+		/** Depth value of the far clipping plane in normalized device coordinates */
+		static float const FAR_DEPTH;
+
+	private:
+		/** Buffer width */
+		unsigned int m_width;
+
+		/** Buffer height */
+		unsigned int m_height;
+
+		/** Depth values, row by row */
+		std::vector<float> m_data;
+	};
+
+	inline float depth_buffer::get_depth(vector2ui const& point) const
+	{
+		return m_data[m_width * point.y + point.x];
+	}
+
+	inline void depth_buffer::set_depth(vector2ui const& point, float const depth)
+	{
+		m_data[m_width * point.y + point.x] = depth;
+	}
+}
+
+#endif // LANTERN_DEPTH_BUFFER_H
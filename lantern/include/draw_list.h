@@ -0,0 +1,200 @@
+#ifndef LANTERN_DRAW_LIST_H
+#define LANTERN_DRAW_LIST_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "renderer.h"
+#include "state_version.h"
+
+namespace lantern
+{
+	/** Settings draw is executed with, they define its place in sorted draw list
+	* @ingroup Rendering
+	*/
+	class draw_settings final
+	{
+	public:
+		/** Texture to render image into */
+		texture* target_texture;
+
+		/** Depth buffer to test samples against, nullptr = samples are not tested */
+		depth_buffer* target_depth_buffer;
+
+		/** If alpha blending is enabled during draw */
+		bool alpha_blending_enabled;
+
+		/** Layer of draw, draws of lower layers are executed first, e.g. scene goes before UI */
+		unsigned int layer;
+
+		/** Distance from camera to the object, used to sort draws inside layer */
+		float depth;
+	};
+
+	/** List of draws recorded to be executed later in sorted order.
+	* Draws are grouped by target texture and layer, then depth tested opaque draws go front-to-back,
+	* so that farther objects are rejected by depth test instead of being shaded and overwritten,
+	* and the rest of draws go back-to-front, as blending and drawing without depth test require.
+	* Opaque draws with close depths are grouped by shader type to reduce state switching.
+	* Draws with equal sort keys are executed in order of recording
+	* @ingroup Rendering
+	*/
+	class draw_list final
+	{
+	public:
+		/** Records draw of a mesh. Shader is copied, mesh and settings targets must stay alive until the list is executed
+		* @param mesh Mesh to render
+		* @param shader Shader to use for rendering
+		* @param settings Draw settings
+		*/
+		template<typename TShader>
+		void add_mesh(mesh const& mesh, TShader const& shader, draw_settings const& settings);
+
+		/** Records draw of a part of mesh. Shader is copied, mesh and settings targets must stay alive until the list is executed
+		* @param mesh Mesh to render
+		* @param part Submesh of the mesh to render
+		* @param shader Shader to use for rendering
+		* @param settings Draw settings
+		*/
+		template<typename TShader>
+		void add_mesh(mesh const& mesh, submesh const& part, TShader const& shader, draw_settings const& settings);
+
+		/** Sorts recorded draws, executes them and clears the list.
+		* Alpha blending mode of merging stage is changed only between draws that need different ones, and restored afterwards
+		* @param pipeline Renderer to execute draws with
+		*/
+		void execute(renderer& pipeline);
+
+		/** Drops recorded draws */
+		void clear();
+
+		/** Gets count of recorded draws
+		* @returns Draws count
+		*/
+		size_t size() const;
+
+		/** Calculates sort key of draw
+		* @param target_rank Index of target texture among targets of the list
+		* @param settings Draw settings
+		* @param shader_type_rank Index of shader type among shader types of the list
+		* @returns Key, draws with smaller keys are executed first
+		*/
+		static uint64_t get_sort_key(unsigned int const target_rank, draw_settings const& settings, unsigned int const shader_type_rank);
+
+	private:
+		/** Recorded draw */
+		class draw_command final
+		{
+		public:
+			/** Sort key */
+			uint64_t sort_key;
+
+			/** If alpha blending is enabled during draw */
+			bool alpha_blending_enabled;
+
+			/** Renders recorded draw */
+			std::function<void(renderer&)> draw;
+		};
+
+		/** Gets index of a value among already seen ones, adding it if it's new
+		* @param values Seen values
+		* @param value Value to find
+		* @returns Value index
+		*/
+		template<typename T>
+		static unsigned int get_rank(std::vector<T>& values, T const value);
+
+		/** Adds draw to the list
+		* @param settings Draw settings
+		* @param shader_type_version Version identifying shader type
+		* @param draw Function rendering the draw
+		*/
+		void add_command(draw_settings const& settings, uint64_t const shader_type_version, std::function<void(renderer&)> draw);
+
+		/** Gets version identifying shader type
+		* @returns Version generated once for every type
+		*/
+		template<typename TShader>
+		static uint64_t get_shader_type_version();
+
+		/** Recorded draws */
+		std::vector<draw_command> m_commands;
+
+		/** Target textures of recorded draws, in order of their first appearance */
+		std::vector<texture const*> m_targets;
+
+		/** Shader types of recorded draws, in order of their first appearance */
+		std::vector<uint64_t> m_shader_types;
+	};
+
+	template<typename TShader>
+	inline void draw_list::add_mesh(mesh const& mesh, TShader const& shader, draw_settings const& settings)
+	{
+		lantern::mesh const* const mesh_pointer{&mesh};
+		TShader shader_copy(shader);
+
+		add_command(
+			settings,
+			get_shader_type_version<TShader>(),
+			[mesh_pointer, shader_copy, settings](renderer& pipeline) mutable
+			{
+				if (settings.target_depth_buffer != nullptr)
+				{
+					pipeline.render_mesh(*mesh_pointer, shader_copy, *settings.target_texture, *settings.target_depth_buffer);
+				}
+				else
+				{
+					pipeline.render_mesh(*mesh_pointer, shader_copy, *settings.target_texture);
+				}
+			});
+	}
+
+	template<typename TShader>
+	inline void draw_list::add_mesh(mesh const& mesh, submesh const& part, TShader const& shader, draw_settings const& settings)
+	{
+		lantern::mesh const* const mesh_pointer{&mesh};
+		submesh const part_copy(part);
+		TShader shader_copy(shader);
+
+		add_command(
+			settings,
+			get_shader_type_version<TShader>(),
+			[mesh_pointer, part_copy, shader_copy, settings](renderer& pipeline) mutable
+			{
+				if (settings.target_depth_buffer != nullptr)
+				{
+					pipeline.render_mesh(*mesh_pointer, part_copy, shader_copy, *settings.target_texture, *settings.target_depth_buffer);
+				}
+				else
+				{
+					pipeline.render_mesh(*mesh_pointer, part_copy, shader_copy, *settings.target_texture);
+				}
+			});
+	}
+
+	template<typename T>
+	inline unsigned int draw_list::get_rank(std::vector<T>& values, T const value)
+	{
+		for (size_t i{0}; i < values.size(); ++i)
+		{
+			if (values[i] == value)
+			{
+				return static_cast<unsigned int>(i);
+			}
+		}
+
+		values.push_back(value);
+
+		return static_cast<unsigned int>(values.size() - 1);
+	}
+
+	template<typename TShader>
+	inline uint64_t draw_list::get_shader_type_version()
+	{
+		static uint64_t const version{get_next_state_version()};
+
+		return version;
+	}
+}
+
+#endif // LANTERN_DRAW_LIST_H
@@ -0,0 +1,83 @@
+#ifndef LANTERN_FIXED_POINT_EDGE_H
+#define LANTERN_FIXED_POINT_EDGE_H
+
+#include <cstdint>
+
+namespace lantern
+{
+	/** Triangle edge function evaluated in sub-pixel fixed point coordinates.
+	* Vertices are snapped to 1/SUBPIXEL_STEPS of a pixel, so edges shared by adjacent triangles produce exactly opposite values
+	* and every pixel center is covered by one triangle only. Top-left filling rule is baked into the value as a bias,
+	* thus pixel center is covered if value is not negative
+	*/
+	class fixed_point_edge final
+	{
+	public:
+		/** Count of sub-pixel precision bits */
+		static int const SUBPIXEL_BITS = 4;
+
+		/** Count of sub-pixel steps in one pixel */
+		static int const SUBPIXEL_STEPS = 1 << SUBPIXEL_BITS;
+
+		/** Constructs edge going from the first point to the second one, positive halfplane is on the left in screen space
+		* @param x0 First point x-coordinate in fixed point
+		* @param y0 First point y-coordinate in fixed point
+		* @param x1 Second point x-coordinate in fixed point
+		* @param y1 Second point y-coordinate in fixed point
+		*/
+		fixed_point_edge(int64_t const x0, int64_t const y0, int64_t const x1, int64_t const y1);
+
+		/** Converts coordinate to fixed point, rounding it to the nearest sub-pixel
+		* @param value Coordinate in pixels
+		* @returns Fixed point coordinate
+		*/
+		static int64_t snap(float const value);
+
+		/** Calculates biased edge function value at pixel center
+		* @param x Pixel x-coordinate
+		* @param y Pixel y-coordinate
+		* @returns Edge function value, not negative if pixel center is covered
+		*/
+		int64_t at_pixel_center(int64_t const x, int64_t const y) const;
+
+		/** Removes top-left bias from edge function value, result is twice the area of a triangle made of the edge and the point
+		* @param value Biased value
+		* @returns Unbiased value
+		*/
+		int64_t unbiased(int64_t const value) const;
+
+		/** Value change on moving one pixel right */
+		int64_t step_x;
+
+		/** Value change on moving one pixel down */
+		int64_t step_y;
+
+	private:
+		/** X coefficient */
+		int64_t m_a;
+
+		/** Y coefficient */
+		int64_t m_b;
+
+		/** Free coefficient */
+		int64_t m_c;
+
+		/** Zero for top and left edges, minus one for the others */
+		int64_t m_bias;
+	};
+
+	inline int64_t fixed_point_edge::at_pixel_center(int64_t const x, int64_t const y) const
+	{
+		int64_t const center_x{x * SUBPIXEL_STEPS + SUBPIXEL_STEPS / 2};
+		int64_t const center_y{y * SUBPIXEL_STEPS + SUBPIXEL_STEPS / 2};
+
+		return m_a * center_x + m_b * center_y + m_c + m_bias;
+	}
+
+	inline int64_t fixed_point_edge::unbiased(int64_t const value) const
+	{
+		return value - m_bias;
+	}
+}
+
+#endif // LANTERN_FIXED_POINT_EDGE_H
@@ -1,13 +1,73 @@
 #ifndef LANTERN_GEOMETRY_STAGE_H
 #define LANTERN_GEOMETRY_STAGE_H
 
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include "aabb.h"
 #include "mesh.h"
 #include "texture.h"
 #include "matrix4x4.h"
+#include "clipped_vertex_info.h"
 
 namespace lantern
 {
-	/** This rendering stage is responsible for transforming geometry and invoking a vertex shader
+	/** Specifies which triangles are culled depending on their facing
+	* @ingroup Rendering
+	*/
+	enum class face_culling_option
+	{
+		/** Triangles are not culled */
+		none,
+
+		/** Back-facing triangles are culled */
+		back,
+
+		/** Front-facing triangles are culled */
+		front
+	};
+
+	/** Specifies vertices order of front-facing triangles in normalized device coordinates
+	* @ingroup Rendering
+	*/
+	enum class winding_order_option
+	{
+		/** Vertices of front-facing triangles go counterclockwise */
+		counterclockwise,
+
+		/** Vertices of front-facing triangles go clockwise */
+		clockwise
+	};
+
+	/** Counters of triangles processed by geometry stage, accumulated until reset
+	* @ingroup Rendering
+	*/
+	class geometry_stage_counters final
+	{
+	public:
+		/** Triangles having all the vertices inside the frustum, passed on without clipping */
+		unsigned int trivially_accepted_triangles_count;
+
+		/** Triangles having all the vertices outside of the same frustum plane, rejected without clipping */
+		unsigned int trivially_rejected_triangles_count;
+
+		/** Triangles crossing frustum planes, which had to be clipped */
+		unsigned int clipped_triangles_count;
+
+		/** Triangles culled because of their facing */
+		unsigned int culled_by_facing_triangles_count;
+
+		/** Triangles culled because they have zero area in screen space */
+		unsigned int culled_degenerate_triangles_count;
+
+		/** Triangles culled because there are no pixel centers inside their bounding box */
+		unsigned int culled_without_pixel_centers_triangles_count;
+
+		/** Triangles passed to the next stage */
+		unsigned int passed_triangles_count;
+	};
+
+	/** This rendering stage is responsible for transforming geometry, invoking a vertex shader and clipping triangles
 	* @ingroup Rendering
 	*/
 	class geometry_stage final
@@ -16,157 +76,680 @@ namespace lantern
 		/** Constructs geometry stage with default settings */
 		geometry_stage();
 
-		/** Invokes stage
+		/** Invokes stage.
+		* If shader has process_vertices(vector4f const* input, vector4f* output, size_t count) method,
+		* vertices are passed to it by batches instead of calling process_vertex for every one of them.
+		* If shader has uint64_t get_vertex_state_version() const method and transformed vertices cache is enabled,
+		* vertices are not processed again while mesh version, indices range, shader vertex state version and target size stay the same
 		* @param mesh Mesh to process
+		* @param index_offset Index of the first mesh index to process
+		* @param index_count Count of indices to process, only vertices they reference are transformed
 		* @param shader Shader to use for vertex processing
+		* @param do_homogeneous_division False = pass vertices in screen space without dividing them by w
 		* @param target_texture Texture mesh will be rendered to
 		* @param delegate Object to pass results to for futher processing
 		*/
 		template<typename TShader, typename TDelegate>
 		void invoke(
 			mesh const& mesh,
+			size_t const index_offset,
+			size_t const index_count,
 			TShader& shader,
 			bool const do_homogeneous_division,
 			texture& target_texture,
 			TDelegate& delegate);
 
+		/** Invokes stage for every instance of mesh. Referenced vertices are collected once, then for every instance
+		* shader gets instance data through the method returned by its static get_instance_bind_point(), and vertices are processed again.
+		* Clipped vertices of all the instances are kept until the next invocation. Transformed vertices cache is not used
+		* @param mesh Mesh to process
+		* @param index_offset Index of the first mesh index to process
+		* @param index_count Count of indices to process, only vertices they reference are transformed
+		* @param shader Shader to use for vertex processing
+		* @param instances Data of every instance, e.g. its transformation matrix
+		* @param do_homogeneous_division False = pass vertices in screen space without dividing them by w
+		* @param target_texture Texture mesh will be rendered to
+		* @param delegate Object to pass results to for futher processing
+		*/
+		template<typename TShader, typename TInstance, typename TDelegate>
+		void invoke_instanced(
+			mesh const& mesh,
+			size_t const index_offset,
+			size_t const index_count,
+			TShader& shader,
+			std::vector<TInstance> const& instances,
+			bool const do_homogeneous_division,
+			texture& target_texture,
+			TDelegate& delegate);
+
+		/** Sets face culling mode
+		* @param option Culling mode
+		*/
+		void set_face_culling(face_culling_option const option);
+
+		/** Gets face culling mode
+		* @returns Culling mode
+		*/
+		face_culling_option get_face_culling() const;
+
+		/** Sets vertices order of front-facing triangles
+		* @param option Winding order
+		*/
+		void set_front_face_winding_order(winding_order_option const option);
+
+		/** Gets vertices order of front-facing triangles
+		* @returns Winding order
+		*/
+		winding_order_option get_front_face_winding_order() const;
+
+		/** Gets triangles counters
+		* @returns Counters accumulated since the last reset
+		*/
+		geometry_stage_counters const& get_counters() const;
+
+		/** Sets all the triangles counters to zero */
+		void reset_counters();
+
+		/** Sets max count of indices ranges transformed vertices are kept for, the least recently used ones are dropped first.
+		* Useful for static geometry rendered every frame with the same settings. Zero disables caching, which is the default
+		* @param size Max count of cached ranges
+		*/
+		void set_transformed_vertices_cache_size(size_t const size);
+
+		/** Gets max count of indices ranges transformed vertices are kept for
+		* @returns Max count of cached ranges, zero if caching is disabled
+		*/
+		size_t get_transformed_vertices_cache_size() const;
+
+		/** Drops all the cached transformed vertices */
+		void invalidate_transformed_vertices_cache();
+
+		/** Drops cached transformed vertices of mesh. Calling mesh::mark_changed is enough to stop using them,
+		* this method also frees memory they take
+		* @param m Mesh to drop vertices of
+		*/
+		void invalidate_transformed_vertices_cache(mesh const& m);
+
+		/** Checks if box is entirely outside of the view frustum, i.e. all its corners are outside of one of the frustum planes
+		* @param box Box in model space
+		* @param mvp_matrix Matrix transforming model space to clip space
+		* @returns True if nothing inside the box can be visible
+		*/
+		static bool is_box_outside_frustum(aabb<vector3f> const& box, matrix4x4f const& mvp_matrix);
+
+		/** Gets vertices created by clipping during the last invocation.
+		* Triangles passed to the delegate refer to them using indices with CLIPPED_VERTEX_INDEX_FLAG set
+		* @returns Clipped vertices
+		*/
+		std::vector<clipped_vertex_info> const& get_clipped_vertices() const;
+
 	private:
-		/** Storage for transformed vertices */
-		std::vector<vector4f> m_transformed_vertices_storage;
+		/** Vertices of mesh indices range processed by shader, along with the state they depend on */
+		class transformed_vertices_info final
+		{
+		public:
+			/** Mesh content version */
+			uint64_t mesh_version;
+
+			/** Shader vertex state version, zero if vertices are not valid */
+			uint64_t shader_state_version;
+
+			/** Index of the first processed mesh index */
+			size_t index_offset;
+
+			/** Count of processed indices */
+			size_t index_count;
+
+			/** Target texture width */
+			unsigned int width;
+
+			/** Target texture height */
+			unsigned int height;
+
+			/** False = vertices were transformed to screen space without dividing them by w */
+			bool do_homogeneous_division;
+
+			/** Number of the last invocation vertices were used in */
+			unsigned int last_use_invocation_number;
+
+			/** Vertices in clip space, indexed by mesh vertices indices */
+			std::vector<vector4f> clip_space_vertices;
+
+			/** Vertices in screen space, vertices outside of the frustum are left in clip space */
+			std::vector<vector4f> screen_space_vertices;
+
+			/** Outcodes of vertices, six bits of every one are used */
+			std::vector<unsigned char> outcodes;
+		};
 
-		/* Storage for clip flags */
-		std::vector<bool> m_transformed_vertices_clip_flags_storage;
+		/** Vertex of a polygon being clipped */
+		class polygon_vertex final
+		{
+		public:
+			/** Position in clip space */
+			vector4f position;
+
+			/** Weights of the original triangle vertices */
+			float weights[3];
+
+			/** Index of mesh vertex, or NOT_MESH_VERTEX_INDEX if vertex was created by clipping */
+			unsigned int index;
+		};
+
+		/** Marks polygon vertex that is not a mesh vertex */
+		static unsigned int const NOT_MESH_VERTEX_INDEX = 0xFFFFFFFF;
+
+		/** Max count of vertices triangle can have after it's clipped by six planes */
+		static unsigned int const MAX_CLIPPED_POLYGON_SIZE = 9;
+
+		/** Count of vertices processed at once, small enough for a batch to stay in cache */
+		static size_t const VERTICES_BATCH_SIZE = 256;
+
+		/** Processes batch of vertices using shader batch method
+		* @param shader Shader having process_vertices method
+		* @param input Vertices in local space
+		* @param output Storage for processed vertices
+		* @param count Count of vertices
+		*/
+		template<typename TShader>
+		static auto process_vertices(TShader& shader, vector4f const* const input, vector4f* const output, size_t const count, int)
+			-> decltype(shader.process_vertices(input, output, count), void());
+
+		/** Processes batch of vertices one by one, used if shader has no batch method
+		* @param shader Shader
+		* @param input Vertices in local space
+		* @param output Storage for processed vertices
+		* @param count Count of vertices
+		*/
+		template<typename TShader>
+		static void process_vertices(TShader& shader, vector4f const* const input, vector4f* const output, size_t const count, long);
+
+		/** Gets version of shader vertex state
+		* @param shader Shader having get_vertex_state_version method
+		* @returns State version
+		*/
+		template<typename TShader>
+		static auto get_vertex_state_version(TShader const& shader, int) -> decltype(shader.get_vertex_state_version());
+
+		/** Used if shader doesn't report its vertex state version, so that its vertices are never cached
+		* @param shader Shader
+		* @returns Zero
+		*/
+		template<typename TShader>
+		static uint64_t get_vertex_state_version(TShader const& shader, long);
+
+		/** Checks indices range and prepares per-invocation state
+		* @param mesh Mesh to process
+		* @param index_offset Index of the first mesh index to process
+		* @param index_count Count of indices to process
+		*/
+		void start_invocation(mesh const& mesh, size_t const index_offset, size_t const index_count);
+
+		/** Collects vertices referenced by triangles of indices range, each of them once
+		* @param mesh Mesh to process
+		* @param index_offset Index of the first mesh index to process
+		* @param index_count Count of indices to process
+		*/
+		void collect_referenced_vertices(mesh const& mesh, size_t const index_offset, size_t const index_count);
+
+		/** Processes collected referenced vertices by batches and calculates their outcodes.
+		* Vertices inside the frustum are transformed to screen coordinates, vertices outside of it are used only through clipping
+		* @param mesh Mesh to process
+		* @param shader Shader to use for vertex processing
+		* @param do_homogeneous_division False = transform vertices without dividing them by w
+		* @param target_texture Texture mesh will be rendered to
+		* @param transformed Storage for transformed vertices
+		*/
+		template<typename TShader>
+		void transform_vertices(
+			mesh const& mesh,
+			TShader& shader,
+			bool const do_homogeneous_division,
+			texture const& target_texture,
+			transformed_vertices_info& transformed);
+
+		/** Rejects, clips and culls triangles of indices range, passing the rest to delegate
+		* @param mesh Mesh to process
+		* @param index_offset Index of the first mesh index to process
+		* @param index_count Count of indices to process
+		* @param transformed Transformed vertices of the range
+		* @param shader Shader to pass to delegate
+		* @param do_homogeneous_division False = vertices were transformed without dividing them by w
+		* @param target_texture Texture mesh will be rendered to
+		* @param delegate Object to pass results to for futher processing
+		*/
+		template<typename TShader, typename TDelegate>
+		void process_triangles(
+			mesh const& mesh,
+			size_t const index_offset,
+			size_t const index_count,
+			transformed_vertices_info const& transformed,
+			TShader& shader,
+			bool const do_homogeneous_division,
+			texture& target_texture,
+			TDelegate& delegate);
+
+		/** Finds cached vertices transformed with the same state or picks storage to transform them into
+		* @param mesh_version Mesh content version
+		* @param shader_state_version Shader vertex state version, zero if vertices shouldn't be cached
+		* @param index_offset Index of the first processed mesh index
+		* @param index_count Count of processed indices
+		* @param width Target texture width
+		* @param height Target texture height
+		* @param do_homogeneous_division False = vertices are transformed without dividing them by w
+		* @returns Storage, its shader state version is zero if vertices should be transformed
+		*/
+		transformed_vertices_info& get_transformed_vertices(
+			uint64_t const mesh_version,
+			uint64_t const shader_state_version,
+			size_t const index_offset,
+			size_t const index_count,
+			unsigned int const width,
+			unsigned int const height,
+			bool const do_homogeneous_division);
+
+		/** Calculates bit mask of frustum planes vertex is outside of
+		* @param v Vertex in clip space
+		* @returns Outcode, zero if vertex is inside the frustum
+		*/
+		static unsigned int get_outcode(vector4f const& v);
+
+		/** Calculates signed distance-like value from vertex to a frustum plane, it is negative if vertex is outside
+		* @param v Vertex in clip space
+		* @param plane_index Plane index, the same as its bit index in outcode
+		* @returns Value that is linear along any segment in clip space
+		*/
+		static float get_plane_distance(vector4f const& v, unsigned int const plane_index);
+
+		/** Transforms vertex from clip space to the space rasterizer works in
+		* @param v Vertex in clip space
+		* @param do_homogeneous_division False = transform vertex without dividing it by w
+		* @param width Target texture width
+		* @param height Target texture height
+		* @returns Transformed vertex
+		*/
+		static vector4f transform_to_screen(vector4f const& v, bool const do_homogeneous_division, float const width, float const height);
+
+		/** Checks if triangle should be culled, updating counters
+		* @param vertex0 First vertex, transformed to screen space
+		* @param vertex1 Second vertex, transformed to screen space
+		* @param vertex2 Third vertex, transformed to screen space
+		* @param do_homogeneous_division False = vertices were transformed without dividing them by w
+		* @returns True if triangle should not be rasterized
+		*/
+		bool is_triangle_culled(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			bool const do_homogeneous_division);
+
+		/** Clips triangle by frustum planes using Sutherland-Hodgman algorithm
+		* @param index0 First vertex index
+		* @param index1 Second vertex index
+		* @param index2 Third vertex index
+		* @param planes_mask Planes to clip by, in outcode format
+		* @param result Clipped polygon storage, should be able to hold MAX_CLIPPED_POLYGON_SIZE vertices
+		* @returns Count of vertices in clipped polygon
+		*/
+		unsigned int clip_triangle(
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			unsigned int const planes_mask,
+			polygon_vertex* result) const;
+
+		/** Storage for transformed vertices that are not cached */
+		transformed_vertices_info m_uncached_transformed_vertices;
+
+		/** Cached transformed vertices */
+		std::vector<transformed_vertices_info> m_transformed_vertices_cache;
+
+		/** Max count of cached transformed vertices storages */
+		size_t m_transformed_vertices_cache_size;
+
+		/** Transformed vertices used by current invocation */
+		transformed_vertices_info const* m_current_transformed_vertices;
+
+		/** Batch of vertices passed to shader */
+		std::vector<vector4f> m_vertices_batch_input;
+
+		/** Batch of vertices processed by shader */
+		std::vector<vector4f> m_vertices_batch_output;
+
+		/** Vertices created by clipping */
+		std::vector<clipped_vertex_info> m_clipped_vertices;
+
+		/** Face culling mode */
+		face_culling_option m_face_culling;
+
+		/** Vertices order of front-facing triangles */
+		winding_order_option m_front_face_winding_order;
+
+		/** Triangles counters */
+		geometry_stage_counters m_counters;
+
+		/** Indices of vertices referenced by triangles of the mesh being processed */
+		std::vector<unsigned int> m_referenced_vertices_storage;
+
+		/** Number of the last invocation every vertex was referenced in */
+		std::vector<unsigned int> m_vertices_marks;
+
+		/** Number of current invocation */
+		unsigned int m_invocation_number;
 	};
 
+	inline bool geometry_stage::is_box_outside_frustum(aabb<vector3f> const& box, matrix4x4f const& mvp_matrix)
+	{
+		unsigned int common_outcode{0x3F};
+
+		for (unsigned int i{0}; (i < 8) && (common_outcode != 0); ++i)
+		{
+			vector4f const corner{
+				(i & 1) ? box.to.x : box.from.x,
+				(i & 2) ? box.to.y : box.from.y,
+				(i & 4) ? box.to.z : box.from.z,
+				1.0f};
+
+			common_outcode &= get_outcode(corner * mvp_matrix);
+		}
+
+		return common_outcode != 0;
+	}
+
+	inline unsigned int geometry_stage::get_outcode(vector4f const& v)
+	{
+		unsigned int outcode{0};
+
+		if (v.x < -v.w) outcode |= 1 << 0;
+		if (v.x > v.w) outcode |= 1 << 1;
+		if (v.y < -v.w) outcode |= 1 << 2;
+		if (v.y > v.w) outcode |= 1 << 3;
+		if (v.z < -v.w) outcode |= 1 << 4;
+		if (v.z > v.w) outcode |= 1 << 5;
+
+		return outcode;
+	}
+
+	inline float geometry_stage::get_plane_distance(vector4f const& v, unsigned int const plane_index)
+	{
+		switch (plane_index)
+		{
+			case 0: return v.w + v.x;
+			case 1: return v.w - v.x;
+			case 2: return v.w + v.y;
+			case 3: return v.w - v.y;
+			case 4: return v.w + v.z;
+			default: return v.w - v.z;
+		}
+	}
+
+	inline vector4f geometry_stage::transform_to_screen(vector4f const& v, bool const do_homogeneous_division, float const width, float const height)
+	{
+		if (do_homogeneous_division)
+		{
+			matrix4x4f const ndc_to_screen{
+				(width) / 2.0f, 0.0f, 0.0f, 0.0f,
+				0.0f, -(height) / 2.0f, 0.0f, 0.0f,
+				0.0f, 0.0f, 1.0f, 0.0f,
+				(width) / 2.0f, (height) / 2.0f, 0.0f, 1.0f};
+
+			return v * ndc_to_screen;
+		}
+
+		float const w_inversed{1.0f / v.w};
+
+		vector4f result{v.x * w_inversed, v.y * w_inversed, v.z * w_inversed, w_inversed};
+
+		// NDC to screen
+		//
+		result.x = result.x * width / 2.0f + width / 2.0f;
+		result.y = -result.y * height / 2.0f + height / 2.0f;
+
+		return result;
+	}
+
+	template<typename TShader>
+	inline auto geometry_stage::process_vertices(TShader& shader, vector4f const* const input, vector4f* const output, size_t const count, int)
+		-> decltype(shader.process_vertices(input, output, count), void())
+	{
+		shader.process_vertices(input, output, count);
+	}
+
+	template<typename TShader>
+	inline void geometry_stage::process_vertices(TShader& shader, vector4f const* const input, vector4f* const output, size_t const count, long)
+	{
+		for (size_t i{0}; i < count; ++i)
+		{
+			output[i] = shader.process_vertex(input[i]);
+		}
+	}
+
+	template<typename TShader>
+	inline auto geometry_stage::get_vertex_state_version(TShader const& shader, int) -> decltype(shader.get_vertex_state_version())
+	{
+		return shader.get_vertex_state_version();
+	}
+
+	template<typename TShader>
+	inline uint64_t geometry_stage::get_vertex_state_version(TShader const& shader, long)
+	{
+		return 0;
+	}
+
 	template<typename TShader, typename TDelegate>
 	void geometry_stage::invoke(
 		mesh const& mesh,
+		size_t const index_offset,
+		size_t const index_count,
 		TShader& shader,
 		bool const do_homogeneous_division,
 		texture& target_texture,
 		TDelegate& delegate)
 	{
-		// Change transformed vertices storages capacity if needed and clear it
-		//
+		start_invocation(mesh, index_offset, index_count);
 
-		std::vector<vector3f> const& vertices = mesh.get_vertices();
-		size_t vertices_count{vertices.size()};
+		uint64_t const shader_state_version{get_vertex_state_version(shader, 0)};
+		transformed_vertices_info& transformed = get_transformed_vertices(
+			mesh.get_version(),
+			shader_state_version,
+			index_offset,
+			index_count,
+			target_texture.get_width(),
+			target_texture.get_height(),
+			do_homogeneous_division);
 
-		if (m_transformed_vertices_storage.capacity() < vertices_count)
+		if (transformed.shader_state_version == 0)
 		{
-			m_transformed_vertices_storage.reserve(vertices_count);
-		}
-		m_transformed_vertices_storage.clear();
+			collect_referenced_vertices(mesh, index_offset, index_count);
+			transform_vertices(mesh, shader, do_homogeneous_division, target_texture, transformed);
 
-		if (m_transformed_vertices_clip_flags_storage.capacity() < vertices_count)
-		{
-			m_transformed_vertices_clip_flags_storage.reserve(vertices_count);
+			// Vertices become valid only when all of them are processed
+			//
+			transformed.shader_state_version = shader_state_version;
 		}
-		m_transformed_vertices_clip_flags_storage.clear();
 
-		// Process vertices and clip
-		//
-		for (size_t i{0}; i < vertices_count; ++i)
-		{
-			vector3f const& v{vertices.at(i)};
-			vector4f v_transformed{shader.process_vertex(vector4f{v.x, v.y, v.z, 1.0f})};
+		process_triangles(mesh, index_offset, index_count, transformed, shader, do_homogeneous_division, target_texture, delegate);
+	}
 
-			bool clipped{false};
-			if ((v_transformed.x > v_transformed.w) || (v_transformed.x < -v_transformed.w))
-			{
-				clipped = true;
-			}
-			else if ((v_transformed.y > v_transformed.w) || (v_transformed.y < -v_transformed.w))
-			{
-				clipped = true;
-			}
-			else if ((v_transformed.z > v_transformed.w) || (v_transformed.z < -v_transformed.w))
-			{
-				clipped = true;
-			}
+	template<typename TShader, typename TInstance, typename TDelegate>
+	void geometry_stage::invoke_instanced(
+		mesh const& mesh,
+		size_t const index_offset,
+		size_t const index_count,
+		TShader& shader,
+		std::vector<TInstance> const& instances,
+		bool const do_homogeneous_division,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		start_invocation(mesh, index_offset, index_count);
+		collect_referenced_vertices(mesh, index_offset, index_count);
 
-			m_transformed_vertices_storage.push_back(v_transformed);
-			m_transformed_vertices_clip_flags_storage.push_back(clipped);
+		auto const instance_bind_point = TShader::get_instance_bind_point();
+
+		for (TInstance const& instance : instances)
+		{
+			(shader.*instance_bind_point)(instance);
+
+			transform_vertices(mesh, shader, do_homogeneous_division, target_texture, m_uncached_transformed_vertices);
+			process_triangles(mesh, index_offset, index_count, m_uncached_transformed_vertices, shader, do_homogeneous_division, target_texture, delegate);
 		}
+	}
 
-		// Transform vertices to screen coordinates
-		//
+	template<typename TShader>
+	void geometry_stage::transform_vertices(
+		mesh const& mesh,
+		TShader& shader,
+		bool const do_homogeneous_division,
+		texture const& target_texture,
+		transformed_vertices_info& transformed)
+	{
+		std::vector<vector3f> const& vertices = mesh.get_vertices();
+		size_t const vertices_count{vertices.size()};
 
 		float const width{static_cast<float>(target_texture.get_width())};
 		float const height{static_cast<float>(target_texture.get_height())};
 
-		if (do_homogeneous_division)
+		// Storages are indexed by mesh vertices indices, only vertices referenced by triangles get their values
+		//
+
+		transformed.clip_space_vertices.resize(vertices_count);
+		transformed.screen_space_vertices.resize(vertices_count);
+		transformed.outcodes.resize(vertices_count);
+
+		m_vertices_batch_input.resize(VERTICES_BATCH_SIZE);
+		m_vertices_batch_output.resize(VERTICES_BATCH_SIZE);
+
+		size_t const referenced_vertices_count{m_referenced_vertices_storage.size()};
+		for (size_t batch_start{0}; batch_start < referenced_vertices_count; batch_start += VERTICES_BATCH_SIZE)
 		{
-			matrix4x4f const ndc_to_screen{
-				(width) / 2.0f, 0.0f, 0.0f, 0.0f,
-				0.0f, -(height) / 2.0f, 0.0f, 0.0f,
-				0.0f, 0.0f, 1.0f, 0.0f,
-				(width) / 2.0f, (height) / 2.0f, 0.0f, 1.0f};
+			size_t const batch_size{std::min(static_cast<size_t>(VERTICES_BATCH_SIZE), referenced_vertices_count - batch_start)};
+			unsigned int const* const batch_indices{m_referenced_vertices_storage.data() + batch_start};
 
-			for (size_t i{0}; i < vertices_count; ++i)
+			for (size_t i{0}; i < batch_size; ++i)
 			{
-				vector4f& v = m_transformed_vertices_storage.at(i);
-				v = v * ndc_to_screen;
+				vector3f const& v = vertices[batch_indices[i]];
+				m_vertices_batch_input[i] = vector4f{v.x, v.y, v.z, 1.0f};
 			}
-		}
-		else
-		{
-			for (size_t i{0}; i < vertices_count; ++i)
+
+			process_vertices(shader, m_vertices_batch_input.data(), m_vertices_batch_output.data(), batch_size, 0);
+
+			for (size_t i{0}; i < batch_size; ++i)
 			{
-				if (m_transformed_vertices_clip_flags_storage.at(i) == true)
-				{
-					continue;
-				}
+				unsigned int const index{batch_indices[i]};
+				vector4f const& v_transformed = m_vertices_batch_output[i];
+				unsigned int const outcode{get_outcode(v_transformed)};
 
-				vector4f& v = m_transformed_vertices_storage.at(i);
+				transformed.clip_space_vertices[index] = v_transformed;
+				transformed.outcodes[index] = static_cast<unsigned char>(outcode);
+				transformed.screen_space_vertices[index] = (outcode == 0) ? transform_to_screen(v_transformed, do_homogeneous_division, width, height) : v_transformed;
+			}
+		}
+	}
 
-				float const w_inversed{1.0f / v.w};
+	template<typename TShader, typename TDelegate>
+	void geometry_stage::process_triangles(
+		mesh const& mesh,
+		size_t const index_offset,
+		size_t const index_count,
+		transformed_vertices_info const& transformed,
+		TShader& shader,
+		bool const do_homogeneous_division,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		std::vector<unsigned int> const& indices = mesh.get_indices();
+		size_t const indices_end{index_offset + index_count};
 
-				v.x *= w_inversed;
-				v.y *= w_inversed;
-				v.z *= w_inversed;
+		float const width{static_cast<float>(target_texture.get_width())};
+		float const height{static_cast<float>(target_texture.get_height())};
 
-				v.w = w_inversed;
+		std::vector<vector4f> const& screen_space_vertices = transformed.screen_space_vertices;
+		std::vector<unsigned char> const& outcodes = transformed.outcodes;
 
-				// NDC to screen
-				//
-				v.x = v.x * width / 2.0f + width / 2.0f;
-				v.y = -v.y * height / 2.0f + height / 2.0f;
-			}
-		}
+		m_current_transformed_vertices = &transformed;
 
 		// Process results
 		//
-		std::vector<unsigned int> const& indices = mesh.get_indices();
+		polygon_vertex clipped_polygon[MAX_CLIPPED_POLYGON_SIZE];
+		vector4f clipped_polygon_transformed[MAX_CLIPPED_POLYGON_SIZE];
+		unsigned int clipped_polygon_indices[MAX_CLIPPED_POLYGON_SIZE];
 
-		size_t indices_count{indices.size()};
-		for (size_t i{0}; i < indices_count; i += 3)
+		for (size_t i{index_offset}; i + 2 < indices_end; i += 3)
 		{
 			unsigned int const index0{indices.at(i + 0)};
 			unsigned int const index1{indices.at(i + 1)};
 			unsigned int const index2{indices.at(i + 2)};
 
-			vector4f const& v0 = m_transformed_vertices_storage.at(index0);
-			vector4f const& v1 = m_transformed_vertices_storage.at(index1);
-			vector4f const& v2 = m_transformed_vertices_storage.at(index2);
+			unsigned int const outcode0{outcodes.at(index0)};
+			unsigned int const outcode1{outcodes.at(index1)};
+			unsigned int const outcode2{outcodes.at(index2)};
 
-			bool const v0_clipped{m_transformed_vertices_clip_flags_storage.at(index0)};
-			bool const v1_clipped{m_transformed_vertices_clip_flags_storage.at(index1)};
-			bool const v2_clipped{m_transformed_vertices_clip_flags_storage.at(index2)};
+			// Whole triangle is inside the frustum
+			//
+			if ((outcode0 | outcode1 | outcode2) == 0)
+			{
+				++m_counters.trivially_accepted_triangles_count;
 
-			// Clip triangle if at least one vertex is outside of a screen as a workaround
-			// TODO: clipping
+				if (is_triangle_culled(screen_space_vertices[index0], screen_space_vertices[index1], screen_space_vertices[index2], do_homogeneous_division))
+				{
+					continue;
+				}
+
+				delegate.process_geometry_stage_result(
+					screen_space_vertices[index0], screen_space_vertices[index1], screen_space_vertices[index2],
+					index0, index1, index2,
+					shader,
+					target_texture);
+
+				continue;
+			}
+
+			// Whole triangle is outside of one of the planes
 			//
-			if (v0_clipped || v1_clipped || v2_clipped)
+			if ((outcode0 & outcode1 & outcode2) != 0)
 			{
+				++m_counters.trivially_rejected_triangles_count;
 				continue;
 			}
 
-			delegate.process_geometry_stage_result(
-				v0, v1, v2,
-				index0, index1, index2,
-				shader,
-				target_texture);
+			// Clip triangle and split resulting convex polygon into triangles fan
+			//
+
+			++m_counters.clipped_triangles_count;
+
+			unsigned int const polygon_size{clip_triangle(index0, index1, index2, outcode0 | outcode1 | outcode2, clipped_polygon)};
+
+			for (unsigned int j{0}; j < polygon_size; ++j)
+			{
+				polygon_vertex const& polygon_v = clipped_polygon[j];
+
+				if (polygon_v.index != NOT_MESH_VERTEX_INDEX)
+				{
+					clipped_polygon_transformed[j] = screen_space_vertices[polygon_v.index];
+					clipped_polygon_indices[j] = polygon_v.index;
+				}
+				else
+				{
+					clipped_polygon_transformed[j] = transform_to_screen(polygon_v.position, do_homogeneous_division, width, height);
+					clipped_polygon_indices[j] = static_cast<unsigned int>(m_clipped_vertices.size()) | CLIPPED_VERTEX_INDEX_FLAG;
+
+					m_clipped_vertices.push_back(
+						clipped_vertex_info{
+							{index0, index1, index2},
+							{polygon_v.weights[0], polygon_v.weights[1], polygon_v.weights[2]}});
+				}
+			}
+
+			for (unsigned int j{2}; j < polygon_size; ++j)
+			{
+				if (is_triangle_culled(clipped_polygon_transformed[0], clipped_polygon_transformed[j - 1], clipped_polygon_transformed[j], do_homogeneous_division))
+				{
+					continue;
+				}
+
+				delegate.process_geometry_stage_result(
+					clipped_polygon_transformed[0], clipped_polygon_transformed[j - 1], clipped_polygon_transformed[j],
+					clipped_polygon_indices[0], clipped_polygon_indices[j - 1], clipped_polygon_indices[j],
+					shader,
+					target_texture);
+			}
 		}
 	}
 }
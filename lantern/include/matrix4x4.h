@@ -2,6 +2,7 @@
 #define LANTERN_MATRIX4X4_H
 
 #include <cmath>
+#include <cstddef>
 #include "vector4.h"
 #include "vector3.h"
 
@@ -96,6 +97,15 @@ namespace lantern
 			v.x * m.values[0][2] + v.y * m.values[1][2] + v.z * m.values[2][2] + v.w * m.values[3][2],
 			v.x * m.values[0][3] + v.y * m.values[1][3] + v.z * m.values[2][3] + v.w * m.values[3][3]};
 	}
+
+	/** Multiplies every vector of array by matrix.
+	* When SSE2 is available, vectors are transposed into structure of arrays by groups of four and transformed at once
+	* @param input Vectors to transform
+	* @param output Storage for transformed vectors, can be the same as input
+	* @param count Count of vectors
+	* @param m Matrix to multiply by
+	*/
+	void transform_vectors(vector4f const* const input, vector4f* const output, size_t const count, matrix4x4f const& m);
 }
 
 #endif // LANTERN_MATRIX4X4_H
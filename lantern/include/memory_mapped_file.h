@@ -0,0 +1,57 @@
+#ifndef LANTERN_MEMORY_MAPPED_FILE_H
+#define LANTERN_MEMORY_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace lantern
+{
+	/** Read-only file mapped into memory, so that its content can be accessed without reading it into a buffer */
+	class memory_mapped_file final
+	{
+	public:
+		/** Maps file into memory
+		* @param path Path to the file
+		*/
+		explicit memory_mapped_file(std::string const& path);
+
+		/** Unmaps the file */
+		~memory_mapped_file();
+
+		memory_mapped_file(memory_mapped_file const&) = delete;
+		memory_mapped_file& operator=(memory_mapped_file const&) = delete;
+
+		/** Gets file content
+		* @returns Pointer to the first byte of the file, nullptr if file is empty
+		*/
+		char const* get_data() const;
+
+		/** Gets file size
+		* @returns Size in bytes
+		*/
+		size_t get_size() const;
+
+	private:
+		/** Unmaps the file and closes handles */
+		void close();
+
+		/** Mapped content */
+		char const* m_data;
+
+		/** Content size */
+		size_t m_size;
+
+#ifdef _WIN32
+		/** File handle */
+		void* m_file_handle;
+
+		/** File mapping handle */
+		void* m_mapping_handle;
+#else
+		/** File descriptor */
+		int m_file_descriptor;
+#endif
+	};
+}
+
+#endif // LANTERN_MEMORY_MAPPED_FILE_H
@@ -4,9 +4,41 @@
 #include "vector2.h"
 #include "vector3.h"
 #include "texture.h"
+#include "depth_buffer.h"
 
 namespace lantern
 {
+	/** Depth test comparison functions option.
+	* Incoming sample's depth is compared against the value stored in a depth buffer
+	* @ingroup Rendering
+	*/
+	enum class depth_test_function_option
+	{
+		/** Sample never passes */
+		never,
+
+		/** Sample passes if its depth is less than the stored one */
+		less,
+
+		/** Sample passes if its depth is less than or equal to the stored one */
+		less_or_equal,
+
+		/** Sample passes if its depth is equal to the stored one */
+		equal,
+
+		/** Sample passes if its depth is greater than or equal to the stored one */
+		greater_or_equal,
+
+		/** Sample passes if its depth is greater than the stored one */
+		greater,
+
+		/** Sample passes if its depth is not equal to the stored one */
+		not_equal,
+
+		/** Sample always passes */
+		always
+	};
+
 	/** This stage is responsible for invoking pixel shader and merging results into a texture */
 	class merging_stage final
 	{
@@ -24,8 +56,40 @@ namespace lantern
 		*/
 		void set_alpha_blending_enabled(bool const enabled);
 
-		/** Invokes stage
-		* @param point Point coordinates to process
+		/** Gets depth test function
+		* @returns Depth test function
+		*/
+		depth_test_function_option get_depth_test_function() const;
+
+		/** Sets depth test function
+		* @param function Function to compare samples depth with
+		*/
+		void set_depth_test_function(depth_test_function_option const function);
+
+		/** Gets depth write mode
+		* @returns True if depth of passed samples is written into a depth buffer
+		*/
+		bool get_depth_write_enabled() const;
+
+		/** Sets depth write mode
+		* @param enabled Depth write mode
+		*/
+		void set_depth_write_enabled(bool const enabled);
+
+		/** Gets depth buffer used for depth testing
+		* @returns Depth buffer or nullptr if depth test is disabled
+		*/
+		depth_buffer* get_depth_buffer() const;
+
+		/** Sets depth buffer to use for depth testing. Depth test is disabled when there is no depth buffer
+		* @param buffer Depth buffer or nullptr
+		*/
+		void set_depth_buffer(depth_buffer* buffer);
+
+		/** Invokes stage.
+		* Depth test (if enabled) is performed before invoking pixel shader, so occluded samples are not shaded at all
+		* @param pixel_coordinates Coordinates of a pixel to process
+		* @param sample_point Sample point coordinates, z-coordinate is a screen space depth
 		* @param shader Shader to invoke
 		* @param target_texture Texture to merge results into
 		* @param delegate Delegate to pass results to for futher processing
@@ -33,17 +97,103 @@ namespace lantern
 		template<typename TShader, typename TDelegate>
 		void invoke(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture, TDelegate& delegate);
 
+		/** Invokes stage with alpha blending mode known at compile time, current alpha blending setting is ignored
+		* @param pixel_coordinates Coordinates of a pixel to process
+		* @param sample_point Sample point coordinates, z-coordinate is a screen space depth
+		* @param shader Shader to invoke
+		* @param target_texture Texture to merge results into
+		* @param delegate Delegate to pass results to for futher processing
+		*/
+		template<bool TAlphaBlendingEnabled, typename TShader, typename TDelegate>
+		void invoke(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture, TDelegate& delegate);
+
 	private:
+		/** Checks if sample passes the depth test
+		* @param sample_depth Incoming sample depth
+		* @param stored_depth Depth value stored in a buffer
+		* @returns True if sample passes
+		*/
+		bool is_passing_depth_test(float const sample_depth, float const stored_depth) const;
+
 		/** True = use alpha channel during merging */
 		bool m_alpha_blending_enabled;
+
+		/** Depth test comparison function */
+		depth_test_function_option m_depth_test_function;
+
+		/** True = write depth of passed samples */
+		bool m_depth_write_enabled;
+
+		/** Depth buffer to test samples against, nullptr if depth test is disabled */
+		depth_buffer* m_depth_buffer;
 	};
 
+	inline bool merging_stage::is_passing_depth_test(float const sample_depth, float const stored_depth) const
+	{
+		switch (m_depth_test_function)
+		{
+			case depth_test_function_option::never:
+				return false;
+
+			case depth_test_function_option::less:
+				return sample_depth < stored_depth;
+
+			case depth_test_function_option::less_or_equal:
+				return sample_depth <= stored_depth;
+
+			case depth_test_function_option::equal:
+				return sample_depth == stored_depth;
+
+			case depth_test_function_option::greater_or_equal:
+				return sample_depth >= stored_depth;
+
+			case depth_test_function_option::greater:
+				return sample_depth > stored_depth;
+
+			case depth_test_function_option::not_equal:
+				return sample_depth != stored_depth;
+
+			case depth_test_function_option::always:
+				return true;
+		}
+
+		return true;
+	}
+
 	template<typename TShader, typename TDelegate>
 	inline void merging_stage::invoke(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture, TDelegate& delegate)
 	{
+		if (m_alpha_blending_enabled)
+		{
+			invoke<true>(pixel_coordinates, sample_point, shader, target_texture, delegate);
+		}
+		else
+		{
+			invoke<false>(pixel_coordinates, sample_point, shader, target_texture, delegate);
+		}
+	}
+
+	template<bool TAlphaBlendingEnabled, typename TShader, typename TDelegate>
+	inline void merging_stage::invoke(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture, TDelegate& delegate)
+	{
+		// Early depth test: do not shade samples that are going to be rejected anyway
+		//
+		if (m_depth_buffer != nullptr)
+		{
+			if (!is_passing_depth_test(sample_point.z, m_depth_buffer->get_depth(pixel_coordinates)))
+			{
+				return;
+			}
+
+			if (m_depth_write_enabled)
+			{
+				m_depth_buffer->set_depth(pixel_coordinates, sample_point.z);
+			}
+		}
+
 		color const color_from_shader = shader.process_pixel(pixel_coordinates);
 
-		if (!m_alpha_blending_enabled)
+		if (!TAlphaBlendingEnabled)
 		{
 			target_texture.set_pixel_color(pixel_coordinates, color_from_shader);
 		}
@@ -1,8 +1,10 @@
 #ifndef LANTERN_MESH_H
 #define LANTERN_MESH_H
 
+#include <cstdint>
 #include <vector>
 #include "mesh_attribute_info.h"
+#include "submesh.h"
 #include "vector2.h"
 #include "vector3.h"
 #include "color.h"
@@ -18,7 +20,7 @@ namespace lantern
 		/** Constructs empy mesh */
 		mesh();
 
-		/** Constructs mesh with specified vertices and indices
+		/** Constructs mesh with specified vertices and indices. They are taken by value, so passing temporaries moves them without copying
 		* @param vertices Mesh vertices
 		* @param indices Mesh indices
 		*/
@@ -84,6 +86,27 @@ namespace lantern
 		*/
 		std::vector<mesh_attribute_info<vector3f>> const& get_vector3f_attributes() const;
 
+		/** Gets submeshes, ranges of indices that can be rendered separately. Empty list means mesh isn't split
+		* @returns Submeshes storage
+		*/
+		std::vector<submesh>& get_submeshes();
+
+		/** Gets submeshes, ranges of indices that can be rendered separately. Empty list means mesh isn't split
+		* @returns Submeshes const storage
+		*/
+		std::vector<submesh> const& get_submeshes() const;
+
+		/** Gets version of mesh content, used to tell if results computed for the mesh are still valid.
+		* Every constructed mesh gets a version never used before, copies share it with the source
+		* @returns Content version
+		*/
+		uint64_t get_version() const;
+
+		/** Assigns new version to mesh content. Should be called after vertices or indices were changed in place
+		* if results computed for the mesh are reused, e.g. by geometry stage transformed vertices cache
+		*/
+		void mark_changed();
+
 	private:
 		/** Mesh vertices */
 		std::vector<vector3f> m_vertices;
@@ -102,7 +125,22 @@ namespace lantern
 
 		/** Mesh vector3f attributes */
 		std::vector<mesh_attribute_info<vector3f>> m_vector3f_attributes;
+
+		/** Mesh submeshes */
+		std::vector<submesh> m_submeshes;
+
+		/** Content version */
+		uint64_t m_version;
 	};
+
+	/** Builds mesh with a single index buffer out of a mesh which attributes are indexed separately, the way .obj files define them.
+	* Attributes indices of the source mesh go in parallel with its indices, i.e. they index values of triangles corners.
+	* Every distinct combination of position and attributes indices becomes a vertex of the result mesh, and its attributes store values per vertex.
+	* That lets geometry stage transform every shared vertex once and saves attributes indices lookups during rasterization
+	* @param source Mesh to compile
+	* @returns Mesh with attributes values stored per vertex
+	*/
+	mesh compile_mesh(mesh const& source);
 }
 
 #endif // LANTERN_MESH_H
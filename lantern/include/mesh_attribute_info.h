@@ -1,6 +1,7 @@
 #ifndef LANTERN_MESH_ATTRIBUTE_INFO
 #define LANTERN_MESH_ATTRIBUTE_INFO
 
+#include <utility>
 #include <vector>
 
 namespace lantern
@@ -20,15 +21,15 @@ namespace lantern
 	class mesh_attribute_info final
 	{
 	public:
-		/** Constructs attribute info
+		/** Constructs attribute info. Data and indices are taken by value, so passing temporaries moves them without copying
 		* @param attribute_id Attribute ID, should be unique
 		* @param data Attribute data
-		* @param indices Attribute indices
+		* @param indices Attribute indices, empty if data is indexed by mesh vertex indices directly
 		*/
 		mesh_attribute_info(
 			unsigned int const attribute_id,
-			std::vector<TAttr> const data,
-			std::vector<unsigned int> const indices,
+			std::vector<TAttr> data,
+			std::vector<unsigned int> indices,
 			attribute_interpolation_option interpolation_option);
 
 		/** Gets attribute ID
@@ -41,11 +42,21 @@ namespace lantern
 		*/
 		std::vector<TAttr> const& get_data() const;
 
-		/** Gets attribute indices
+		/** Gets attribute data
+		* @returns Attribute data
+		*/
+		std::vector<TAttr>& get_data();
+
+		/** Gets attribute indices. Empty indices mean that data is indexed by mesh vertex indices directly
 		* @returns Indices
 		*/
 		std::vector<unsigned int> const& get_indices() const;
 
+		/** Gets attribute indices. Empty indices mean that data is indexed by mesh vertex indices directly
+		* @returns Indices
+		*/
+		std::vector<unsigned int>& get_indices();
+
 		/** Gets interpolation option
 		* @returns Interpolation type
 		*/
@@ -53,13 +64,13 @@ namespace lantern
 
 	private:
 		/** Attribute id */
-		unsigned int const m_id;
+		unsigned int m_id;
 
 		/** Attribute data */
-		std::vector<TAttr> const m_data;
+		std::vector<TAttr> m_data;
 
 		/** Attribute indices */
-		std::vector<unsigned int> const m_indices;
+		std::vector<unsigned int> m_indices;
 
 		/** Interpolation option */
 		attribute_interpolation_option m_interpolation_option;
@@ -74,12 +85,12 @@ namespace lantern
 	template<typename TAttr>
 	mesh_attribute_info<TAttr>::mesh_attribute_info(
 		unsigned int const attribute_id,
-		std::vector<TAttr> const data,
-		std::vector<unsigned int> const indices,
+		std::vector<TAttr> data,
+		std::vector<unsigned int> indices,
 		attribute_interpolation_option interpolation_option)
 		: m_id{attribute_id},
-		  m_data(data),
-		  m_indices(indices),
+		  m_data(std::move(data)),
+		  m_indices(std::move(indices)),
 		  m_interpolation_option{interpolation_option}
 	{
 
@@ -97,12 +108,24 @@ namespace lantern
 		return m_data;
 	}
 
+	template<typename TAttr>
+	std::vector<TAttr>& mesh_attribute_info<TAttr>::get_data()
+	{
+		return m_data;
+	}
+
 	template<typename TAttr>
 	std::vector<unsigned int> const& mesh_attribute_info<TAttr>::get_indices() const
 	{
 		return m_indices;
 	}
 
+	template<typename TAttr>
+	std::vector<unsigned int>& mesh_attribute_info<TAttr>::get_indices()
+	{
+		return m_indices;
+	}
+
 	template<typename TAttr>
 	attribute_interpolation_option mesh_attribute_info<TAttr>::get_interpolation_option() const
 	{
@@ -0,0 +1,53 @@
+#ifndef LANTERN_MESH_BINARY_H
+#define LANTERN_MESH_BINARY_H
+
+#include <cstdint>
+#include <string>
+#include "mesh.h"
+
+namespace lantern
+{
+	/** Information about the source a binary mesh file was built from */
+	class binary_mesh_source_info final
+	{
+	public:
+		/** Source file size in bytes */
+		uint64_t size;
+
+		/** Hash of the source file content */
+		uint64_t content_hash;
+
+		/** Source specific flags, e.g. which attributes were imported */
+		uint32_t flags;
+	};
+
+	/** Writes mesh into compact binary file: header followed by vertices, indices, attributes and submeshes blocks,
+	* stored in native byte order exactly the way mesh keeps them in memory
+	* @param m Mesh to write
+	* @param path Path to write file to
+	* @param source_info Information about the source mesh was built from, used to validate caches
+	*/
+	void save_mesh_to_binary(mesh const& m, std::string const& path, binary_mesh_source_info const& source_info);
+
+	/** Reads mesh from binary file written by save_mesh_to_binary.
+	* File is mapped into memory and every block is copied into mesh storage as a whole, without any parsing
+	* @param path Binary mesh file path
+	* @returns Mesh
+	*/
+	mesh load_mesh_from_binary(std::string const& path);
+
+	/** Reads information about the source binary mesh file was built from, without reading the mesh
+	* @param path Binary mesh file path
+	* @returns Source info
+	*/
+	binary_mesh_source_info get_binary_mesh_source_info(std::string const& path);
+
+	/** Calculates hash of data, suitable to detect changes of a file content
+	* @param data Data to hash
+	* @param size Data size in bytes
+	* @returns 64-bit FNV-1a hash
+	*/
+	uint64_t get_content_hash(char const* const data, size_t const size);
+}
+
+#endif // LANTERN_MESH_BINARY_H
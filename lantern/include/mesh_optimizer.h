@@ -0,0 +1,50 @@
+#ifndef LANTERN_MESH_OPTIMIZER_H
+#define LANTERN_MESH_OPTIMIZER_H
+
+#include <vector>
+#include "mesh.h"
+
+namespace lantern
+{
+	/** Default size of FIFO post-transform vertex cache the optimizations target */
+	unsigned int const DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+	/** Reorders mesh triangles so that vertices are reused while they're still in post-transform cache.
+	* Uses Tipsify algorithm (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+	* Triangles don't leave submeshes they belong to, so submeshes ranges stay valid
+	* @param m Mesh to reorder triangles of
+	* @param cache_size Size of FIFO vertex cache to optimize for
+	* @returns Index of the first triangle of every cluster: triangles between dead-ends of the traversal,
+	* that can be reordered as a whole without affecting vertex cache usage much
+	*/
+	std::vector<unsigned int> optimize_vertex_cache(mesh& m, unsigned int const cache_size);
+
+	/** Reorders clusters of triangles so that those facing outwards from the mesh center go first.
+	* Such clusters are likely to occlude the others, so that less pixels are shaded and then overwritten.
+	* If mesh has submeshes, clusters are reordered inside every submesh relatively to its center
+	* @param m Mesh to reorder triangles of
+	* @param clusters Index of the first triangle of every cluster, as returned by optimize_vertex_cache
+	*/
+	void optimize_overdraw(mesh& m, std::vector<unsigned int> const& clusters);
+
+	/** Reorders mesh vertices and their attributes in order of their first use by triangles, so that vertices are fetched sequentially.
+	* Attributes with indices are expected to be indexed by vertices indices, like the renderer reads them: compile meshes with separately indexed attributes first.
+	* Vertices not referenced by triangles are moved to the end
+	* @param m Mesh to reorder vertices of
+	*/
+	void optimize_vertex_fetch(mesh& m);
+
+	/** Applies all the optimizations: vertex cache, overdraw and vertex fetch ones
+	* @param m Mesh to optimize
+	*/
+	void optimize_mesh(mesh& m);
+
+	/** Calculates average cache miss ratio: count of vertices transformed per triangle with FIFO post-transform vertex cache
+	* @param indices Triangles indices
+	* @param cache_size Size of FIFO vertex cache
+	* @returns Value between 0.5 (best case for large regular meshes) and 3.0 (no reuse at all)
+	*/
+	float get_average_cache_miss_ratio(std::vector<unsigned int> const& indices, unsigned int const cache_size);
+}
+
+#endif // LANTERN_MESH_OPTIMIZER_H
@@ -1,25 +1,67 @@
 #ifndef LANTERN_OBJ_IMPORT_H
 #define LANTERN_OBJ_IMPORT_H
 
+#include <cstddef>
 #include <string>
 #include "mesh.h"
+#include "thread_pool.h"
 
 namespace lantern
 {
+	/** Counts of .obj elements definitions */
+	class obj_elements_counts final
+	{
+	public:
+		/** Count of vertices */
+		unsigned int vertices_count;
+
+		/** Count of texcoords */
+		unsigned int texcoords_count;
+
+		/** Count of normals */
+		unsigned int normals_count;
+	};
+
 	/** Wavefront .obj file reader.
-	* Derived classes can override on_* virtual functions to process definitions
+	* Derived classes can override on_* virtual functions to process definitions.
+	* Faces with any count of vertices are reported as fans of triangles, face vertices indices can be negative, i.e. relative to the last definition
 	*/
 	class obj_reader
 	{
 	public:
-		/** Parses .obj file
+		/** Constructs reader */
+		obj_reader();
+
+		/** Parses .obj file. File is mapped into memory rather than read
 		* @param path Path to obj file
 		*/
 		void read(std::string const& path);
 
-		typedef void (obj_reader::*parse_face_function)(std::istringstream&);
+		/** Parses .obj file content
+		* @param data Content to parse
+		* @param size Content size in bytes
+		*/
+		void parse(char const* const data, size_t const size);
 
 	protected:
+		/** Parses part of .obj file content
+		* @param data Content to parse
+		* @param size Content size in bytes
+		* @param preceding_counts Counts of elements defined before the content, relative indices are resolved against them
+		* @param are_preceding_counts_known If false, faces with relative indices are skipped and has_skipped_faces() returns true
+		*/
+		void parse(char const* const data, size_t const size, obj_elements_counts const& preceding_counts, bool const are_preceding_counts_known);
+
+		/** Gets counts of elements defined in the last parsed content
+		* @returns Counts
+		*/
+		obj_elements_counts const& get_read_elements_counts() const;
+
+		/** Checks if faces with relative indices were skipped during the last parsing because preceding counts weren't known
+		* @returns True if faces were skipped
+		*/
+		bool has_skipped_faces() const;
+
 		/** Gets called when parsing starts */
 		virtual void on_reading_started();
 
@@ -73,35 +115,36 @@ namespace lantern
 		*/
 		virtual void on_face_normal_def(unsigned int normal_index0, unsigned int normal_index1, unsigned int normal_index2);
 
-	private:
-		/** Gets function suitable to parse specified definition
-		* @param face_def Face definition string
-		* @returns Function to parse the definition
+		/** Gets called when object name definition found
+		* @param name Object name
 		*/
-		parse_face_function get_parse_function(std::string face_def);
+		virtual void on_object_def(std::string const& name);
 
-		/** Parses vertex only face defintiion
-		* @param stream Face definition string stream
+		/** Gets called when group name definition found
+		* @param name Group name
 		*/
-		void parse_face_vertex(std::istringstream& stream);
+		virtual void on_group_def(std::string const& name);
 
-		/** Parses vertex and normal face defintiion
-		* @param stream Face definition string stream
+		/** Gets called when material usage definition found, following faces use that material
+		* @param name Material name
 		*/
-		void parse_face_vertex_normal(std::istringstream& stream);
+		virtual void on_material_usage_def(std::string const& name);
 
-		/** Parses vertex and texcoord face defintiion
-		* @param stream Face definition string stream
+		/** Gets called when material library definition found
+		* @param names Space separated names of .mtl files
 		*/
-		void parse_face_vertex_texcoord(std::istringstream& stream);
+		virtual void on_material_library_def(std::string const& names);
 
-		/** Parses vertex, texcoord and normal face defintiion
-		* @param stream Face definition string stream
-		*/
-		void parse_face_vertex_texcoord_normal(std::istringstream& stream);
+	private:
+		/** Counts of elements defined in the last parsed content */
+		obj_elements_counts m_read_elements_counts;
+
+		/** Were faces skipped during the last parsing */
+		bool m_has_skipped_faces;
 	};
 
-	/** Simple importer of mesh object from .obj file
+	/** Simple importer of mesh object from .obj file.
+	* Objects, groups and materials changes split mesh into submeshes, every face belongs to one of them
 	*/
 	class obj_mesh_importer final : public obj_reader
 	{
@@ -117,6 +160,23 @@ namespace lantern
 		*/
 		mesh get_mesh() const;
 
+		/** Gets result mesh moving read data into it without copying, importer is left empty
+		* @returns Mesh from .obj file
+		*/
+		mesh take_mesh();
+
+		/** Reads .obj file using several threads: file is split into chunks at lines boundaries,
+		* chunks are parsed in parallel and then merged. Result is the same as after reading the file serially
+		* @param path Path to obj file
+		* @param pool Thread pool to parse chunks on
+		*/
+		void read_parallel(std::string const& path, thread_pool& pool);
+
+		/** Gets names of .mtl files defined in .obj file
+		* @returns Material libraries names, relative to .obj file directory
+		*/
+		std::vector<std::string> const& get_material_libraries() const;
+
 		virtual void on_reading_started() override;
 
 		virtual void on_vertex_def(float const x, float const y, float const z) override;
@@ -127,7 +187,51 @@ namespace lantern
 		virtual void on_face_texcoord_def(unsigned int texcoord_index0, unsigned int texcoord_index1, unsigned int texcoord_index2) override;
 		virtual void on_face_normal_def(unsigned int normal_index0, unsigned int normal_index1, unsigned int normal_index2) override;
 
+		virtual void on_object_def(std::string const& name) override;
+		virtual void on_group_def(std::string const& name) override;
+		virtual void on_material_usage_def(std::string const& name) override;
+		virtual void on_material_library_def(std::string const& names) override;
+
 	private:
+		/** Min size of a chunk parsed by one thread during parallel reading, in bytes */
+		static size_t const MIN_PARALLEL_CHUNK_SIZE = 64 * 1024;
+
+		/** Counts of read definitions */
+		class definitions_counts final
+		{
+		public:
+			/** Count of vertices */
+			size_t vertices_count;
+
+			/** Count of vertices indices */
+			size_t indices_count;
+
+			/** Count of texcoords */
+			size_t texcoords_count;
+
+			/** Count of texcoords indices */
+			size_t texcoords_indices_count;
+
+			/** Count of normals */
+			size_t normals_count;
+
+			/** Count of normals indices */
+			size_t normals_indices_count;
+		};
+
+		/** Gets counts of definitions read so far
+		* @returns Counts
+		*/
+		definitions_counts get_definitions_counts() const;
+
+		/** Starts new submesh with current object and material names, unless the last one has no faces yet */
+		void start_submesh();
+
+		/** Adds submeshes that have faces to mesh and calculates their bounding boxes
+		* @param m Mesh to add submeshes to
+		*/
+		void add_submeshes(mesh& m) const;
+
 		/** Is object reading texcoords */
 		bool const m_read_texcoords;
 
@@ -151,14 +255,97 @@ namespace lantern
 
 		/** Mesh normals indices */
 		std::vector<unsigned int> m_normals_indices;
+
+		/** Mesh submeshes, including ones without faces */
+		std::vector<submesh> m_submeshes;
+
+		/** Current object name */
+		std::string m_object_name;
+
+		/** Current material name */
+		std::string m_material_name;
+
+		/** Was object name defined in parsed content */
+		bool m_is_object_name_defined;
+
+		/** Was material name defined in parsed content */
+		bool m_is_material_name_defined;
+
+		/** Count of leading submeshes started before object name was defined in parsed content.
+		* Content parsed as a part of a file gets object name of these submeshes from preceding content
+		*/
+		size_t m_object_name_inheriting_submeshes_count;
+
+		/** Count of leading submeshes started before material name was defined in parsed content */
+		size_t m_material_name_inheriting_submeshes_count;
+
+		/** Names of .mtl files */
+		std::vector<std::string> m_material_libraries;
 	};
 
+	/** Material defined in .mtl file */
+	class obj_material final
+	{
+	public:
+		/** Material name */
+		std::string name;
+
+		/** Diffuse color */
+		color diffuse_color;
+
+		/** Path of diffuse texture, relative to the current directory rather than to .mtl file. Empty if material has no texture */
+		std::string diffuse_texture_path;
+	};
+
+	/** Reads materials from .mtl file. Only diffuse color and texture are read
+	* @param path .mtl file path
+	* @returns Materials
+	*/
+	std::vector<obj_material> load_materials_from_mtl(std::string const& path);
+
 	/** Reads mesh from .obj file. Helper function to avoid creating temporary parser objects
 	* @param path .obj file path
 	* @param read_texcoords Indicates if mesh will contain texcoords from .obj file
 	* @param read_normals  Indicates if mesh will contain normals from .obj file
 	*/
 	mesh load_mesh_from_obj(std::string const& path, bool const read_texcoords, bool const read_normals);
+
+	/** Reads mesh from .obj file along with materials from .mtl files it uses.
+	* Mesh submeshes refer to materials by their names
+	* @param path .obj file path
+	* @param read_texcoords Indicates if mesh will contain texcoords from .obj file
+	* @param read_normals  Indicates if mesh will contain normals from .obj file
+	* @param materials Storage to add read materials to
+	*/
+	mesh load_mesh_from_obj(std::string const& path, bool const read_texcoords, bool const read_normals, std::vector<obj_material>& materials);
+
+	/** Specifies how binary cache of .obj file is checked to be up to date */
+	enum class obj_cache_validation_option
+	{
+		/** Cache is used if it's newer than .obj file */
+		modification_time,
+
+		/** Cache is used if it was built from .obj file with the same content, file is hashed on every load */
+		content_hash
+	};
+
+	/** Reads mesh from .obj file through binary cache stored next to it with ".lmesh" extension appended.
+	* Cache is used if it was built with the same import params and is up to date, otherwise it's rebuilt.
+	* Failure to write the cache is not an error
+	* @param path .obj file path
+	* @param read_texcoords Indicates if mesh will contain texcoords from .obj file
+	* @param read_normals  Indicates if mesh will contain normals from .obj file
+	* @param validation How cache is checked to be up to date
+	*/
+	mesh load_mesh_from_obj_cached(std::string const& path, bool const read_texcoords, bool const read_normals, obj_cache_validation_option const validation);
+
+	/** Reads mesh from .obj file using several threads
+	* @param path .obj file path
+	* @param read_texcoords Indicates if mesh will contain texcoords from .obj file
+	* @param read_normals  Indicates if mesh will contain normals from .obj file
+	* @param pool Thread pool to parse file on
+	*/
+	mesh load_mesh_from_obj(std::string const& path, bool const read_texcoords, bool const read_normals, thread_pool& pool);
 }
 
 #endif // LANTERN_OBJ_IMPORT_H
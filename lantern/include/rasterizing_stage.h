@@ -8,10 +8,18 @@
 #include "matrix3x3.h"
 #include "texture.h"
 #include "mesh_attribute_info.h"
+#include "binded_mesh_attributes.h"
+#include "attributes_interpolator.h"
 #include "line.h"
+#include "fixed_point_edge.h"
 #include "aabb.h"
 #include "math_common.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LANTERN_RASTERIZING_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace lantern
 {
 	/** Rasterization algorithms option
@@ -28,6 +36,18 @@ namespace lantern
 		/** Rasterization using traversal algorithm changing direction on every line */
 		traversal_zigzag,
 
+		/** Rasterization using traversal algorithm with axis-aligned bounding box and sub-pixel fixed point edge functions.
+		* Triangles sharing an edge never leave gaps or cover the same pixel twice */
+		traversal_aabb_fixed_point,
+
+		/** Rasterization using traversal algorithm with axis-aligned bounding box, evaluating edge equations for blocks of 4 pixels at once.
+		* SSE2 is used when it's available, otherwise blocks are evaluated by scalar code */
+		traversal_aabb_simd,
+
+		/** Rasterization using hierarchical traversal with fixed point edge functions: 16x16 and then 4x4 pixels blocks are tested
+		* against the triangle, blocks outside of it are skipped and blocks fully inside are filled without per-pixel tests */
+		traversal_hierarchical,
+
 		/** Rasterization using inversed slope algorithm */
 		inversed_slope,
 
@@ -36,33 +56,6 @@ namespace lantern
 		homogeneous
 	};
 
-	/** Class that holds information about binded attribute: its info and bind point.
-	* It's required when we rasterize a triangle: we need to know where put each attribute's interpolated value
-	* @ingroup Rendering
-	*/
-	template<typename TAttr>
-	class binded_mesh_attribute_info final
-	{
-	public:
-		/** Attribute data */
-		mesh_attribute_info<TAttr> const& info;
-
-		/** Address of variable to put interpolated value into */
-		TAttr* bind_point;
-	};
-
-	/** Container for all the binds
-	* @ingroup Rendering
-	*/
-	class binded_mesh_attributes final
-	{
-	public:
-		std::vector<binded_mesh_attribute_info<color>> color_attributes;
-		std::vector<binded_mesh_attribute_info<float>> float_attributes;
-		std::vector<binded_mesh_attribute_info<vector2f>> vector2f_attributes;
-		std::vector<binded_mesh_attribute_info<vector3f>> vector3f_attributes;
-	};
-
 	/** This rendering stage is responsible for calculating which pixels cover a texture
 	* @ingroup Rendering
 	*/
@@ -82,6 +75,15 @@ namespace lantern
 		*/
 		rasterization_algorithm_option get_rasterization_algorithm() const;
 
+		/** Sets scissor rectangle: pixels outside of it are not passed to the delegate.
+		* Pixels inside the rectangle are rasterized exactly as they would be without scissor test
+		* @param rectangle Rectangle, both points are inclusive
+		*/
+		void set_scissor_rectangle(aabb<vector2ui> const& rectangle);
+
+		/** Disables scissor test */
+		void reset_scissor_rectangle();
+
 		/** Invokes stage
 		* @param vertex0 First triangle vertex
 		* @param vertex1 Second triangle vertex
@@ -103,8 +105,35 @@ namespace lantern
 			texture& target_texture,
 			TDelegate& delegate);
 
+		/** Invokes stage with rasterization algorithm known at compile time, current algorithm setting is ignored
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param index0 First vertex attribute index
+		* @param index1 Second vertex attribute index
+		* @param index2 Third vertex attribute index
+		* @param shader Shader to use
+		* @param binded_attributes Mesh attributes binded to shader
+		* @param target_texture Texture polygon will drawn into
+		* @param delegate Object to pass results to for further processing
+		*/
+		template<rasterization_algorithm_option TAlgorithm, typename TShader, typename TDelegate>
+		void invoke(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			TShader& shader,
+			binded_mesh_attributes const& binded_attributes,
+			texture& target_texture,
+			TDelegate& delegate);
+
 	private:
-		
+		/** Checks if pixel is inside the scissor rectangle
+		* @param x Pixel x-coordinate
+		* @param y Pixel y-coordinate
+		* @returns True if pixel should be processed
+		*/
+		bool is_pixel_inside_scissor_rectangle(unsigned int const x, unsigned int const y) const;
+
 		// Traversal algorithms
 		//
 
@@ -117,25 +146,6 @@ namespace lantern
 		bool is_point_on_positive_halfspace_top_left(
 			float const edge_equation_value, float const edge_equation_a, float const edge_equation_b);
 
-		/** Sets binds points values basing on barycentric coordinates
-		* @param binds List of binds
-		* @param index0 First triangle vertex index in a mesh
-		* @param index1 Second triangle vertex index in a mesh
-		* @param index2 Third triangle vertex index in a mesh
-		* @param b0 First barycentric coordinate
-		* @param b1 Second barycentric coordinate
-		* @param b2 Third barycentric coordinate
-		* @param z0_view_space_reciprocal 1/z-view for first vertex
-		* @param z1_view_space_reciprocal 1/z-view for second vertex
-		* @param z1_view_space_reciprocal 1/z-view for third vertex
-		*/
-		template<typename TAttr>
-		void set_bind_points_values_from_barycentric(
-			std::vector<binded_mesh_attribute_info<TAttr>> const& binds,
-			unsigned int const index0, unsigned int const index1, unsigned int const index2,
-			float const b0, float const b1, float const b2,
-			float const z0_view_space_reciprocal, float const z1_view_space_reciprocal, float const z2_view_space_reciprocal);
-
 		/** Rasterizes triangle using current pipeline setup using traversal aabb algorithm
 		* @param vertex0 First triangle vertex
 		* @param vertex1 Second triangle vertex
@@ -199,6 +209,118 @@ namespace lantern
 			texture& target_texture,
 			TDelegate& delegate);
 
+		/** Rasterizes triangle using current pipeline setup using traversal aabb algorithm with fixed point edge functions
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param index0 First triangle vertex index in a mesh
+		* @param index1 Second triangle vertex index in a mesh
+		* @param index2 Third triangle vertex index in a mesh
+		* @param shader Shader to use
+		* @param binded_attributes Attributes to interpolate
+		* @param target_texture Texture polygon will be drawn into
+		* @param delegate Object to pass results to for further processing
+		*/
+		template<typename TShader, typename TDelegate>
+		void rasterize_traversal_aabb_fixed_point(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			TShader& shader,
+			binded_mesh_attributes const& binded_attributes,
+			texture& target_texture,
+			TDelegate& delegate);
+
+		/** Rasterizes triangle using current pipeline setup using traversal aabb algorithm processing 4x1 pixel blocks
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param index0 First triangle vertex index in a mesh
+		* @param index1 Second triangle vertex index in a mesh
+		* @param index2 Third triangle vertex index in a mesh
+		* @param shader Shader to use
+		* @param binded_attributes Attributes to interpolate
+		* @param target_texture Texture polygon will be drawn into
+		* @param delegate Object to pass results to for further processing
+		*/
+		template<typename TShader, typename TDelegate>
+		void rasterize_traversal_aabb_simd(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			TShader& shader,
+			binded_mesh_attributes const& binded_attributes,
+			texture& target_texture,
+			TDelegate& delegate);
+
+		/** Calculates attributes and depth of a pixel covered by triangle and passes it to the delegate
+		* @param x Pixel x-coordinate
+		* @param y Pixel y-coordinate
+		* @param edge1_value Unbiased value of the second edge function at pixel center
+		* @param edge2_value Unbiased value of the third edge function at pixel center
+		* @param doubled_area_inversed Inversed sum of unbiased edge functions values
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param shader Shader to use
+		* @param target_texture Texture polygon will be drawn into
+		* @param delegate Object to pass results to for further processing
+		*/
+		template<typename TShader, typename TDelegate>
+		void process_fixed_point_covered_pixel(
+			int64_t const x, int64_t const y,
+			int64_t const edge1_value, int64_t const edge2_value,
+			float const doubled_area_inversed,
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			TShader& shader,
+			texture& target_texture,
+			TDelegate& delegate);
+
+		/** Block coverage option */
+		enum class block_coverage_option
+		{
+			/** There are no pixel centers inside the triangle */
+			none,
+
+			/** Some of pixel centers may be inside the triangle */
+			partial,
+
+			/** All the pixel centers are inside the triangle */
+			full
+		};
+
+		/** Tests square block of pixels against the triangle, using the fact that edge function's extremums are at block corners
+		* @param edge0 First triangle edge
+		* @param edge1 Second triangle edge
+		* @param edge2 Third triangle edge
+		* @param x Top left block pixel x-coordinate
+		* @param y Top left block pixel y-coordinate
+		* @param size Block width and height in pixels
+		* @returns Block coverage
+		*/
+		block_coverage_option get_block_coverage(
+			fixed_point_edge const& edge0, fixed_point_edge const& edge1, fixed_point_edge const& edge2,
+			int64_t const x, int64_t const y, int64_t const size) const;
+
+		/** Rasterizes triangle using current pipeline setup using hierarchical traversal algorithm
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param index0 First triangle vertex index in a mesh
+		* @param index1 Second triangle vertex index in a mesh
+		* @param index2 Third triangle vertex index in a mesh
+		* @param shader Shader to use
+		* @param binded_attributes Attributes to interpolate
+		* @param target_texture Texture polygon will be drawn into
+		* @param delegate Object to pass results to for further processing
+		*/
+		template<typename TShader, typename TDelegate>
+		void rasterize_traversal_hierarchical(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			TShader& shader,
+			binded_mesh_attributes const& binded_attributes,
+			texture& target_texture,
+			TDelegate& delegate);
+
 		// Homogeneous algorithm
 		//
 
@@ -340,10 +462,58 @@ namespace lantern
 
 		/** Current rasterization algorithm */
 		rasterization_algorithm_option m_rasterization_algorithm;
+
+		/** True = skip pixels outside of scissor rectangle */
+		bool m_scissor_enabled;
+
+		/** Scissor rectangle */
+		aabb<vector2ui> m_scissor_rectangle;
+
+		// Intermediate storages reused between triangles
+		//
+
+		/** Interpolator of triangle attributes used by traversal algorithms */
+		attributes_interpolator m_attributes_interpolator;
+
+		/** Color attributes coefficients of homogeneous algorithm */
+		std::vector<vector3<color>> m_color_attributes_coefficients;
+
+		/** Float attributes coefficients of homogeneous algorithm */
+		std::vector<vector3<float>> m_float_attributes_coefficients;
+
+		/** Vector2f attributes coefficients of homogeneous algorithm */
+		std::vector<vector3<vector2f>> m_vector2f_attributes_coefficients;
+
+		/** Vector3f attributes coefficients of homogeneous algorithm */
+		std::vector<vector3<vector3f>> m_vector3f_attributes_coefficients;
+
+		/** Color attributes values on left scanline endpoint of inversed slope algorithm */
+		std::vector<color> m_left_color_attributes;
+
+		/** Color attributes values on right scanline endpoint of inversed slope algorithm */
+		std::vector<color> m_right_color_attributes;
+
+		/** Float attributes values on left scanline endpoint of inversed slope algorithm */
+		std::vector<float> m_left_float_attributes;
+
+		/** Float attributes values on right scanline endpoint of inversed slope algorithm */
+		std::vector<float> m_right_float_attributes;
+
+		/** Vector2f attributes values on left scanline endpoint of inversed slope algorithm */
+		std::vector<vector2f> m_left_vector2f_attributes;
+
+		/** Vector2f attributes values on right scanline endpoint of inversed slope algorithm */
+		std::vector<vector2f> m_right_vector2f_attributes;
+
+		/** Vector3f attributes values on left scanline endpoint of inversed slope algorithm */
+		std::vector<vector3f> m_left_vector3f_attributes;
+
+		/** Vector3f attributes values on right scanline endpoint of inversed slope algorithm */
+		std::vector<vector3f> m_right_vector3f_attributes;
 	};
 
 	template<typename TShader, typename TDelegate>
-	void rasterizing_stage::invoke(
+	inline void rasterizing_stage::invoke(
 		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
 		unsigned int const index0, unsigned int const index1, unsigned int const index2,
 		TShader& shader,
@@ -352,6 +522,101 @@ namespace lantern
 		TDelegate& delegate)
 	{
 		switch (m_rasterization_algorithm)
+		{
+			case rasterization_algorithm_option::traversal_aabb:
+				invoke<rasterization_algorithm_option::traversal_aabb>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_backtracking:
+				invoke<rasterization_algorithm_option::traversal_backtracking>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_zigzag:
+				invoke<rasterization_algorithm_option::traversal_zigzag>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_aabb_fixed_point:
+				invoke<rasterization_algorithm_option::traversal_aabb_fixed_point>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_aabb_simd:
+				invoke<rasterization_algorithm_option::traversal_aabb_simd>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_hierarchical:
+				invoke<rasterization_algorithm_option::traversal_hierarchical>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::homogeneous:
+				invoke<rasterization_algorithm_option::homogeneous>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::inversed_slope:
+				invoke<rasterization_algorithm_option::inversed_slope>(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+		}
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, typename TShader, typename TDelegate>
+	inline void rasterizing_stage::invoke(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		binded_mesh_attributes const& binded_attributes,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		// Algorithm is a compile time constant, so only one branch remains after optimization
+		//
+		switch (TAlgorithm)
 		{
 			case rasterization_algorithm_option::traversal_aabb:
 				rasterize_traversal_aabb(
@@ -383,6 +648,36 @@ namespace lantern
 					delegate);
 				break;
 
+			case rasterization_algorithm_option::traversal_aabb_fixed_point:
+				rasterize_traversal_aabb_fixed_point(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_aabb_simd:
+				rasterize_traversal_aabb_simd(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
+			case rasterization_algorithm_option::traversal_hierarchical:
+				rasterize_traversal_hierarchical(
+					vertex0, vertex1, vertex2,
+					index0, index1, index2,
+					shader,
+					binded_attributes,
+					target_texture,
+					delegate);
+				break;
+
 			case rasterization_algorithm_option::homogeneous:
 				rasterize_homogeneous(
 					vertex0, vertex1, vertex2,
@@ -405,6 +700,14 @@ namespace lantern
 		}
 	}
 
+	inline bool rasterizing_stage::is_pixel_inside_scissor_rectangle(unsigned int const x, unsigned int const y) const
+	{
+		return
+			!m_scissor_enabled ||
+			((x >= m_scissor_rectangle.from.x) && (x <= m_scissor_rectangle.to.x) &&
+			 (y >= m_scissor_rectangle.from.y) && (y <= m_scissor_rectangle.to.y));
+	}
+
 	// Traversal algorithms
 	//
 
@@ -441,42 +744,6 @@ namespace lantern
 		}
 	}
 
-	template<typename TAttr>
-	void rasterizing_stage::set_bind_points_values_from_barycentric(
-		std::vector<binded_mesh_attribute_info<TAttr>> const& binds,
-		unsigned int const index0, unsigned int const index1, unsigned int const index2,
-		float const b0, float const b1, float const b2,
-		float const z0_view_space_reciprocal, float const z1_view_space_reciprocal, float const z2_view_space_reciprocal)
-	{
-		size_t binds_count{binds.size()};
-		for (size_t i{0}; i < binds_count; ++i)
-		{
-			binded_mesh_attribute_info<TAttr> const& binded_attr = binds[i];
-			std::vector<TAttr> const& binded_attr_data = binded_attr.info.get_data();
-			std::vector<unsigned int> const& binded_attr_indices = binded_attr.info.get_indices();
-
-			TAttr const& value0 = binded_attr_data[binded_attr_indices[index0]];
-			TAttr const& value1 = binded_attr_data[binded_attr_indices[index1]];
-			TAttr const& value2 = binded_attr_data[binded_attr_indices[index2]];
-
-			if (binded_attr.info.get_interpolation_option() == attribute_interpolation_option::linear)
-			{
-				(*binded_attr.bind_point) = value0 * b0 + value1 * b1 + value2 * b2;
-			}
-			else if (binded_attr.info.get_interpolation_option() == attribute_interpolation_option::perspective_correct)
-			{
-				TAttr const value0_div_zview = value0 * z0_view_space_reciprocal;
-				TAttr const value1_div_zview = value1 * z1_view_space_reciprocal;
-				TAttr const value2_div_zview = value2 * z2_view_space_reciprocal;
-
-				float const zview_reciprocal_interpolated = z0_view_space_reciprocal * b0 + z1_view_space_reciprocal * b1 + z2_view_space_reciprocal * b2;
-				TAttr value_div_zview_interpolated = value0_div_zview * b0 + value1_div_zview * b1 + value2_div_zview * b2;
-
-				(*binded_attr.bind_point) = value_div_zview_interpolated * (1.0f / zview_reciprocal_interpolated);
-			}
-		}
-	}
-
 	template<typename TShader, typename TDelegate>
 	inline void rasterizing_stage::rasterize_traversal_aabb(
 		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
@@ -493,8 +760,13 @@ namespace lantern
 		line edge1{vertex2.x, vertex2.y, vertex1.x, vertex1.y};
 		line edge2{vertex0.x, vertex0.y, vertex2.x, vertex2.y};
 
-		// Calculate triangle area on screen and inverse it
-		float const triangle_area_inversed = 1.0f / triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, vertex2.x, vertex2.y);
+		// Sum of edge equations values is twice the triangle area and is the same for every point,
+		// every edge equation value is proportional to the weight of the opposite vertex
+		//
+		float const doubled_area_inversed{1.0f / edge0.at(vertex2.x, vertex2.y)};
+
+		// Attributes are gathered once per triangle, pixels only interpolate them
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
 
 		// Construct triangle's bounding box
 		aabb<vector2ui> bounding_box{
@@ -505,9 +777,20 @@ namespace lantern
 			static_cast<unsigned int>(std::max(std::max(vertex0.x, vertex1.x), vertex2.x)),
 			static_cast<unsigned int>(std::max(std::max(vertex0.y, vertex1.y), vertex2.y))}};
 
+		// Pixels range to visit: bounding box clipped by scissor rectangle
+		//
+		aabb<vector2ui> visited_box{bounding_box};
+		if (m_scissor_enabled)
+		{
+			visited_box.from.x = std::max(visited_box.from.x, m_scissor_rectangle.from.x);
+			visited_box.from.y = std::max(visited_box.from.y, m_scissor_rectangle.from.y);
+			visited_box.to.x = std::min(visited_box.to.x, m_scissor_rectangle.to.x);
+			visited_box.to.y = std::min(visited_box.to.y, m_scissor_rectangle.to.y);
+		}
+
 		// Iterate over bounding box and check if pixel is inside the triangle
 		//
-		for (unsigned int y{bounding_box.from.y}; y <= bounding_box.to.y; ++y)
+		for (unsigned int y{visited_box.from.y}; y <= visited_box.to.y; ++y)
 		{
 			float const pixel_center_y{static_cast<float>(y) + 0.5f};
 
@@ -517,7 +800,17 @@ namespace lantern
 			float edge1_equation_value{edge1.at(first_x_center, pixel_center_y)};
 			float edge2_equation_value{edge2.at(first_x_center, pixel_center_y)};
 
-			for (unsigned int x{bounding_box.from.x}; x <= bounding_box.to.x; ++x)
+			// Skip pixels on the left of scissor rectangle. Edge equations values are still accumulated
+			// from bounding box start to get exactly the same values as without scissor test
+			//
+			for (unsigned int x{bounding_box.from.x}; x < visited_box.from.x; ++x)
+			{
+				edge0_equation_value += edge0.a;
+				edge1_equation_value += edge1.a;
+				edge2_equation_value += edge2.a;
+			}
+
+			for (unsigned int x{visited_box.from.x}; x <= visited_box.to.x; ++x)
 			{
 				float const pixel_center_x{static_cast<float>(x) + 0.5f};
 
@@ -525,44 +818,22 @@ namespace lantern
 					is_point_on_positive_halfspace_top_left(edge1_equation_value, edge1.a, edge1.b) &&
 					is_point_on_positive_halfspace_top_left(edge2_equation_value, edge2.a, edge2.b))
 				{
-					float const area01{triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, pixel_center_x, pixel_center_y)};
-					float const area12{triangle_2d_area(vertex1.x, vertex1.y, vertex2.x, vertex2.y, pixel_center_x, pixel_center_y)};
-
-					// Calculate barycentric coordinates
+					// Calculate barycentric coordinates from edge equations values
 					//
-					float const b2{area01 * triangle_area_inversed};
-					float const b0{area12 * triangle_area_inversed};
+					float const b0{edge1_equation_value * doubled_area_inversed};
+					float const b2{edge0_equation_value * doubled_area_inversed};
 					float const b1{1.0f - b0 - b2};
 
 					// Process different attributes
 					//
 
-					set_bind_points_values_from_barycentric<color>(
-						binded_attributes.color_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<float>(
-						binded_attributes.float_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<vector2f>(
-						binded_attributes.vector2f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<vector3f>(
-						binded_attributes.vector3f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
+					m_attributes_interpolator.interpolate(b0, b1, b2, vertex0.w, vertex1.w, vertex2.w);
 					
+					// Screen space depth is an affine function of screen coordinates, so it is interpolated linearly
+					float const depth{vertex0.z * b0 + vertex1.z * b1 + vertex2.z * b2};
+
 					vector2ui pixel_coordinates{x, y};
-					vector3f sample_point{pixel_center_x, pixel_center_y, 0.0f};
+					vector3f sample_point{pixel_center_x, pixel_center_y, depth};
 					delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
 				}
 
@@ -594,13 +865,15 @@ namespace lantern
 		bool const edge1_normal_pointing_right = edge1.a > 0;
 		bool const edge2_normal_pointing_right = edge2.a > 0;
 
-		// Calculate triangle area on screen and inverse it
-		float const triangle_area_inversed = 1.0f / triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, vertex2.x, vertex2.y);
+		// Twice the triangle area, edge equations values divided by it are barycentric coordinates
+		float const doubled_area_inversed{1.0f / edge0.at(vertex2.x, vertex2.y)};
 
 		vector4f vertex0_sorted{vertex0};
 		vector4f vertex1_sorted{vertex1};
 		vector4f vertex2_sorted{vertex2};
 
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
+
 		// Sort vertices by y-coordinate
 		//
 
@@ -629,7 +902,7 @@ namespace lantern
 		float edge1_equation_value{edge1.at(current_pixel_center.x, current_pixel_center.y)};
 		float edge2_equation_value{edge2.at(current_pixel_center.x, current_pixel_center.y)};
 
-		while (current_pixel_center.y <= vertex2_sorted.y)
+		while ((current_pixel_center.y <= vertex2_sorted.y) && (!m_scissor_enabled || (current_pixel.y <= m_scissor_rectangle.to.y)))
 		{
 			// Backtracking
 			//
@@ -666,45 +939,26 @@ namespace lantern
 					is_point_on_positive_halfspace_top_left(edge1_equation_value, edge1.a, edge1.b) &&
 					is_point_on_positive_halfspace_top_left(edge2_equation_value, edge2.a, edge2.b))
 				{
-					float const area01{triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, current_pixel_center.x, current_pixel_center.y)};
-					float const area12{triangle_2d_area(vertex1.x, vertex1.y, vertex2.x, vertex2.y, current_pixel_center.x, current_pixel_center.y)};
-
-					// Calculate barycentric coordinates
+					// Calculate barycentric coordinates from edge equations values
 					//
-					float const b2{area01 * triangle_area_inversed};
-					float const b0{area12 * triangle_area_inversed};
+					float const b0{edge1_equation_value * doubled_area_inversed};
+					float const b2{edge0_equation_value * doubled_area_inversed};
 					float const b1{1.0f - b0 - b2};
 
 					// Process different attributes
 					//
 
-					set_bind_points_values_from_barycentric<color>(
-						binded_attributes.color_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<float>(
-						binded_attributes.float_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
+					m_attributes_interpolator.interpolate(b0, b1, b2, vertex0.w, vertex1.w, vertex2.w);
 
-					set_bind_points_values_from_barycentric<vector2f>(
-						binded_attributes.vector2f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<vector3f>(
-						binded_attributes.vector3f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
+					// Screen space depth is an affine function of screen coordinates, so it is interpolated linearly
+					float const depth{vertex0.z * b0 + vertex1.z * b1 + vertex2.z * b2};
 
-					vector2ui pixel_coordinates{current_pixel.x, current_pixel.y};
-					vector3f sample_point{current_pixel_center.x, current_pixel_center.y, 0.0f};
-					delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+					if (is_pixel_inside_scissor_rectangle(current_pixel.x, current_pixel.y))
+					{
+						vector2ui pixel_coordinates{current_pixel.x, current_pixel.y};
+						vector3f sample_point{current_pixel_center.x, current_pixel_center.y, depth};
+						delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+					}
 
 				}
 
@@ -745,8 +999,10 @@ namespace lantern
 		bool const edge1_normal_pointing_right = edge1.a > 0;
 		bool const edge2_normal_pointing_right = edge2.a > 0;
 
-		// Calculate triangle area on screen and inverse it
-		float const triangle_area_inversed = 1.0f / triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, vertex2.x, vertex2.y);
+		// Twice the triangle area, edge equations values divided by it are barycentric coordinates
+		float const doubled_area_inversed{1.0f / edge0.at(vertex2.x, vertex2.y)};
+
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
 
 		// Sort vertices by y-coordinate
 		//
@@ -786,7 +1042,7 @@ namespace lantern
 		// Index of the pixel we should move at when reach a pixel outside of a triangle from one side
 		unsigned int zigzag_x_index{current_pixel.x - 1};
 
-		while (current_pixel_center.y <= vertex2_sorted.y)
+		while ((current_pixel_center.y <= vertex2_sorted.y) && (!m_scissor_enabled || (current_pixel.y <= m_scissor_rectangle.to.y)))
 		{
 			// Moving along the scanline
 			//
@@ -863,45 +1119,26 @@ namespace lantern
 					is_point_on_positive_halfspace_top_left(edge1_equation_value, edge1.a, edge1.b) &&
 					is_point_on_positive_halfspace_top_left(edge2_equation_value, edge2.a, edge2.b))
 				{
-					float const area01{triangle_2d_area(vertex0.x, vertex0.y, vertex1.x, vertex1.y, current_pixel_center.x, current_pixel_center.y)};
-					float const area12{triangle_2d_area(vertex1.x, vertex1.y, vertex2.x, vertex2.y, current_pixel_center.x, current_pixel_center.y)};
-
-					// Calculate barycentric coordinates
+					// Calculate barycentric coordinates from edge equations values
 					//
-					float const b2{area01 * triangle_area_inversed};
-					float const b0{area12 * triangle_area_inversed};
+					float const b0{edge1_equation_value * doubled_area_inversed};
+					float const b2{edge0_equation_value * doubled_area_inversed};
 					float const b1{1.0f - b0 - b2};
 
 					// Process different attributes
 					//
 
-					set_bind_points_values_from_barycentric<color>(
-						binded_attributes.color_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<float>(
-						binded_attributes.float_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
-
-					set_bind_points_values_from_barycentric<vector2f>(
-						binded_attributes.vector2f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
+					m_attributes_interpolator.interpolate(b0, b1, b2, vertex0.w, vertex1.w, vertex2.w);
 
-					set_bind_points_values_from_barycentric<vector3f>(
-						binded_attributes.vector3f_attributes,
-						index0, index1, index2,
-						b0, b1, b2,
-						vertex0.w, vertex1.w, vertex2.w);
+					// Screen space depth is an affine function of screen coordinates, so it is interpolated linearly
+					float const depth{vertex0.z * b0 + vertex1.z * b1 + vertex2.z * b2};
 
-					vector2ui const pixel_coordinates{current_pixel.x, current_pixel.y};
-					vector3f const sample_point{current_pixel_center.x, current_pixel_center.y, 0.0f};
-					delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+					if (is_pixel_inside_scissor_rectangle(current_pixel.x, current_pixel.y))
+					{
+						vector2ui const pixel_coordinates{current_pixel.x, current_pixel.y};
+						vector3f const sample_point{current_pixel_center.x, current_pixel_center.y, depth};
+						delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+					}
 				}
 
 				if (is_moving_right)
@@ -937,6 +1174,497 @@ namespace lantern
 		}
 	}
 
+	template<typename TShader, typename TDelegate>
+	void rasterizing_stage::rasterize_traversal_aabb_fixed_point(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		binded_mesh_attributes const& binded_attributes,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		// Snap vertices to sub-pixel grid
+		//
+
+		int64_t const x0{fixed_point_edge::snap(vertex0.x)};
+		int64_t const y0{fixed_point_edge::snap(vertex0.y)};
+		int64_t const x1{fixed_point_edge::snap(vertex1.x)};
+		int64_t const y1{fixed_point_edge::snap(vertex1.y)};
+		int64_t const x2{fixed_point_edge::snap(vertex2.x)};
+		int64_t const y2{fixed_point_edge::snap(vertex2.y)};
+
+		// Construct edges the same way floating point traversal does
+		//
+
+		fixed_point_edge const edge0{x1, y1, x0, y0};
+		fixed_point_edge const edge1{x2, y2, x1, y1};
+		fixed_point_edge const edge2{x0, y0, x2, y2};
+
+		// Sum of unbiased edge functions values is twice the triangle area and is the same for every point.
+		// Triangles with the other orientation or without area are not rasterized
+		//
+		int64_t const doubled_area{edge0.unbiased(edge0.at_pixel_center(0, 0)) + edge1.unbiased(edge1.at_pixel_center(0, 0)) + edge2.unbiased(edge2.at_pixel_center(0, 0))};
+		if (doubled_area <= 0)
+		{
+			return;
+		}
+
+		float const doubled_area_inversed{1.0f / static_cast<float>(doubled_area)};
+
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
+
+		// Construct triangle's bounding box, clipped by texture and scissor rectangle
+		//
+
+		int64_t from_x{std::min(std::min(x0, x1), x2) >> fixed_point_edge::SUBPIXEL_BITS};
+		int64_t from_y{std::min(std::min(y0, y1), y2) >> fixed_point_edge::SUBPIXEL_BITS};
+		int64_t to_x{std::max(std::max(x0, x1), x2) >> fixed_point_edge::SUBPIXEL_BITS};
+		int64_t to_y{std::max(std::max(y0, y1), y2) >> fixed_point_edge::SUBPIXEL_BITS};
+
+		from_x = std::max<int64_t>(from_x, 0);
+		from_y = std::max<int64_t>(from_y, 0);
+		to_x = std::min<int64_t>(to_x, static_cast<int64_t>(target_texture.get_width()) - 1);
+		to_y = std::min<int64_t>(to_y, static_cast<int64_t>(target_texture.get_height()) - 1);
+
+		if (m_scissor_enabled)
+		{
+			from_x = std::max<int64_t>(from_x, m_scissor_rectangle.from.x);
+			from_y = std::max<int64_t>(from_y, m_scissor_rectangle.from.y);
+			to_x = std::min<int64_t>(to_x, m_scissor_rectangle.to.x);
+			to_y = std::min<int64_t>(to_y, m_scissor_rectangle.to.y);
+		}
+
+		if ((from_x > to_x) || (from_y > to_y))
+		{
+			return;
+		}
+
+		// Iterate over bounding box, inner loop does only integer additions and a sign test
+		//
+
+		int64_t edge0_row_value{edge0.at_pixel_center(from_x, from_y)};
+		int64_t edge1_row_value{edge1.at_pixel_center(from_x, from_y)};
+		int64_t edge2_row_value{edge2.at_pixel_center(from_x, from_y)};
+
+		for (int64_t y{from_y}; y <= to_y; ++y)
+		{
+			int64_t edge0_value{edge0_row_value};
+			int64_t edge1_value{edge1_row_value};
+			int64_t edge2_value{edge2_row_value};
+
+			for (int64_t x{from_x}; x <= to_x; ++x)
+			{
+				if ((edge0_value | edge1_value | edge2_value) >= 0)
+				{
+					process_fixed_point_covered_pixel(
+						x, y,
+						edge1.unbiased(edge1_value), edge2.unbiased(edge2_value),
+						doubled_area_inversed,
+						vertex0, vertex1, vertex2,
+						shader,
+						target_texture,
+						delegate);
+				}
+
+				edge0_value += edge0.step_x;
+				edge1_value += edge1.step_x;
+				edge2_value += edge2.step_x;
+			}
+
+			edge0_row_value += edge0.step_y;
+			edge1_row_value += edge1.step_y;
+			edge2_row_value += edge2.step_y;
+		}
+	}
+
+	template<typename TShader, typename TDelegate>
+	inline void rasterizing_stage::process_fixed_point_covered_pixel(
+		int64_t const x, int64_t const y,
+		int64_t const edge1_value, int64_t const edge2_value,
+		float const doubled_area_inversed,
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		TShader& shader,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		// Calculate barycentric coordinates: every edge function is proportional to the area of a triangle
+		// made of the edge and the point, which is the weight of the opposite vertex
+		//
+		float const b0{static_cast<float>(edge1_value) * doubled_area_inversed};
+		float const b1{static_cast<float>(edge2_value) * doubled_area_inversed};
+		float const b2{1.0f - b0 - b1};
+
+		// Process different attributes
+		//
+		m_attributes_interpolator.interpolate(b0, b1, b2, vertex0.w, vertex1.w, vertex2.w);
+
+		float const depth{vertex0.z * b0 + vertex1.z * b1 + vertex2.z * b2};
+
+		vector2ui const pixel_coordinates{static_cast<unsigned int>(x), static_cast<unsigned int>(y)};
+		vector3f const sample_point{x + 0.5f, y + 0.5f, depth};
+		delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+	}
+
+	inline rasterizing_stage::block_coverage_option rasterizing_stage::get_block_coverage(
+		fixed_point_edge const& edge0, fixed_point_edge const& edge1, fixed_point_edge const& edge2,
+		int64_t const x, int64_t const y, int64_t const size) const
+	{
+		bool full{true};
+
+		fixed_point_edge const* edges[3]{&edge0, &edge1, &edge2};
+		for (fixed_point_edge const* edge : edges)
+		{
+			int64_t const top_left_value{edge->at_pixel_center(x, y)};
+			int64_t const x_change{edge->step_x * (size - 1)};
+			int64_t const y_change{edge->step_y * (size - 1)};
+
+			int64_t const max_value{top_left_value + std::max<int64_t>(x_change, 0) + std::max<int64_t>(y_change, 0)};
+			if (max_value < 0)
+			{
+				return block_coverage_option::none;
+			}
+
+			int64_t const min_value{top_left_value + std::min<int64_t>(x_change, 0) + std::min<int64_t>(y_change, 0)};
+			if (min_value < 0)
+			{
+				full = false;
+			}
+		}
+
+		return full ? block_coverage_option::full : block_coverage_option::partial;
+	}
+
+	template<typename TShader, typename TDelegate>
+	void rasterizing_stage::rasterize_traversal_hierarchical(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		binded_mesh_attributes const& binded_attributes,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		// Triangle setup is the same as in fixed point traversal
+		//
+
+		int64_t const x0{fixed_point_edge::snap(vertex0.x)};
+		int64_t const y0{fixed_point_edge::snap(vertex0.y)};
+		int64_t const x1{fixed_point_edge::snap(vertex1.x)};
+		int64_t const y1{fixed_point_edge::snap(vertex1.y)};
+		int64_t const x2{fixed_point_edge::snap(vertex2.x)};
+		int64_t const y2{fixed_point_edge::snap(vertex2.y)};
+
+		fixed_point_edge const edge0{x1, y1, x0, y0};
+		fixed_point_edge const edge1{x2, y2, x1, y1};
+		fixed_point_edge const edge2{x0, y0, x2, y2};
+
+		int64_t const doubled_area{edge0.unbiased(edge0.at_pixel_center(0, 0)) + edge1.unbiased(edge1.at_pixel_center(0, 0)) + edge2.unbiased(edge2.at_pixel_center(0, 0))};
+		if (doubled_area <= 0)
+		{
+			return;
+		}
+
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
+
+		float const doubled_area_inversed{1.0f / static_cast<float>(doubled_area)};
+
+		int64_t from_x{std::max<int64_t>(std::min(std::min(x0, x1), x2) >> fixed_point_edge::SUBPIXEL_BITS, 0)};
+		int64_t from_y{std::max<int64_t>(std::min(std::min(y0, y1), y2) >> fixed_point_edge::SUBPIXEL_BITS, 0)};
+		int64_t to_x{std::min<int64_t>(std::max(std::max(x0, x1), x2) >> fixed_point_edge::SUBPIXEL_BITS, static_cast<int64_t>(target_texture.get_width()) - 1)};
+		int64_t to_y{std::min<int64_t>(std::max(std::max(y0, y1), y2) >> fixed_point_edge::SUBPIXEL_BITS, static_cast<int64_t>(target_texture.get_height()) - 1)};
+
+		if (m_scissor_enabled)
+		{
+			from_x = std::max<int64_t>(from_x, m_scissor_rectangle.from.x);
+			from_y = std::max<int64_t>(from_y, m_scissor_rectangle.from.y);
+			to_x = std::min<int64_t>(to_x, m_scissor_rectangle.to.x);
+			to_y = std::min<int64_t>(to_y, m_scissor_rectangle.to.y);
+		}
+
+		if ((from_x > to_x) || (from_y > to_y))
+		{
+			return;
+		}
+
+		// Iterates over pixels of a block that are inside the bounding box, testing them against the triangle if needed
+		//
+		auto process_block_pixels = [&](int64_t const block_x, int64_t const block_y, int64_t const block_size, bool const test_pixels)
+		{
+			int64_t const pixels_from_x{std::max(block_x, from_x)};
+			int64_t const pixels_from_y{std::max(block_y, from_y)};
+			int64_t const pixels_to_x{std::min(block_x + block_size - 1, to_x)};
+			int64_t const pixels_to_y{std::min(block_y + block_size - 1, to_y)};
+
+			int64_t edge0_row_value{edge0.at_pixel_center(pixels_from_x, pixels_from_y)};
+			int64_t edge1_row_value{edge1.at_pixel_center(pixels_from_x, pixels_from_y)};
+			int64_t edge2_row_value{edge2.at_pixel_center(pixels_from_x, pixels_from_y)};
+
+			for (int64_t y{pixels_from_y}; y <= pixels_to_y; ++y)
+			{
+				int64_t edge0_value{edge0_row_value};
+				int64_t edge1_value{edge1_row_value};
+				int64_t edge2_value{edge2_row_value};
+
+				for (int64_t x{pixels_from_x}; x <= pixels_to_x; ++x)
+				{
+					if (!test_pixels || ((edge0_value | edge1_value | edge2_value) >= 0))
+					{
+						process_fixed_point_covered_pixel(
+							x, y,
+							edge1.unbiased(edge1_value), edge2.unbiased(edge2_value),
+							doubled_area_inversed,
+							vertex0, vertex1, vertex2,
+							shader,
+							target_texture,
+							delegate);
+					}
+
+					edge0_value += edge0.step_x;
+					edge1_value += edge1.step_x;
+					edge2_value += edge2.step_x;
+				}
+
+				edge0_row_value += edge0.step_y;
+				edge1_row_value += edge1.step_y;
+				edge2_row_value += edge2.step_y;
+			}
+		};
+
+		int64_t const tile_size{16};
+		int64_t const block_size{4};
+
+		// Traverse tiles aligned to the tiles grid, then blocks inside partially covered tiles
+		//
+		for (int64_t tile_y{from_y & ~(tile_size - 1)}; tile_y <= to_y; tile_y += tile_size)
+		{
+			for (int64_t tile_x{from_x & ~(tile_size - 1)}; tile_x <= to_x; tile_x += tile_size)
+			{
+				block_coverage_option const tile_coverage{get_block_coverage(edge0, edge1, edge2, tile_x, tile_y, tile_size)};
+
+				if (tile_coverage == block_coverage_option::none)
+				{
+					continue;
+				}
+
+				if (tile_coverage == block_coverage_option::full)
+				{
+					process_block_pixels(tile_x, tile_y, tile_size, false);
+					continue;
+				}
+
+				int64_t const blocks_from_x{std::max(tile_x, from_x & ~(block_size - 1))};
+				int64_t const blocks_from_y{std::max(tile_y, from_y & ~(block_size - 1))};
+				int64_t const blocks_to_x{std::min(tile_x + tile_size - 1, to_x)};
+				int64_t const blocks_to_y{std::min(tile_y + tile_size - 1, to_y)};
+
+				for (int64_t block_y{blocks_from_y}; block_y <= blocks_to_y; block_y += block_size)
+				{
+					for (int64_t block_x{blocks_from_x}; block_x <= blocks_to_x; block_x += block_size)
+					{
+						block_coverage_option const block_coverage{get_block_coverage(edge0, edge1, edge2, block_x, block_y, block_size)};
+
+						if (block_coverage != block_coverage_option::none)
+						{
+							process_block_pixels(block_x, block_y, block_size, block_coverage == block_coverage_option::partial);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template<typename TShader, typename TDelegate>
+	void rasterizing_stage::rasterize_traversal_aabb_simd(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		binded_mesh_attributes const& binded_attributes,
+		texture& target_texture,
+		TDelegate& delegate)
+	{
+		// Construct edges equations, considering that top left point is origin
+		//
+
+		line const edge0{vertex1.x, vertex1.y, vertex0.x, vertex0.y};
+		line const edge1{vertex2.x, vertex2.y, vertex1.x, vertex1.y};
+		line const edge2{vertex0.x, vertex0.y, vertex2.x, vertex2.y};
+
+		// Sum of edge equations values is twice the triangle area and is the same for every point
+		//
+		float const doubled_area{edge0.at(vertex2.x, vertex2.y)};
+		if (doubled_area < FLOAT_EPSILON)
+		{
+			return;
+		}
+
+		float const doubled_area_inversed{1.0f / doubled_area};
+
+		m_attributes_interpolator.setup(binded_attributes, index0, index1, index2);
+
+		// Top-left rule turns into a threshold: pixel centers lying on top and left edges are covered,
+		// so pixel is covered if edge equation value is greater than the threshold
+		//
+		float const edge0_threshold{is_point_on_positive_halfspace_top_left(0.0f, edge0.a, edge0.b) ? -FLOAT_EPSILON : FLOAT_EPSILON};
+		float const edge1_threshold{is_point_on_positive_halfspace_top_left(0.0f, edge1.a, edge1.b) ? -FLOAT_EPSILON : FLOAT_EPSILON};
+		float const edge2_threshold{is_point_on_positive_halfspace_top_left(0.0f, edge2.a, edge2.b) ? -FLOAT_EPSILON : FLOAT_EPSILON};
+
+		// Construct triangle's bounding box, clipped by texture and scissor rectangle
+		//
+
+		aabb<vector2ui> box{
+			vector2ui{
+			static_cast<unsigned int>(std::max(std::min(std::min(vertex0.x, vertex1.x), vertex2.x), 0.0f)),
+			static_cast<unsigned int>(std::max(std::min(std::min(vertex0.y, vertex1.y), vertex2.y), 0.0f))},
+			vector2ui{
+			std::min(static_cast<unsigned int>(std::max(std::max(std::max(vertex0.x, vertex1.x), vertex2.x), 0.0f)), target_texture.get_width() - 1),
+			std::min(static_cast<unsigned int>(std::max(std::max(std::max(vertex0.y, vertex1.y), vertex2.y), 0.0f)), target_texture.get_height() - 1)}};
+
+		// Blocks grid starts at the left side of bounding box even with scissor test enabled,
+		// so that edge equations values are exactly the same as without scissor test
+		//
+		unsigned int const blocks_from_x{box.from.x};
+
+		if (m_scissor_enabled)
+		{
+			box.from.x = std::max(box.from.x, m_scissor_rectangle.from.x);
+			box.from.y = std::max(box.from.y, m_scissor_rectangle.from.y);
+			box.to.x = std::min(box.to.x, m_scissor_rectangle.to.x);
+			box.to.y = std::min(box.to.y, m_scissor_rectangle.to.y);
+		}
+
+		if ((box.from.x > box.to.x) || (box.from.y > box.to.y))
+		{
+			return;
+		}
+
+		unsigned int const block_size{4};
+
+		// Edge equations values in four pixels of a block
+		//
+		float edge0_values[block_size];
+		float edge1_values[block_size];
+		float edge2_values[block_size];
+
+#ifdef LANTERN_RASTERIZING_SSE2
+		__m128 const lanes_offsets{_mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f)};
+
+		__m128 const edge0_a{_mm_set1_ps(edge0.a)};
+		__m128 const edge1_a{_mm_set1_ps(edge1.a)};
+		__m128 const edge2_a{_mm_set1_ps(edge2.a)};
+
+		__m128 const edge0_block_step{_mm_set1_ps(edge0.a * block_size)};
+		__m128 const edge1_block_step{_mm_set1_ps(edge1.a * block_size)};
+		__m128 const edge2_block_step{_mm_set1_ps(edge2.a * block_size)};
+
+		__m128 const edge0_threshold_v{_mm_set1_ps(edge0_threshold)};
+		__m128 const edge1_threshold_v{_mm_set1_ps(edge1_threshold)};
+		__m128 const edge2_threshold_v{_mm_set1_ps(edge2_threshold)};
+#endif
+
+		for (unsigned int y{box.from.y}; y <= box.to.y; ++y)
+		{
+			float const pixel_center_y{static_cast<float>(y) + 0.5f};
+			float const first_x_center{static_cast<float>(blocks_from_x) + 0.5f};
+
+#ifdef LANTERN_RASTERIZING_SSE2
+			__m128 edge0_v{_mm_add_ps(_mm_set1_ps(edge0.at(first_x_center, pixel_center_y)), _mm_mul_ps(lanes_offsets, edge0_a))};
+			__m128 edge1_v{_mm_add_ps(_mm_set1_ps(edge1.at(first_x_center, pixel_center_y)), _mm_mul_ps(lanes_offsets, edge1_a))};
+			__m128 edge2_v{_mm_add_ps(_mm_set1_ps(edge2.at(first_x_center, pixel_center_y)), _mm_mul_ps(lanes_offsets, edge2_a))};
+#else
+			for (unsigned int lane{0}; lane < block_size; ++lane)
+			{
+				edge0_values[lane] = edge0.at(first_x_center + lane, pixel_center_y);
+				edge1_values[lane] = edge1.at(first_x_center + lane, pixel_center_y);
+				edge2_values[lane] = edge2.at(first_x_center + lane, pixel_center_y);
+			}
+#endif
+
+			for (unsigned int block_x{blocks_from_x}; block_x <= box.to.x; block_x += block_size)
+			{
+				// Calculate coverage mask: one bit per pixel, lowest bit is the leftmost pixel
+				//
+
+#ifdef LANTERN_RASTERIZING_SSE2
+				__m128 const inside{
+					_mm_and_ps(
+						_mm_and_ps(_mm_cmpgt_ps(edge0_v, edge0_threshold_v), _mm_cmpgt_ps(edge1_v, edge1_threshold_v)),
+						_mm_cmpgt_ps(edge2_v, edge2_threshold_v))};
+
+				unsigned int mask{static_cast<unsigned int>(_mm_movemask_ps(inside))};
+#else
+				unsigned int mask{0};
+				for (unsigned int lane{0}; lane < block_size; ++lane)
+				{
+					if ((edge0_values[lane] > edge0_threshold) && (edge1_values[lane] > edge1_threshold) && (edge2_values[lane] > edge2_threshold))
+					{
+						mask |= 1 << lane;
+					}
+				}
+#endif
+
+				// First and last blocks may go beyond the box
+				//
+				if (block_x < box.from.x)
+				{
+					mask &= ~0u << std::min(box.from.x - block_x, block_size);
+				}
+
+				unsigned int const pixels_left{box.to.x - block_x + 1};
+				if (pixels_left < block_size)
+				{
+					mask &= (1 << pixels_left) - 1;
+				}
+
+				if (mask != 0)
+				{
+#ifdef LANTERN_RASTERIZING_SSE2
+					_mm_storeu_ps(edge0_values, edge0_v);
+					_mm_storeu_ps(edge1_values, edge1_v);
+					_mm_storeu_ps(edge2_values, edge2_v);
+#endif
+
+					for (unsigned int lane{0}; lane < block_size; ++lane)
+					{
+						if ((mask & (1 << lane)) == 0)
+						{
+							continue;
+						}
+
+						// Every edge equation value is proportional to the weight of the opposite vertex
+						//
+						float const b0{edge1_values[lane] * doubled_area_inversed};
+						float const b1{edge2_values[lane] * doubled_area_inversed};
+						float const b2{1.0f - b0 - b1};
+
+						// Process different attributes
+						//
+						m_attributes_interpolator.interpolate(b0, b1, b2, vertex0.w, vertex1.w, vertex2.w);
+
+						float const depth{vertex0.z * b0 + vertex1.z * b1 + vertex2.z * b2};
+
+						unsigned int const x{block_x + lane};
+
+						vector2ui const pixel_coordinates{x, y};
+						vector3f const sample_point{x + 0.5f, pixel_center_y, depth};
+						delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+					}
+				}
+
+#ifdef LANTERN_RASTERIZING_SSE2
+				edge0_v = _mm_add_ps(edge0_v, edge0_block_step);
+				edge1_v = _mm_add_ps(edge1_v, edge1_block_step);
+				edge2_v = _mm_add_ps(edge2_v, edge2_block_step);
+#else
+				for (unsigned int lane{0}; lane < block_size; ++lane)
+				{
+					edge0_values[lane] += edge0.a * block_size;
+					edge1_values[lane] += edge1.a * block_size;
+					edge2_values[lane] += edge2.a * block_size;
+				}
+#endif
+			}
+		}
+	}
+
 	// Homogeneous algorithm
 	//
 
@@ -950,12 +1678,9 @@ namespace lantern
 		for (size_t i = 0; i < binds.size(); ++i)
 		{
 			binded_mesh_attribute_info<TAttr> const& binded_attr = binds[i];
-			std::vector<TAttr> const& binded_attr_data = binded_attr.info.get_data();
-			std::vector<unsigned int> const& binded_attr_indices = binded_attr.info.get_indices();
-
-			TAttr const& value0 = binded_attr_data[binded_attr_indices[index0]];
-			TAttr const& value1 = binded_attr_data[binded_attr_indices[index1]];
-			TAttr const& value2 = binded_attr_data[binded_attr_indices[index2]];
+			TAttr const value0{binded_attr.get_vertex_value(index0)};
+			TAttr const value1{binded_attr.get_vertex_value(index1)};
+			TAttr const value2{binded_attr.get_vertex_value(index2)};
 
 			coefficients_storage[i] = vector3<TAttr>{value0, value1, value2} *vertices_matrix_inversed;
 		}
@@ -1024,13 +1749,26 @@ namespace lantern
 		//
 		vector3f const one_div_w_abc{vector3f{1.0f, 1.0f, 1.0f} *m_inversed};
 
+		// z/w function coefficients. Clip space z divided by w is a screen space depth,
+		// so unlike other attributes it is used as is, without multiplying by w
+		//
+		vector3f const z_div_w_abc{vector3f{vertex0.z, vertex1.z, vertex2.z} *m_inversed};
+
 		// Calculate attributes coefficients
 		//
 
-		std::vector<vector3<color>> color_attrs_abc{binded_attributes.color_attributes.size()};
-		std::vector<vector3<float>> float_attrs_abc{binded_attributes.float_attributes.size()};
-		std::vector<vector3<vector2f>> vector2f_attrs_abc{binded_attributes.vector2f_attributes.size()};
-		std::vector<vector3<vector3f>> vector3f_attrs_abc{binded_attributes.vector3f_attributes.size()};
+		// Storages are owned by the stage and reused between triangles, so resizing doesn't allocate memory
+		//
+
+		std::vector<vector3<color>>& color_attrs_abc = m_color_attributes_coefficients;
+		std::vector<vector3<float>>& float_attrs_abc = m_float_attributes_coefficients;
+		std::vector<vector3<vector2f>>& vector2f_attrs_abc = m_vector2f_attributes_coefficients;
+		std::vector<vector3<vector3f>>& vector3f_attrs_abc = m_vector3f_attributes_coefficients;
+
+		color_attrs_abc.resize(binded_attributes.color_attributes.size());
+		float_attrs_abc.resize(binded_attributes.float_attributes.size());
+		vector2f_attrs_abc.resize(binded_attributes.vector2f_attributes.size());
+		vector3f_attrs_abc.resize(binded_attributes.vector3f_attributes.size());
 
 		save_edges_coefficients<color>(
 			binded_attributes.color_attributes,
@@ -1094,7 +1832,18 @@ namespace lantern
 			bounding_box.to.y = static_cast<unsigned int>(std::max(std::max(vertex0_screen_y, vertex1_screen_y), vertex2_screen_y));
 		}
 
-		for (unsigned int y{bounding_box.from.y}; y <= bounding_box.to.y; ++y)
+		// Pixels range to visit: bounding box clipped by scissor rectangle
+		//
+		aabb<vector2ui> visited_box{bounding_box};
+		if (m_scissor_enabled)
+		{
+			visited_box.from.x = std::max(visited_box.from.x, m_scissor_rectangle.from.x);
+			visited_box.from.y = std::max(visited_box.from.y, m_scissor_rectangle.from.y);
+			visited_box.to.x = std::min(visited_box.to.x, m_scissor_rectangle.to.x);
+			visited_box.to.y = std::min(visited_box.to.y, m_scissor_rectangle.to.y);
+		}
+
+		for (unsigned int y{visited_box.from.y}; y <= visited_box.to.y; ++y)
 		{
 			vector2f const first_pixel_center{bounding_box.from.x + 0.5f, y + 0.5f};
 
@@ -1104,7 +1853,17 @@ namespace lantern
 
 			float one_div_w_v{one_div_w_abc.x * first_pixel_center.x + one_div_w_abc.y * first_pixel_center.y + one_div_w_abc.z};
 
-			for (unsigned int x{bounding_box.from.x}; x <= bounding_box.to.x; ++x)
+			// Skip pixels on the left of scissor rectangle, accumulating values the same way as without scissor test
+			//
+			for (unsigned int x{bounding_box.from.x}; x < visited_box.from.x; ++x)
+			{
+				edge0_v += edge0_abc.x;
+				edge1_v += edge1_abc.x;
+				edge2_v += edge2_abc.x;
+				one_div_w_v += one_div_w_abc.x;
+			}
+
+			for (unsigned int x{visited_box.from.x}; x <= visited_box.to.x; ++x)
 			{
 				vector2ui const p{x, y};
 				vector2f const pc{x + 0.5f, y + 0.5f};
@@ -1148,8 +1907,10 @@ namespace lantern
 						pc,
 						w_value);
 
+					float const depth{z_div_w_abc.x * pc.x + z_div_w_abc.y * pc.y + z_div_w_abc.z};
+
 					vector2ui const pixel_coordinates{p.x, p.y};
-					vector3f const sample_point{pc.x, pc.y, 0.0f};
+					vector3f const sample_point{pc.x, pc.y, depth};
 					delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
 				}
 
@@ -1196,12 +1957,9 @@ namespace lantern
 		for (size_t i{0}; i < binds_count; ++i)
 		{
 			binded_mesh_attribute_info<TAttr> const& binded_attr = binds[i];
-			std::vector<TAttr> const& binded_attr_data = binded_attr.info.get_data();
-			std::vector<unsigned int> const& binded_attr_indices = binded_attr.info.get_indices();
-
-			TAttr const& top_value = binded_attr_data[binded_attr_indices[top_vertex_index]];
-			TAttr const& left_value = binded_attr_data[binded_attr_indices[left_vertex_index]];
-			TAttr const& right_value = binded_attr_data[binded_attr_indices[right_vertex_index]];
+			TAttr const top_value{binded_attr.get_vertex_value(top_vertex_index)};
+			TAttr const left_value{binded_attr.get_vertex_value(left_vertex_index)};
+			TAttr const right_value{binded_attr.get_vertex_value(right_vertex_index)};
 
 			if (binded_attr.info.get_interpolation_option() == attribute_interpolation_option::linear)
 			{
@@ -1378,8 +2136,8 @@ namespace lantern
 			// Vertices that lie on separating line
 			// We need two different vectors because we do not calculate interpolated values of z and w and use just distance offset
 			//
-			vector4f separator_vertex_for_top_triangle{intersection.x, intersection.y, vertex2.z, vertex2.w};
-			vector4f separator_vertex_for_bottom_triangle{intersection.x, intersection.y, vertex0.z, vertex0.w};
+			vector4f separator_vertex_for_top_triangle{intersection.x, intersection.y, vertex2_sorted.z, vertex2_sorted.w};
+			vector4f separator_vertex_for_bottom_triangle{intersection.x, intersection.y, vertex0_sorted.z, vertex0_sorted.w};
 
 			// Draw top triangle
 			rasterize_inverse_slope_top_or_bottom_triangle(
@@ -1484,24 +2242,33 @@ namespace lantern
 		int const first_y{static_cast<int>(next_y_pixel_center)};
 		int const last_y{static_cast<int>(last_y_pixel_center) + y_order_coefficient};
 
-		// Initialize attributes storage
+		// Initialize attributes storage. Storages are owned by the stage and reused between triangles,
+		// so resizing doesn't allocate memory
 		//
 
 		size_t color_binds_count{binded_attributes.color_attributes.size()};
-		std::vector<color> left_color_attributes(color_binds_count);
-		std::vector<color> right_color_attributes(color_binds_count);
+		std::vector<color>& left_color_attributes = m_left_color_attributes;
+		std::vector<color>& right_color_attributes = m_right_color_attributes;
+		left_color_attributes.resize(color_binds_count);
+		right_color_attributes.resize(color_binds_count);
 
 		size_t float_binds_count{binded_attributes.float_attributes.size()};
-		std::vector<float> left_float_attributes(float_binds_count);
-		std::vector<float> right_float_attributes(float_binds_count);
+		std::vector<float>& left_float_attributes = m_left_float_attributes;
+		std::vector<float>& right_float_attributes = m_right_float_attributes;
+		left_float_attributes.resize(float_binds_count);
+		right_float_attributes.resize(float_binds_count);
 
 		size_t vector2f_binds_count{binded_attributes.vector2f_attributes.size()};
-		std::vector<vector2f> left_vector2f_attributes(vector2f_binds_count);
-		std::vector<vector2f> right_vector2f_attributes(vector2f_binds_count);
+		std::vector<vector2f>& left_vector2f_attributes = m_left_vector2f_attributes;
+		std::vector<vector2f>& right_vector2f_attributes = m_right_vector2f_attributes;
+		left_vector2f_attributes.resize(vector2f_binds_count);
+		right_vector2f_attributes.resize(vector2f_binds_count);
 
 		size_t vector3f_binds_count{binded_attributes.vector3f_attributes.size()};
-		std::vector<vector3f> left_vector3f_attributes(vector3f_binds_count);
-		std::vector<vector3f> right_vector3f_attributes(vector3f_binds_count);
+		std::vector<vector3f>& left_vector3f_attributes = m_left_vector3f_attributes;
+		std::vector<vector3f>& right_vector3f_attributes = m_right_vector3f_attributes;
+		left_vector3f_attributes.resize(vector3f_binds_count);
+		right_vector3f_attributes.resize(vector3f_binds_count);
 
 		// For each scanline
 		//
@@ -1571,6 +2338,11 @@ namespace lantern
 			float const left_zview_reciprocal = (1.0f - current_left_distance_normalized) * vertex0.w + current_left_distance_normalized * vertex1.w;
 			float const right_zview_reciprocal = (1.0f - current_right_distance_normalized) * vertex0.w + current_right_distance_normalized * vertex2.w;
 
+			// Calculate endpoints screen space depth, it's interpolated linearly
+			//
+			float const left_depth = (1.0f - current_left_distance_normalized) * vertex0.z + current_left_distance_normalized * vertex1.z;
+			float const right_depth = (1.0f - current_right_distance_normalized) * vertex0.z + current_right_distance_normalized * vertex2.z;
+
 			for (int x{first_x}; x <= last_x; ++x)
 			{
 				// Calculate attributes values on current pixel center
@@ -1600,9 +2372,14 @@ namespace lantern
 					current_scanline_distance_normalized,
 					left_zview_reciprocal, right_zview_reciprocal);
 
-				vector2ui const pixel_coordinates{static_cast<unsigned int>(x), static_cast<unsigned int>(y)};
-				vector3f const sample_point{x + 0.5f, y + 0.5f, 0.0f};
-				delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+				float const depth{(1.0f - current_scanline_distance_normalized) * left_depth + current_scanline_distance_normalized * right_depth};
+
+				if (is_pixel_inside_scissor_rectangle(static_cast<unsigned int>(x), static_cast<unsigned int>(y)))
+				{
+					vector2ui const pixel_coordinates{static_cast<unsigned int>(x), static_cast<unsigned int>(y)};
+					vector3f const sample_point{x + 0.5f, y + 0.5f, depth};
+					delegate.process_rasterizing_stage_result(pixel_coordinates, sample_point, shader, target_texture);
+				}
 
 				current_scanline_distance_normalized += scanline_step_distance_normalized;
 			}
@@ -1,16 +1,106 @@
 #ifndef LANTERN_RENDERER_H
 #define LANTERN_RENDERER_H
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include "shader_bind_point_info.h"
 #include "geometry_stage.h"
 #include "rasterizing_stage.h"
 #include "merging_stage.h"
+#include "thread_pool.h"
 
 namespace lantern
 {
 	/** @defgroup Rendering */
 
+	/** Specifies how renderer executes rasterizing and merging stages */
+	enum class rendering_mode_option
+	{
+		/** Every triangle is rasterized and merged right after geometry stage processed it, on the calling thread */
+		serial,
+
+		/** Triangles are binned into screen tiles first, then tiles are rasterized and merged in parallel.
+		* Triangles are processed in submission order inside each tile, so the result is identical to the serial one
+		*/
+		tiled
+	};
+
+	/** Triangle passed by geometry stage and waiting in bins to be rasterized
+	* @ingroup Rendering
+	*/
+	class binned_triangle final
+	{
+	public:
+		/** First triangle vertex */
+		vector4f vertex0;
+
+		/** Second triangle vertex */
+		vector4f vertex1;
+
+		/** Third triangle vertex */
+		vector4f vertex2;
+
+		/** First vertex attribute index */
+		unsigned int index0;
+
+		/** Second vertex attribute index */
+		unsigned int index1;
+
+		/** Third vertex attribute index */
+		unsigned int index2;
+	};
+
+	class renderer;
+
+	/** Delegate passed to the stages, forwards their results back to the renderer.
+	* Rasterization algorithm and alpha blending mode are template parameters,
+	* so that per-triangle and per-pixel code doesn't branch on runtime settings
+	* @ingroup Rendering
+	*/
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled>
+	class renderer_stages_delegate final
+	{
+	public:
+		/** Constructs delegate
+		* @param target_renderer Renderer to forward results to
+		*/
+		explicit renderer_stages_delegate(renderer& target_renderer);
+
+		/** Passes geometry stage result to the renderer
+		* @param vertex0 First triangle vertex
+		* @param vertex1 Second triangle vertex
+		* @param vertex2 Third triangle vertex
+		* @param index0 First vertex attribute index
+		* @param index1 Second vertex attribute index
+		* @param index2 Third vertex attribute index
+		* @param shader Shader to use
+		* @param target_texture Texture polygon will drawn into
+		*/
+		template<typename TShader>
+		void process_geometry_stage_result(
+			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+			unsigned int const index0, unsigned int const index1, unsigned int const index2,
+			TShader& shader,
+			texture& target_texture);
+
+		/** Passes rasterizing stage result to the renderer
+		* @param pixel_coordinates Coordinates of a pixel that should be filled
+		* @param sample_point Sample point coordinates
+		* @param shader Shader to use
+		* @param target_texture Texture polygon will drawn into
+		*/
+		template<typename TShader>
+		void process_rasterizing_stage_result(
+			vector2ui const& pixel_coordinates, vector3f sample_point, TShader& shader, texture& target_texture);
+
+	private:
+		/** Renderer to forward results to */
+		renderer& m_renderer;
+	};
+
 	/** Renderer is the root object for rendering in a texture.
 	* It manages all the stages and passes data between them.
 	* There are three stages for now, in order of invoking:
@@ -25,6 +115,9 @@ namespace lantern
 		friend class rasterizing_stage;
 		friend class merging_stage;
 
+		template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled>
+		friend class renderer_stages_delegate;
+
 	public:
 		/** Constructs renderer with default settings for each stage */
 		renderer();
@@ -44,7 +137,40 @@ namespace lantern
 		*/
 		merging_stage& get_merging_stage();
 
-		/** Renders a mesh in a texture using specified shader
+		/** Sets rendering mode
+		* @param mode Mode to use
+		*/
+		void set_rendering_mode(rendering_mode_option const mode);
+
+		/** Gets rendering mode
+		* @returns Current rendering mode
+		*/
+		rendering_mode_option get_rendering_mode() const;
+
+		/** Sets tile size used in tiled rendering mode
+		* @param size Tile width and height in pixels, should be greater than zero
+		*/
+		void set_tile_size(unsigned int const size);
+
+		/** Gets tile size used in tiled rendering mode
+		* @returns Tile width and height in pixels
+		*/
+		unsigned int get_tile_size() const;
+
+		/** Sets count of threads used in tiled rendering mode
+		* @param count Threads count including calling thread, should be greater than zero
+		*/
+		void set_threads_count(unsigned int const count);
+
+		/** Gets count of threads used in tiled rendering mode
+		* @returns Threads count including calling thread
+		*/
+		unsigned int get_threads_count() const;
+
+		/** Renders a mesh in a texture using specified shader.
+		* In tiled mode every thread gets its own copy of the shader for pixel processing,
+		* so shader type must be copy constructible and changes made by pixel processing are not visible in passed instance.
+		* Current rasterization algorithm and alpha blending mode are checked once per call
 		* @param mesh Mesh to render
 		* @param shader Shader to use for rendering
 		* @param target_texture Texture to render image into
@@ -52,7 +178,131 @@ namespace lantern
 		template<typename TShader>
 		void render_mesh(mesh const& mesh, TShader& shader, texture& target_texture);
 
+		/** Renders a mesh in a texture using specified shader and rasterization algorithm known at compile time.
+		* Rasterization algorithm set in rasterizing stage is ignored
+		* @param mesh Mesh to render
+		* @param shader Shader to use for rendering
+		* @param target_texture Texture to render image into
+		*/
+		template<rasterization_algorithm_option TAlgorithm, typename TShader>
+		void render_mesh(mesh const& mesh, TShader& shader, texture& target_texture);
+
+		/** Renders a mesh in a texture using specified shader, testing samples against a depth buffer.
+		* Depth test is performed before pixel shader invocation, so occluded pixels are not shaded
+		* @param mesh Mesh to render
+		* @param shader Shader to use for rendering
+		* @param target_texture Texture to render image into
+		* @param target_depth_buffer Depth buffer to test samples against, must be of the same size as the texture
+		*/
+		template<typename TShader>
+		void render_mesh(mesh const& mesh, TShader& shader, texture& target_texture, depth_buffer& target_depth_buffer);
+
+		/** Renders a part of mesh in a texture using specified shader.
+		* Only vertices referenced by submesh triangles are processed, so meshes can be drawn submesh by submesh with different shaders settings
+		* @param mesh Mesh to render
+		* @param part Submesh of the mesh to render
+		* @param shader Shader to use for rendering
+		* @param target_texture Texture to render image into
+		*/
+		template<typename TShader>
+		void render_mesh(mesh const& mesh, submesh const& part, TShader& shader, texture& target_texture);
+
+		/** Renders a part of mesh in a texture using specified shader, testing samples against a depth buffer
+		* @param mesh Mesh to render
+		* @param part Submesh of the mesh to render
+		* @param shader Shader to use for rendering
+		* @param target_texture Texture to render image into
+		* @param target_depth_buffer Depth buffer to test samples against, must be of the same size as the texture
+		*/
+		template<typename TShader>
+		void render_mesh(mesh const& mesh, submesh const& part, TShader& shader, texture& target_texture, depth_buffer& target_depth_buffer);
+
+		/** Renders copies of a mesh in a texture using specified shader, one for every instance data element.
+		* Shader gets data of every instance through its instance bind point, see \ref shader_instance_bind_point.
+		* Attributes are binded once for all the instances, referenced vertices are collected once,
+		* and in tiled mode triangles of all the instances are binned and rasterized together
+		* @param mesh Mesh to render
+		* @param shader Shader to use for rendering
+		* @param instances Data of every instance, e.g. model-view-projection matrices
+		* @param target_texture Texture to render image into
+		*/
+		template<typename TShader, typename TInstance>
+		void render_mesh_instanced(mesh const& mesh, TShader& shader, std::vector<TInstance> const& instances, texture& target_texture);
+
+		/** Renders copies of a mesh in a texture using specified shader, testing samples against a depth buffer
+		* @param mesh Mesh to render
+		* @param shader Shader to use for rendering
+		* @param instances Data of every instance, e.g. model-view-projection matrices
+		* @param target_texture Texture to render image into
+		* @param target_depth_buffer Depth buffer to test samples against, must be of the same size as the texture
+		*/
+		template<typename TShader, typename TInstance>
+		void render_mesh_instanced(mesh const& mesh, TShader& shader, std::vector<TInstance> const& instances, texture& target_texture, depth_buffer& target_depth_buffer);
+
 	private:
+		/** Renders range of mesh indices using rasterization algorithm set in rasterizing stage
+		* @param mesh Mesh to render
+		* @param index_offset Index of the first mesh index to render
+		* @param index_count Count of indices to render
+		* @param shader Shader to use for rendering
+		* @param instances Pointer to instances data vector, or nullptr to render mesh once
+		* @param target_texture Texture to render image into
+		*/
+		template<typename TShader, typename TInstances>
+		void render_indices(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture);
+
+		/** Renders range of mesh indices using rasterization algorithm known at compile time
+		* @param mesh Mesh to render
+		* @param index_offset Index of the first mesh index to render
+		* @param index_count Count of indices to render
+		* @param shader Shader to use for rendering
+		* @param instances Pointer to instances data vector, or nullptr to render mesh once
+		* @param target_texture Texture to render image into
+		*/
+		template<rasterization_algorithm_option TAlgorithm, typename TShader, typename TInstances>
+		void render_indices(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture);
+
+		/** Invokes all the stages with rasterization algorithm and alpha blending mode known at compile time
+		* @param mesh Mesh to render
+		* @param index_offset Index of the first mesh index to render
+		* @param index_count Count of indices to render
+		* @param shader Shader to use for rendering
+		* @param instances Pointer to instances data vector, or nullptr to render mesh once
+		* @param target_texture Texture to render image into
+		*/
+		template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader, typename TInstances>
+		void invoke_stages(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture);
+
+		/** Invokes geometry stage once
+		* @param mesh Mesh to render
+		* @param index_offset Index of the first mesh index to render
+		* @param index_count Count of indices to render
+		* @param shader Shader to use for rendering
+		* @param instances Not used
+		* @param do_homogeneous_division False = pass vertices in screen space without dividing them by w
+		* @param target_texture Texture to render image into
+		* @param delegate Object to pass results to
+		*/
+		template<typename TShader, typename TDelegate>
+		void invoke_geometry_stage(
+			mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, std::nullptr_t const instances,
+			bool const do_homogeneous_division, texture& target_texture, TDelegate& delegate);
+
+		/** Invokes geometry stage for every instance
+		* @param mesh Mesh to render
+		* @param index_offset Index of the first mesh index to render
+		* @param index_count Count of indices to render
+		* @param shader Shader to use for rendering
+		* @param instances Data of every instance
+		* @param do_homogeneous_division False = pass vertices in screen space without dividing them by w
+		* @param target_texture Texture to render image into
+		* @param delegate Object to pass results to
+		*/
+		template<typename TShader, typename TInstance, typename TDelegate>
+		void invoke_geometry_stage(
+			mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, std::vector<TInstance> const* const instances,
+			bool const do_homogeneous_division, texture& target_texture, TDelegate& delegate);
+
 		/** Passes geometry stage result to the rasterizer stage
 		* @param vertex0 First triangle vertex
 		* @param vertex1 Second triangle vertex
@@ -63,32 +313,77 @@ namespace lantern
 		* @param shader Shader to use
 		* @param target_texture Texture polygon will drawn into
 		*/
-		template<typename TShader>
+		template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader>
 		void process_geometry_stage_result(
 			vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
 			unsigned int const index0, unsigned int const index1, unsigned int const index2,
 			TShader& shader,
 			texture& target_texture);
 
+		/** Rasterizes binned triangles tile by tile on the threads pool
+		* @param mesh Mesh triangles belong to
+		* @param shader Shader to use
+		* @param target_texture Texture polygons will be drawn into
+		*/
+		template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader>
+		void rasterize_binned_triangles(mesh const& mesh, TShader& shader, texture& target_texture);
+
+		/** Adds triangle to bins of all the tiles it may cover
+		* @param triangle Triangle to add
+		* @param homogeneous True = triangle vertices are not divided by w yet
+		* @param target_texture Texture polygon will be drawn into
+		*/
+		void bin_triangle(binned_triangle const& triangle, bool const homogeneous, texture const& target_texture);
+
 		/** Passes rasterizing stage result to the merging stage
 		* @param pixel_coordinates Coordinates of a pixel that should be filled
 		* @param sample_point Sample point coordinates
 		* @param shader Shader to use
 		* @param target_texture Texture polygon will drawn into
 		*/
-		template<typename TShader>
+		template<bool TAlphaBlendingEnabled, typename TShader>
 		void process_rasterizing_stage_result(
 			vector2ui const& pixel_coordinates, vector3f sample_point, TShader& shader, texture& target_texture);
 
-		/** Binds mesh attributes to shader bind points
+		/** Binds mesh attributes to shader bind points. Storage keeps previous binding,
+		* and if it's still valid for the same mesh attributes and shader instance, it's reused without attributes matching
 		* @param required_bind_points Shader bind points
+		* @param shader Shader instance to bind attributes to
 		* @param available_attributes Mesh attributes
 		* @param binded_attributes_storage Storage for bindings
 		*/
-		template<typename TAttr>
+		template<typename TShader, typename TAttr>
 		void bind_attributes(
-			std::vector<shader_bind_point_info<TAttr>> const& required_bind_points,
+			shader_bind_points<TShader, TAttr> const& required_bind_points,
+			TShader& shader,
+			std::vector<mesh_attribute_info<TAttr>> const& available_attributes,
+			std::vector<binded_mesh_attribute_info<TAttr>>& binded_attributes_storage);
+
+		/** Checks if attributes binding can be reused
+		* @param required_bind_points Shader bind points
+		* @param shader Shader instance attributes should be binded to
+		* @param available_attributes Mesh attributes
+		* @param binded_attributes Existing binding
+		* @returns True if every bind point is binded to the shader instance and to a mesh attribute with required id
+		*/
+		template<typename TShader, typename TAttr>
+		bool is_binding_valid(
+			shader_bind_points<TShader, TAttr> const& required_bind_points,
+			TShader& shader,
 			std::vector<mesh_attribute_info<TAttr>> const& available_attributes,
+			std::vector<binded_mesh_attribute_info<TAttr>> const& binded_attributes) const;
+
+		/** Binds the same mesh attributes as existing binding does to another instance of the shader
+		* @param required_bind_points Shader bind points
+		* @param shader Shader instance to bind attributes to
+		* @param source_binded_attributes Existing binding
+		* @param binded_attributes_storage Storage for bindings
+		*/
+		template<typename TShader, typename TAttr>
+		void rebind_attributes(
+			shader_bind_points<TShader, TAttr> const& required_bind_points,
+			TShader& shader,
+			std::vector<binded_mesh_attribute_info<TAttr>> const& source_binded_attributes,
 			std::vector<binded_mesh_attribute_info<TAttr>>& binded_attributes_storage);
 
 		/* Geometry stage instance */
@@ -102,53 +397,349 @@ namespace lantern
 
 		/** Binded attributes */
 		binded_mesh_attributes m_binded_mesh_attributes;
+
+		/** Current rendering mode */
+		rendering_mode_option m_rendering_mode;
+
+		/** Tile size in tiled mode */
+		unsigned int m_tile_size;
+
+		/** Threads count in tiled mode */
+		unsigned int m_threads_count;
+
+		/** Threads executing tiles, created on first use */
+		std::unique_ptr<thread_pool> m_thread_pool;
+
+		/** Triangles passed by geometry stage in tiled mode */
+		std::vector<binned_triangle> m_binned_triangles;
+
+		/** Indices of binned triangles for every tile, row by row */
+		std::vector<std::vector<unsigned int>> m_tiles_triangles;
+
+		/** Indices of tiles that have at least one triangle */
+		std::vector<unsigned int> m_non_empty_tiles;
+
+		/** Count of tiles in a row for current target texture */
+		unsigned int m_tiles_row_size;
+
+		/** Rasterizing stage for every thread in tiled mode */
+		std::vector<rasterizing_stage> m_threads_rasterizing_stages;
+
+		/** Binded attributes for every thread in tiled mode */
+		std::vector<binded_mesh_attributes> m_threads_binded_mesh_attributes;
 	};
 
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled>
+	inline renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled>::renderer_stages_delegate(renderer& target_renderer)
+		: m_renderer(target_renderer)
+	{
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled>
+	template<typename TShader>
+	inline void renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled>::process_geometry_stage_result(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		texture& target_texture)
+	{
+		m_renderer.template process_geometry_stage_result<TAlgorithm, TAlphaBlendingEnabled>(
+			vertex0, vertex1, vertex2,
+			index0, index1, index2,
+			shader,
+			target_texture);
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled>
+	template<typename TShader>
+	inline void renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled>::process_rasterizing_stage_result(
+		vector2ui const& pixel_coordinates, vector3f sample_point, TShader& shader, texture& target_texture)
+	{
+		m_renderer.template process_rasterizing_stage_result<TAlphaBlendingEnabled>(pixel_coordinates, sample_point, shader, target_texture);
+	}
+
 	template<typename TShader>
 	inline void renderer::render_mesh(mesh const& mesh, TShader& shader, texture& target_texture)
+	{
+		render_indices(mesh, 0, mesh.get_indices().size(), shader, nullptr, target_texture);
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, typename TShader>
+	inline void renderer::render_mesh(mesh const& mesh, TShader& shader, texture& target_texture)
+	{
+		render_indices<TAlgorithm>(mesh, 0, mesh.get_indices().size(), shader, nullptr, target_texture);
+	}
+
+	template<typename TShader>
+	inline void renderer::render_mesh(mesh const& mesh, submesh const& part, TShader& shader, texture& target_texture)
+	{
+		render_indices(mesh, part.index_offset, part.index_count, shader, nullptr, target_texture);
+	}
+
+	template<typename TShader>
+	inline void renderer::render_mesh(mesh const& mesh, submesh const& part, TShader& shader, texture& target_texture, depth_buffer& target_depth_buffer)
+	{
+		depth_buffer* const previous_depth_buffer{m_merging_stage.get_depth_buffer()};
+
+		m_merging_stage.set_depth_buffer(&target_depth_buffer);
+		render_mesh(mesh, part, shader, target_texture);
+		m_merging_stage.set_depth_buffer(previous_depth_buffer);
+	}
+
+	template<typename TShader, typename TInstance>
+	inline void renderer::render_mesh_instanced(mesh const& mesh, TShader& shader, std::vector<TInstance> const& instances, texture& target_texture)
+	{
+		render_indices(mesh, 0, mesh.get_indices().size(), shader, &instances, target_texture);
+	}
+
+	template<typename TShader, typename TInstance>
+	inline void renderer::render_mesh_instanced(mesh const& mesh, TShader& shader, std::vector<TInstance> const& instances, texture& target_texture, depth_buffer& target_depth_buffer)
+	{
+		depth_buffer* const previous_depth_buffer{m_merging_stage.get_depth_buffer()};
+
+		m_merging_stage.set_depth_buffer(&target_depth_buffer);
+		render_mesh_instanced(mesh, shader, instances, target_texture);
+		m_merging_stage.set_depth_buffer(previous_depth_buffer);
+	}
+
+	template<typename TShader, typename TInstances>
+	inline void renderer::render_indices(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture)
+	{
+		switch (m_rasterizing_stage.get_rasterization_algorithm())
+		{
+			case rasterization_algorithm_option::traversal_aabb:
+				render_indices<rasterization_algorithm_option::traversal_aabb>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::traversal_backtracking:
+				render_indices<rasterization_algorithm_option::traversal_backtracking>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::traversal_zigzag:
+				render_indices<rasterization_algorithm_option::traversal_zigzag>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::traversal_aabb_fixed_point:
+				render_indices<rasterization_algorithm_option::traversal_aabb_fixed_point>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::traversal_aabb_simd:
+				render_indices<rasterization_algorithm_option::traversal_aabb_simd>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::traversal_hierarchical:
+				render_indices<rasterization_algorithm_option::traversal_hierarchical>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::homogeneous:
+				render_indices<rasterization_algorithm_option::homogeneous>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+
+			case rasterization_algorithm_option::inversed_slope:
+				render_indices<rasterization_algorithm_option::inversed_slope>(mesh, index_offset, index_count, shader, instances, target_texture);
+				break;
+		}
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, typename TShader, typename TInstances>
+	inline void renderer::render_indices(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture)
+	{
+		if (m_merging_stage.get_alpha_blending_enabled())
+		{
+			invoke_stages<TAlgorithm, true>(mesh, index_offset, index_count, shader, instances, target_texture);
+		}
+		else
+		{
+			invoke_stages<TAlgorithm, false>(mesh, index_offset, index_count, shader, instances, target_texture);
+		}
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader, typename TInstances>
+	inline void renderer::invoke_stages(mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, TInstances const instances, texture& target_texture)
 	{
 		// Prepare bind points for all available types
 		//
-		bind_attributes(shader.get_color_bind_points(), mesh.get_color_attributes(), m_binded_mesh_attributes.color_attributes);
-		bind_attributes(shader.get_float_bind_points(), mesh.get_float_attributes(), m_binded_mesh_attributes.float_attributes);
-		bind_attributes(shader.get_vector2f_bind_points(), mesh.get_vector2f_attributes(), m_binded_mesh_attributes.vector2f_attributes);
-		bind_attributes(shader.get_vector3f_bind_points(), mesh.get_vector3f_attributes(), m_binded_mesh_attributes.vector3f_attributes);
+		bind_attributes(TShader::get_color_bind_points(), shader, mesh.get_color_attributes(), m_binded_mesh_attributes.color_attributes);
+		bind_attributes(TShader::get_float_bind_points(), shader, mesh.get_float_attributes(), m_binded_mesh_attributes.float_attributes);
+		bind_attributes(TShader::get_vector2f_bind_points(), shader, mesh.get_vector2f_attributes(), m_binded_mesh_attributes.vector2f_attributes);
+		bind_attributes(TShader::get_vector3f_bind_points(), shader, mesh.get_vector3f_attributes(), m_binded_mesh_attributes.vector3f_attributes);
+
+		// Prepare bins
+		//
+		if (m_rendering_mode == rendering_mode_option::tiled)
+		{
+			m_tiles_row_size = (target_texture.get_width() + m_tile_size - 1) / m_tile_size;
+			unsigned int const tiles_column_size{(target_texture.get_height() + m_tile_size - 1) / m_tile_size};
+
+			m_tiles_triangles.resize(m_tiles_row_size * tiles_column_size);
+			for (std::vector<unsigned int>& tile_triangles : m_tiles_triangles)
+			{
+				tile_triangles.clear();
+			}
+
+			m_binned_triangles.clear();
+		}
 
 		// Pass data to the first stage
 		//
-		bool const do_homogeneous_division{m_rasterizing_stage.get_rasterization_algorithm() == rasterization_algorithm_option::homogeneous};
-		m_geometry_stage.invoke(mesh, shader, do_homogeneous_division, target_texture, *this);
+		renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled> delegate{*this};
+		bool const do_homogeneous_division{TAlgorithm == rasterization_algorithm_option::homogeneous};
+		invoke_geometry_stage(mesh, index_offset, index_count, shader, instances, do_homogeneous_division, target_texture, delegate);
+
+		if (m_rendering_mode == rendering_mode_option::tiled)
+		{
+			rasterize_binned_triangles<TAlgorithm, TAlphaBlendingEnabled>(mesh, shader, target_texture);
+		}
+	}
+
+	template<typename TShader, typename TDelegate>
+	inline void renderer::invoke_geometry_stage(
+		mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, std::nullptr_t const instances,
+		bool const do_homogeneous_division, texture& target_texture, TDelegate& delegate)
+	{
+		m_geometry_stage.invoke(mesh, index_offset, index_count, shader, do_homogeneous_division, target_texture, delegate);
+	}
+
+	template<typename TShader, typename TInstance, typename TDelegate>
+	inline void renderer::invoke_geometry_stage(
+		mesh const& mesh, size_t const index_offset, size_t const index_count, TShader& shader, std::vector<TInstance> const* const instances,
+		bool const do_homogeneous_division, texture& target_texture, TDelegate& delegate)
+	{
+		m_geometry_stage.invoke_instanced(mesh, index_offset, index_count, shader, *instances, do_homogeneous_division, target_texture, delegate);
 	}
 
 	template<typename TShader>
+	inline void renderer::render_mesh(mesh const& mesh, TShader& shader, texture& target_texture, depth_buffer& target_depth_buffer)
+	{
+		depth_buffer* const previous_depth_buffer{m_merging_stage.get_depth_buffer()};
+
+		m_merging_stage.set_depth_buffer(&target_depth_buffer);
+		render_mesh(mesh, shader, target_texture);
+		m_merging_stage.set_depth_buffer(previous_depth_buffer);
+	}
+
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader>
 	inline void renderer::process_geometry_stage_result(
 		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
 		unsigned int const index0, unsigned int const index1, unsigned int const index2,
 		TShader& shader,
 		texture& target_texture)
 	{
-		m_rasterizing_stage.invoke(
+		if (m_rendering_mode == rendering_mode_option::tiled)
+		{
+			bin_triangle(
+				binned_triangle{vertex0, vertex1, vertex2, index0, index1, index2},
+				TAlgorithm == rasterization_algorithm_option::homogeneous,
+				target_texture);
+			return;
+		}
+
+		renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled> delegate{*this};
+		m_rasterizing_stage.invoke<TAlgorithm>(
 			vertex0, vertex1, vertex2,
 			index0, index1, index2,
 			shader,
 			m_binded_mesh_attributes,
 			target_texture,
-			*this);
+			delegate);
 	}
 
-	template<typename TShader>
+	template<rasterization_algorithm_option TAlgorithm, bool TAlphaBlendingEnabled, typename TShader>
+	void renderer::rasterize_binned_triangles(mesh const& mesh, TShader& shader, texture& target_texture)
+	{
+		m_non_empty_tiles.clear();
+		for (size_t i{0}; i < m_tiles_triangles.size(); ++i)
+		{
+			if (!m_tiles_triangles[i].empty())
+			{
+				m_non_empty_tiles.push_back(static_cast<unsigned int>(i));
+			}
+		}
+
+		if (m_non_empty_tiles.empty())
+		{
+			return;
+		}
+
+		if ((m_thread_pool == nullptr) || (m_thread_pool->get_threads_count() != m_threads_count))
+		{
+			m_thread_pool.reset(new thread_pool{m_threads_count});
+		}
+
+		// Every thread writes interpolated attributes into its own shader copy,
+		// so the same attributes have to be binded to bind points of that copy
+		//
+		std::vector<TShader> threads_shaders(m_threads_count, shader);
+
+		m_threads_rasterizing_stages.resize(m_threads_count);
+		m_threads_binded_mesh_attributes.resize(m_threads_count);
+
+		for (unsigned int i{0}; i < m_threads_count; ++i)
+		{
+			TShader& thread_shader = threads_shaders[i];
+			binded_mesh_attributes& thread_binded_attributes = m_threads_binded_mesh_attributes[i];
+
+			rebind_attributes(TShader::get_color_bind_points(), thread_shader, m_binded_mesh_attributes.color_attributes, thread_binded_attributes.color_attributes);
+			rebind_attributes(TShader::get_float_bind_points(), thread_shader, m_binded_mesh_attributes.float_attributes, thread_binded_attributes.float_attributes);
+			rebind_attributes(TShader::get_vector2f_bind_points(), thread_shader, m_binded_mesh_attributes.vector2f_attributes, thread_binded_attributes.vector2f_attributes);
+			rebind_attributes(TShader::get_vector3f_bind_points(), thread_shader, m_binded_mesh_attributes.vector3f_attributes, thread_binded_attributes.vector3f_attributes);
+
+			m_threads_rasterizing_stages[i] = m_rasterizing_stage;
+		}
+
+		unsigned int const texture_width{target_texture.get_width()};
+		unsigned int const texture_height{target_texture.get_height()};
+
+		renderer_stages_delegate<TAlgorithm, TAlphaBlendingEnabled> delegate{*this};
+
+		m_thread_pool->run(
+			static_cast<unsigned int>(m_non_empty_tiles.size()),
+			[&](unsigned int const task_index, unsigned int const worker_index)
+			{
+				unsigned int const tile_index{m_non_empty_tiles[task_index]};
+				unsigned int const tile_x{(tile_index % m_tiles_row_size) * m_tile_size};
+				unsigned int const tile_y{(tile_index / m_tiles_row_size) * m_tile_size};
+
+				rasterizing_stage& stage = m_threads_rasterizing_stages[worker_index];
+				stage.set_scissor_rectangle(
+					aabb<vector2ui>{
+						vector2ui{tile_x, tile_y},
+						vector2ui{std::min(tile_x + m_tile_size, texture_width) - 1, std::min(tile_y + m_tile_size, texture_height) - 1}});
+
+				for (unsigned int const triangle_index : m_tiles_triangles[tile_index])
+				{
+					binned_triangle const& triangle = m_binned_triangles[triangle_index];
+
+					stage.invoke<TAlgorithm>(
+						triangle.vertex0, triangle.vertex1, triangle.vertex2,
+						triangle.index0, triangle.index1, triangle.index2,
+						threads_shaders[worker_index],
+						m_threads_binded_mesh_attributes[worker_index],
+						target_texture,
+						delegate);
+				}
+			});
+	}
+
+	template<bool TAlphaBlendingEnabled, typename TShader>
 	inline void renderer::process_rasterizing_stage_result(
 		vector2ui const& pixel_coordinates, vector3f sample_point, TShader& shader, texture& target_texture)
 	{
-		m_merging_stage.invoke(pixel_coordinates, sample_point, shader, target_texture, *this);
+		m_merging_stage.invoke<TAlphaBlendingEnabled>(pixel_coordinates, sample_point, shader, target_texture, *this);
 	}
 
-	template<typename TAttr>
+	template<typename TShader, typename TAttr>
 	void renderer::bind_attributes(
-		std::vector<shader_bind_point_info<TAttr>> const& required_bind_points,
+		shader_bind_points<TShader, TAttr> const& required_bind_points,
+		TShader& shader,
 		std::vector<mesh_attribute_info<TAttr>> const& available_attributes,
 		std::vector<binded_mesh_attribute_info<TAttr>>& binded_attributes_storage)
 	{
+		if (is_binding_valid(required_bind_points, shader, available_attributes, binded_attributes_storage))
+		{
+			return;
+		}
+
 		// Clear the storage
 		binded_attributes_storage.clear();
 
@@ -157,7 +748,7 @@ namespace lantern
 
 		for (size_t i{0}; i < bind_points_size; ++i)
 		{
-			shader_bind_point_info<TAttr> const& bind_point_info = required_bind_points.at(i);
+			shader_bind_point_info<TShader, TAttr> const& bind_point_info = required_bind_points[i];
 
 			bool binded{false};
 
@@ -169,7 +760,7 @@ namespace lantern
 				if (attr_info.get_id() == bind_point_info.attribute_id)
 				{
 					binded_attributes_storage.push_back(
-						binded_mesh_attribute_info<TAttr>{attr_info, bind_point_info.bind_point});
+						binded_mesh_attribute_info<TAttr>{attr_info, &(shader.*bind_point_info.bind_point), &m_geometry_stage.get_clipped_vertices()});
 
 					binded = true;
 					break;
@@ -178,10 +769,69 @@ namespace lantern
 
 			if (!binded)
 			{
+				binded_attributes_storage.clear();
 				throw std::runtime_error("Mesh doesn't contain attribute required by shader");
 			}
 		}
-	};
+	}
+
+	template<typename TShader, typename TAttr>
+	bool renderer::is_binding_valid(
+		shader_bind_points<TShader, TAttr> const& required_bind_points,
+		TShader& shader,
+		std::vector<mesh_attribute_info<TAttr>> const& available_attributes,
+		std::vector<binded_mesh_attribute_info<TAttr>> const& binded_attributes) const
+	{
+		size_t const bind_points_size{required_bind_points.size()};
+		if (binded_attributes.size() != bind_points_size)
+		{
+			return false;
+		}
+
+		// Mesh might be changed or even replaced by another one since the previous binding,
+		// so binded attributes should still be elements of available attributes and have required ids
+		//
+
+		std::less<mesh_attribute_info<TAttr> const*> const less;
+		mesh_attribute_info<TAttr> const* const attributes_begin{available_attributes.data()};
+		mesh_attribute_info<TAttr> const* const attributes_end{attributes_begin + available_attributes.size()};
+
+		for (size_t i{0}; i < bind_points_size; ++i)
+		{
+			shader_bind_point_info<TShader, TAttr> const& bind_point_info = required_bind_points[i];
+			binded_mesh_attribute_info<TAttr> const& binded_attr = binded_attributes[i];
+
+			if ((binded_attr.bind_point != &(shader.*bind_point_info.bind_point)) ||
+				less(&binded_attr.info, attributes_begin) ||
+				!less(&binded_attr.info, attributes_end) ||
+				(binded_attr.info.get_id() != bind_point_info.attribute_id))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	template<typename TShader, typename TAttr>
+	void renderer::rebind_attributes(
+		shader_bind_points<TShader, TAttr> const& required_bind_points,
+		TShader& shader,
+		std::vector<binded_mesh_attribute_info<TAttr>> const& source_binded_attributes,
+		std::vector<binded_mesh_attribute_info<TAttr>>& binded_attributes_storage)
+	{
+		binded_attributes_storage.clear();
+
+		size_t const bind_points_size{required_bind_points.size()};
+		for (size_t i{0}; i < bind_points_size; ++i)
+		{
+			binded_mesh_attribute_info<TAttr> const& source_binded_attr = source_binded_attributes[i];
+
+			binded_attributes_storage.push_back(
+				binded_mesh_attribute_info<TAttr>{
+					source_binded_attr.info, &(shader.*required_bind_points[i].bind_point), source_binded_attr.clipped_vertices});
+		}
+	}
 }
 
 #endif // LANTERN_RENDERER_H
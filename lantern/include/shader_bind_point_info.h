@@ -1,6 +1,8 @@
 #ifndef LANTERN_SHADER_H
 #define LANTERN_SHADER_H
 
+#include <cstddef>
+
 namespace lantern
 {
 	/** @defgroup Shaders
@@ -12,19 +14,91 @@ namespace lantern
 	*/
 
 	/** Represents shader bind point information, holds required attribute ID and bind point itself.
-	* Bind point is just an address of variable for rasterizer to put interpolated value into
+	* Bind point is a shader member for rasterizer to put interpolated value into,
+	* so the same description is valid for every instance of the shader
 	* @ingroup Shaders
 	*/
-	template<typename TAttr>
-	class shader_bind_point_info
+	template<typename TShader, typename TAttr>
+	class shader_bind_point_info final
 	{
 	public:
 		/** Attribute id */
 		unsigned int attribute_id;
 
-		/** Address to put value into */
-		TAttr* bind_point;
+		/** Shader member to put value into */
+		TAttr TShader::* bind_point;
 	};
+
+	/** Instance bind point is a shader method renderer passes data of every instance to before processing its vertices,
+	* used for instanced rendering. Shaders supporting it return the method from static get_instance_bind_point().
+	* Instance data should affect vertex processing only: in tiled mode pixels of all the instances are processed after the last instance data is passed
+	* @ingroup Shaders
+	*/
+	template<typename TShader, typename TInstance>
+	using shader_instance_bind_point = void (TShader::*)(TInstance const&);
+
+	/** List of shader bind points of one attribute type. It doesn't own bind points:
+	* shaders keep them in static arrays, so getting the list doesn't allocate memory
+	* @ingroup Shaders
+	*/
+	template<typename TShader, typename TAttr>
+	class shader_bind_points final
+	{
+	public:
+		/** Constructs empty list */
+		shader_bind_points();
+
+		/** Constructs list of bind points stored in an array
+		* @param bind_points Array of bind points, must outlive the list
+		*/
+		template<size_t TSize>
+		shader_bind_points(shader_bind_point_info<TShader, TAttr> const (&bind_points)[TSize]);
+
+		/** Gets bind points count
+		* @returns Bind points count
+		*/
+		size_t size() const;
+
+		/** Gets bind point
+		* @param index Index of bind point
+		* @returns Bind point info
+		*/
+		shader_bind_point_info<TShader, TAttr> const& operator[](size_t const index) const;
+
+	private:
+		/** First bind point */
+		shader_bind_point_info<TShader, TAttr> const* m_bind_points;
+
+		/** Bind points count */
+		size_t m_size;
+	};
+
+	template<typename TShader, typename TAttr>
+	inline shader_bind_points<TShader, TAttr>::shader_bind_points()
+		: m_bind_points{nullptr}, m_size{0}
+	{
+
+	}
+
+	template<typename TShader, typename TAttr>
+	template<size_t TSize>
+	inline shader_bind_points<TShader, TAttr>::shader_bind_points(shader_bind_point_info<TShader, TAttr> const (&bind_points)[TSize])
+		: m_bind_points{bind_points}, m_size{TSize}
+	{
+
+	}
+
+	template<typename TShader, typename TAttr>
+	inline size_t shader_bind_points<TShader, TAttr>::size() const
+	{
+		return m_size;
+	}
+
+	template<typename TShader, typename TAttr>
+	inline shader_bind_point_info<TShader, TAttr> const& shader_bind_points<TShader, TAttr>::operator[](size_t const index) const
+	{
+		return m_bind_points[index];
+	}
 }
 
-#endif // LANTERN_SHADER_H
\ No newline at end of file
+#endif // LANTERN_SHADER_H
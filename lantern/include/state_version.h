@@ -0,0 +1,16 @@
+#ifndef LANTERN_STATE_VERSION_H
+#define LANTERN_STATE_VERSION_H
+
+#include <cstdint>
+
+namespace lantern
+{
+	/** Generates number identifying a state of some object, e.g. mesh content or shader settings.
+	* Numbers are never repeated during the process lifetime, so that equal versions mean the same state
+	* even if they belong to different objects. Thread-safe
+	* @returns Next version, never zero
+	*/
+	uint64_t get_next_state_version();
+}
+
+#endif // LANTERN_STATE_VERSION_H
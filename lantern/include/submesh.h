@@ -0,0 +1,33 @@
+#ifndef LANTERN_SUBMESH_H
+#define LANTERN_SUBMESH_H
+
+#include <string>
+#include "aabb.h"
+#include "vector3.h"
+
+namespace lantern
+{
+	/** Range of mesh indices forming a separate object or using a separate material.
+	* Such ranges can be rendered one by one, with their own shader settings, or skipped if they are out of view
+	*/
+	class submesh final
+	{
+	public:
+		/** Object name */
+		std::string name;
+
+		/** Name of material used by object */
+		std::string material_name;
+
+		/** Index of the first mesh index in range */
+		unsigned int index_offset;
+
+		/** Count of indices in range, multiple of three */
+		unsigned int index_count;
+
+		/** Bounding box of vertices referenced by range indices, in model space */
+		aabb<vector3f> bounding_box;
+	};
+}
+
+#endif // LANTERN_SUBMESH_H
@@ -1,13 +1,13 @@
 #ifndef LANTERN_TEXTURE_SHADER_H
 #define LANTERN_TEXTURE_SHADER_H
 
-#include <vector>
 #include "shader_bind_point_info.h"
 #include "color.h"
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
 #include "matrix4x4.h"
+#include "state_version.h"
 #include "mesh_attribute_info.h"
 #include "texture.h"
 
@@ -19,25 +19,33 @@ namespace lantern
 	class texture_shader final
 	{
 	public:
+		/** Constructs shader */
+		texture_shader();
+
 		/** Gets info about color bind points required by shader
 		* @returns Required color bind points
 		*/
-		std::vector<shader_bind_point_info<color>> get_color_bind_points();
+		static shader_bind_points<texture_shader, color> get_color_bind_points();
 
 		/** Gets info about float bind points required by shader
 		* @returns Required float bind points
 		*/
-		std::vector<shader_bind_point_info<float>> get_float_bind_points();
+		static shader_bind_points<texture_shader, float> get_float_bind_points();
 
 		/** Gets info about vector2f bind points required by shader
 		* @returns Required vector2f bind points
 		*/
-		std::vector<shader_bind_point_info<vector2f>> get_vector2f_bind_points();
+		static shader_bind_points<texture_shader, vector2f> get_vector2f_bind_points();
 
 		/** Gets info about vector3f bind points required by shader
 		* @returns Required vector3f bind points
 		*/
-		std::vector<shader_bind_point_info<vector3f>> get_vector3f_bind_points();
+		static shader_bind_points<texture_shader, vector3f> get_vector3f_bind_points();
+
+		/** Gets instance bind point, every instance gets its own model-view-projection matrix
+		* @returns Method setting model-view-projection matrix
+		*/
+		static shader_instance_bind_point<texture_shader, matrix4x4f> get_instance_bind_point();
 
 		/** Processes vertex
 		* @param vertex Vertex in local space
@@ -45,6 +53,18 @@ namespace lantern
 		*/
 		vector4f process_vertex(vector4f const& vertex);
 
+		/** Processes vertices at once, giving the same results as process_vertex does
+		* @param input Vertices in local space
+		* @param output Storage for processed vertices in homogeneous clip space
+		* @param count Count of vertices
+		*/
+		void process_vertices(vector4f const* const input, vector4f* const output, size_t const count);
+
+		/** Gets version of the state vertex processing depends on, it changes every time the state does
+		* @returns State version
+		*/
+		uint64_t get_vertex_state_version() const;
+
 		/** Processes pixel
 		* @param pixel Pixel coordinates on screen
 		* @returns Final pixel color
@@ -68,13 +88,23 @@ namespace lantern
 		/** Movel-view-projection matrix */
 		matrix4x4f m_mvp;
 
+		/** Version of model-view-projection matrix */
+		uint64_t m_vertex_state_version;
+
 		/** Texture to use */
 		texture const* m_texture;
 	};
 
+	inline texture_shader::texture_shader()
+		: m_vertex_state_version{get_next_state_version()}
+	{
+
+	}
+
 	inline void texture_shader::set_mvp_matrix(matrix4x4f const& mvp)
 	{
 		m_mvp = mvp;
+		m_vertex_state_version = get_next_state_version();
 	}
 
 	inline void texture_shader::set_texture(texture const* tex)
@@ -87,6 +117,16 @@ namespace lantern
 		return vertex * m_mvp;
 	}
 
+	inline void texture_shader::process_vertices(vector4f const* const input, vector4f* const output, size_t const count)
+	{
+		transform_vectors(input, output, count, m_mvp);
+	}
+
+	inline uint64_t texture_shader::get_vertex_state_version() const
+	{
+		return m_vertex_state_version;
+	}
+
 	inline color texture_shader::process_pixel(vector2ui const& pixel)
 	{
 		// No filtration for now, use nearest neighbour
@@ -96,25 +136,32 @@ namespace lantern
 				static_cast<unsigned int>(m_texture->get_height() * m_uv.y)});
 	}
 
-	inline std::vector<shader_bind_point_info<color>> texture_shader::get_color_bind_points()
+	inline shader_bind_points<texture_shader, color> texture_shader::get_color_bind_points()
 	{
-		return std::vector<shader_bind_point_info<color>>{};
+		return shader_bind_points<texture_shader, color>{};
 	}
 
-	inline std::vector<shader_bind_point_info<float>> texture_shader::get_float_bind_points()
+	inline shader_bind_points<texture_shader, float> texture_shader::get_float_bind_points()
 	{
-		return std::vector<shader_bind_point_info<float>>{};
+		return shader_bind_points<texture_shader, float>{};
+	}
+
+	inline shader_bind_points<texture_shader, vector2f> texture_shader::get_vector2f_bind_points()
+	{
+		static shader_bind_point_info<texture_shader, vector2f> const bind_points[]{
+			shader_bind_point_info<texture_shader, vector2f>{TEXCOORD_ATTR_ID, &texture_shader::m_uv}};
+
+		return shader_bind_points<texture_shader, vector2f>{bind_points};
 	}
 
-	inline std::vector<shader_bind_point_info<vector2f>> texture_shader::get_vector2f_bind_points()
+	inline shader_bind_points<texture_shader, vector3f> texture_shader::get_vector3f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector2f>>{
-			shader_bind_point_info<vector2f> { TEXCOORD_ATTR_ID, &m_uv }};
+		return shader_bind_points<texture_shader, vector3f>{};
 	}
 
-	inline std::vector<shader_bind_point_info<vector3f>> texture_shader::get_vector3f_bind_points()
+	inline shader_instance_bind_point<texture_shader, matrix4x4f> texture_shader::get_instance_bind_point()
 	{
-		return std::vector<shader_bind_point_info<vector3f>>{};
+		return &texture_shader::set_mvp_matrix;
 	}
 }
 
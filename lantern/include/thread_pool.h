@@ -0,0 +1,95 @@
+#ifndef LANTERN_THREAD_POOL_H
+#define LANTERN_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lantern
+{
+	/** Simple pool of worker threads executing a batch of independent tasks.
+	* Calling thread takes part in the execution too, so pool with one thread doesn't create any threads at all
+	*/
+	class thread_pool final
+	{
+	public:
+		/** Function executing a task
+		* @param task_index Index of a task to execute
+		* @param worker_index Index of a worker executing the task, less than threads count
+		*/
+		typedef std::function<void(unsigned int const task_index, unsigned int const worker_index)> task_function;
+
+		/** Constructs pool and starts worker threads
+		* @param threads_count Total count of threads executing tasks, including calling one
+		*/
+		explicit thread_pool(unsigned int const threads_count);
+
+		/** Stops and joins worker threads */
+		~thread_pool();
+
+		thread_pool(thread_pool const&) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		/** Gets count of threads executing tasks, including calling one
+		* @returns Threads count
+		*/
+		unsigned int get_threads_count() const;
+
+		/** Executes tasks and waits for all of them to finish. Tasks are taken in order of their indices
+		* @param tasks_count Count of tasks to execute
+		* @param task Function to execute for every task
+		*/
+		void run(unsigned int const tasks_count, task_function const& task);
+
+		/** Gets default threads count for current hardware
+		* @returns Count of hardware threads, at least one
+		*/
+		static unsigned int get_hardware_threads_count();
+
+	private:
+		/** Worker thread main loop
+		* @param worker_index Index of the worker
+		*/
+		void worker_loop(unsigned int const worker_index);
+
+		/** Takes tasks until there are no tasks left in current batch
+		* @param worker_index Index of the worker
+		*/
+		void execute_tasks(unsigned int const worker_index);
+
+		/** Background threads */
+		std::vector<std::thread> m_threads;
+
+		/** Guards batch state */
+		std::mutex m_mutex;
+
+		/** Notifies workers about new batch or stopping */
+		std::condition_variable m_batch_started;
+
+		/** Notifies calling thread about workers finishing their part */
+		std::condition_variable m_batch_finished;
+
+		/** Task of current batch */
+		task_function const* m_task;
+
+		/** Count of tasks in current batch */
+		unsigned int m_tasks_count;
+
+		/** Index of the next task to take */
+		std::atomic<unsigned int> m_next_task_index;
+
+		/** Increased every batch so that workers do not execute the same batch twice */
+		unsigned int m_batch_generation;
+
+		/** Count of background workers still executing current batch */
+		unsigned int m_busy_workers_count;
+
+		/** True = workers should exit */
+		bool m_stopping;
+	};
+}
+
+#endif // LANTERN_THREAD_POOL_H
\ No newline at end of file
@@ -1,13 +1,13 @@
 #ifndef LANTERN_UI_LABEL_SHADER_H
 #define LANTERN_UI_LABEL_SHADER_H
 
-#include <vector>
 #include "shader_bind_point_info.h"
 #include "color.h"
 #include "vector2.h"
 #include "vector3.h"
 #include "vector4.h"
 #include "matrix4x4.h"
+#include "state_version.h"
 #include "mesh_attribute_info.h"
 #include "texture.h"
 
@@ -23,22 +23,22 @@ namespace lantern
 		/** Gets info about color bind points required by shader
 		* @returns Required color bind points
 		*/
-		std::vector<shader_bind_point_info<color>> get_color_bind_points();
+		static shader_bind_points<ui_label_shader, color> get_color_bind_points();
 
 		/** Gets info about float bind points required by shader
 		* @returns Required float bind points
 		*/
-		std::vector<shader_bind_point_info<float>> get_float_bind_points();
+		static shader_bind_points<ui_label_shader, float> get_float_bind_points();
 
 		/** Gets info about vector2f bind points required by shader
 		* @returns Required vector2f bind points
 		*/
-		std::vector<shader_bind_point_info<vector2f>> get_vector2f_bind_points();
+		static shader_bind_points<ui_label_shader, vector2f> get_vector2f_bind_points();
 
 		/** Gets info about vector3f bind points required by shader
 		* @returns Required vector3f bind points
 		*/
-		std::vector<shader_bind_point_info<vector3f>> get_vector3f_bind_points();
+		static shader_bind_points<ui_label_shader, vector3f> get_vector3f_bind_points();
 
 		/** Processes vertex
 		* @param vertex Vertex in local space
@@ -46,6 +46,11 @@ namespace lantern
 		*/
 		vector4f process_vertex(vector4f const& vertex);
 
+		/** Gets version of the state vertex processing depends on. Vertices are passed as is, so it never changes
+		* @returns State version
+		*/
+		uint64_t get_vertex_state_version() const;
+
 		/** Processes pixel
 		* @param pixel Pixel coordinates on screen
 		* @returns Final pixel color
@@ -73,25 +78,27 @@ namespace lantern
 		color m_color;
 	};
 
-	inline std::vector<shader_bind_point_info<color>> ui_label_shader::get_color_bind_points()
+	inline shader_bind_points<ui_label_shader, color> ui_label_shader::get_color_bind_points()
 	{
-		return std::vector<shader_bind_point_info<color>>{};
+		return shader_bind_points<ui_label_shader, color>{};
 	}
 
-	inline std::vector<shader_bind_point_info<float>> ui_label_shader::get_float_bind_points()
+	inline shader_bind_points<ui_label_shader, float> ui_label_shader::get_float_bind_points()
 	{
-		return std::vector<shader_bind_point_info<float>>{};
+		return shader_bind_points<ui_label_shader, float>{};
 	}
 
-	inline std::vector<shader_bind_point_info<vector2f>> ui_label_shader::get_vector2f_bind_points()
+	inline shader_bind_points<ui_label_shader, vector2f> ui_label_shader::get_vector2f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector2f>>{
-			shader_bind_point_info<vector2f> { TEXCOORD_ATTR_ID, &m_uv }};
+		static shader_bind_point_info<ui_label_shader, vector2f> const bind_points[]{
+			shader_bind_point_info<ui_label_shader, vector2f>{TEXCOORD_ATTR_ID, &ui_label_shader::m_uv}};
+
+		return shader_bind_points<ui_label_shader, vector2f>{bind_points};
 	}
 
-	inline std::vector<shader_bind_point_info<vector3f>> ui_label_shader::get_vector3f_bind_points()
+	inline shader_bind_points<ui_label_shader, vector3f> ui_label_shader::get_vector3f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector3f>>{};
+		return shader_bind_points<ui_label_shader, vector3f>{};
 	}
 
 	inline vector4f ui_label_shader::process_vertex(vector4f const& vertex)
@@ -99,6 +106,13 @@ namespace lantern
 		return vertex;
 	}
 
+	inline uint64_t ui_label_shader::get_vertex_state_version() const
+	{
+		static uint64_t const version{get_next_state_version()};
+
+		return version;
+	}
+
 	inline color ui_label_shader::process_pixel(vector2ui const& pixel)
 	{
 		color symbol_color = m_symbol_texture->get_pixel_color(
@@ -13,6 +13,7 @@ app::app(unsigned int const width, unsigned int const height)
 	  m_sdl_renderer{nullptr},
 	  m_sdl_target_texture{nullptr},
 	  m_target_texture{width, height},
+	  m_target_depth_buffer{width, height},
 	  m_target_framerate_delay{0},
 	  m_last_fps{0},
 #ifdef _WIN32
@@ -165,9 +166,15 @@ int app::start()
 		// Clear texture with black
 		m_target_texture.clear(0);
 
+		// Reset depth buffer to the far plane
+		m_target_depth_buffer.clear(depth_buffer::FAR_DEPTH);
+
 		// Execute frame
 		frame(delta_since_last_frame / 1000.0f);
 
+		// Execute draws recorded during the frame
+		m_draw_list.execute(m_renderer);
+
 		// Sum up passed time
 		time_accumulator += delta_since_last_frame;
 
@@ -236,11 +243,21 @@ texture& app::get_target_texture()
 	return m_target_texture;
 }
 
+depth_buffer& app::get_target_depth_buffer()
+{
+	return m_target_depth_buffer;
+}
+
 renderer& app::get_renderer()
 {
 	return m_renderer;
 }
 
+draw_list& app::get_draw_list()
+{
+	return m_draw_list;
+}
+
 void app::on_key_down(SDL_Keysym const)
 {
 	// Does not handle any key by default
@@ -0,0 +1,45 @@
+#include "attributes_interpolator.h"
+
+using namespace lantern;
+
+attributes_interpolator::attributes_interpolator()
+	: m_binded_attributes{nullptr},
+	  m_linear_components_count{0}
+{
+
+}
+
+void attributes_interpolator::setup(
+	binded_mesh_attributes const& binded_attributes,
+	unsigned int const index0, unsigned int const index1, unsigned int const index2)
+{
+	m_binded_attributes = &binded_attributes;
+
+	m_vertex1_values.clear();
+	m_vertex0_differences.clear();
+	m_vertex2_differences.clear();
+
+	m_color_offsets.resize(binded_attributes.color_attributes.size());
+	m_float_offsets.resize(binded_attributes.float_attributes.size());
+	m_vector2f_offsets.resize(binded_attributes.vector2f_attributes.size());
+	m_vector3f_offsets.resize(binded_attributes.vector3f_attributes.size());
+
+	// Interpolation option is resolved here: linearly interpolated components go first
+	//
+
+	attribute_interpolation_option const linear{attribute_interpolation_option::linear};
+	setup_attributes(binded_attributes.color_attributes, index0, index1, index2, linear, m_color_offsets);
+	setup_attributes(binded_attributes.float_attributes, index0, index1, index2, linear, m_float_offsets);
+	setup_attributes(binded_attributes.vector2f_attributes, index0, index1, index2, linear, m_vector2f_offsets);
+	setup_attributes(binded_attributes.vector3f_attributes, index0, index1, index2, linear, m_vector3f_offsets);
+
+	m_linear_components_count = static_cast<unsigned int>(m_vertex1_values.size());
+
+	attribute_interpolation_option const perspective_correct{attribute_interpolation_option::perspective_correct};
+	setup_attributes(binded_attributes.color_attributes, index0, index1, index2, perspective_correct, m_color_offsets);
+	setup_attributes(binded_attributes.float_attributes, index0, index1, index2, perspective_correct, m_float_offsets);
+	setup_attributes(binded_attributes.vector2f_attributes, index0, index1, index2, perspective_correct, m_vector2f_offsets);
+	setup_attributes(binded_attributes.vector3f_attributes, index0, index1, index2, perspective_correct, m_vector3f_offsets);
+
+	m_interpolated_values.resize(m_vertex1_values.size());
+}
@@ -0,0 +1,28 @@
+#include <algorithm>
+#include "depth_buffer.h"
+
+using namespace lantern;
+
+float const depth_buffer::FAR_DEPTH = 1.0f;
+
+depth_buffer::depth_buffer(unsigned int const width, unsigned int const height)
+	: m_width{width},
+	m_height{height},
+	m_data(width * height, FAR_DEPTH)
+{
+}
+
+unsigned int depth_buffer::get_width() const
+{
+	return m_width;
+}
+
+unsigned int depth_buffer::get_height() const
+{
+	return m_height;
+}
+
+void depth_buffer::clear(float const depth)
+{
+	std::fill(m_data.begin(), m_data.end(), depth);
+}
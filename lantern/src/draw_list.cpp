@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "draw_list.h"
+
+using namespace lantern;
+
+/** Max value of ranks and layers stored in sort key */
+static unsigned int const MAX_KEY_RANK{255};
+
+/** Max depth value stored in sort key */
+static uint32_t const MAX_KEY_DEPTH{0xFFFFFF};
+
+/** Quantizes depth keeping its order: bit patterns of non-negative floats grow with their values
+* @param depth Depth
+* @returns 24-bit depth, zero for negative ones
+*/
+static uint32_t get_key_depth(float const depth)
+{
+	if (!(depth > 0.0f))
+	{
+		return 0;
+	}
+
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof(bits));
+
+	return bits >> 8;
+}
+
+uint64_t draw_list::get_sort_key(unsigned int const target_rank, draw_settings const& settings, unsigned int const shader_type_rank)
+{
+	uint64_t const target{std::min(target_rank, MAX_KEY_RANK)};
+	uint64_t const layer{std::min(settings.layer, MAX_KEY_RANK)};
+	uint64_t const shader_type{std::min(shader_type_rank, MAX_KEY_RANK)};
+	uint64_t const depth{get_key_depth(settings.depth)};
+
+	bool const is_opaque{!settings.alpha_blending_enabled && (settings.target_depth_buffer != nullptr)};
+
+	uint64_t key{(target << 56) | (layer << 48)};
+	if (is_opaque)
+	{
+		// Front-to-back, draws in the same coarse depth range are grouped by shader type
+		//
+		key |= ((depth >> 12) << 20) | (shader_type << 12) | (depth & 0xFFF);
+	}
+	else
+	{
+		// Back-to-front, after opaque draws
+		//
+		key |= (uint64_t{1} << 40) | ((MAX_KEY_DEPTH - depth) << 8) | shader_type;
+	}
+
+	return key;
+}
+
+void draw_list::add_command(draw_settings const& settings, uint64_t const shader_type_version, std::function<void(renderer&)> draw)
+{
+	unsigned int const target_rank{get_rank<texture const*>(m_targets, settings.target_texture)};
+	unsigned int const shader_type_rank{get_rank(m_shader_types, shader_type_version)};
+
+	m_commands.push_back(
+		draw_command{
+			get_sort_key(target_rank, settings, shader_type_rank),
+			settings.alpha_blending_enabled,
+			std::move(draw)});
+}
+
+void draw_list::execute(renderer& pipeline)
+{
+	std::stable_sort(
+		m_commands.begin(),
+		m_commands.end(),
+		[](draw_command const& a, draw_command const& b)
+		{
+			return a.sort_key < b.sort_key;
+		});
+
+	merging_stage& merging = pipeline.get_merging_stage();
+	bool const initial_alpha_blending_enabled{merging.get_alpha_blending_enabled()};
+
+	bool alpha_blending_enabled{initial_alpha_blending_enabled};
+	for (draw_command& command : m_commands)
+	{
+		if (command.alpha_blending_enabled != alpha_blending_enabled)
+		{
+			alpha_blending_enabled = command.alpha_blending_enabled;
+			merging.set_alpha_blending_enabled(alpha_blending_enabled);
+		}
+
+		command.draw(pipeline);
+	}
+
+	merging.set_alpha_blending_enabled(initial_alpha_blending_enabled);
+
+	clear();
+}
+
+void draw_list::clear()
+{
+	m_commands.clear();
+	m_targets.clear();
+	m_shader_types.clear();
+}
+
+size_t draw_list::size() const
+{
+	return m_commands.size();
+}
@@ -0,0 +1,24 @@
+#include <cmath>
+#include "fixed_point_edge.h"
+
+using namespace lantern;
+
+fixed_point_edge::fixed_point_edge(int64_t const x0, int64_t const y0, int64_t const x1, int64_t const y1)
+	: m_a{-(y1 - y0)},
+	  m_b{x1 - x0},
+	  m_c{(y1 - y0) * x0 - (x1 - x0) * y0}
+{
+	step_x = m_a * SUBPIXEL_STEPS;
+	step_y = m_b * SUBPIXEL_STEPS;
+
+	// Same convention as floating point traversal uses: edge with normal pointing right is a left one,
+	// horizontal edge with normal pointing along y axis is a top one. Pixel centers lying exactly on other edges are not covered
+	//
+	bool const is_top_left{(m_a > 0) || ((m_a == 0) && (m_b > 0))};
+	m_bias = is_top_left ? 0 : -1;
+}
+
+int64_t fixed_point_edge::snap(float const value)
+{
+	return static_cast<int64_t>(std::floor(value * SUBPIXEL_STEPS + 0.5f));
+}
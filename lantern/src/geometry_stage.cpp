@@ -1,8 +1,342 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 #include "geometry_stage.h"
 
 using namespace lantern;
 
 geometry_stage::geometry_stage()
+	: m_uncached_transformed_vertices{0, 0, 0, 0, 0, 0, false, 0},
+	  m_transformed_vertices_cache_size{0},
+	  m_current_transformed_vertices{nullptr},
+	  m_face_culling{face_culling_option::none},
+	  m_front_face_winding_order{winding_order_option::counterclockwise},
+	  m_counters{0, 0, 0, 0, 0, 0, 0},
+	  m_invocation_number{0}
 {
 
+}
+
+void geometry_stage::set_face_culling(face_culling_option const option)
+{
+	m_face_culling = option;
+}
+
+face_culling_option geometry_stage::get_face_culling() const
+{
+	return m_face_culling;
+}
+
+void geometry_stage::set_front_face_winding_order(winding_order_option const option)
+{
+	m_front_face_winding_order = option;
+}
+
+winding_order_option geometry_stage::get_front_face_winding_order() const
+{
+	return m_front_face_winding_order;
+}
+
+geometry_stage_counters const& geometry_stage::get_counters() const
+{
+	return m_counters;
+}
+
+void geometry_stage::reset_counters()
+{
+	m_counters = geometry_stage_counters{0, 0, 0, 0, 0, 0, 0};
+}
+
+void geometry_stage::set_transformed_vertices_cache_size(size_t const size)
+{
+	m_transformed_vertices_cache_size = size;
+
+	if (m_transformed_vertices_cache.size() > size)
+	{
+		// Keep the most recently used vertices
+		//
+
+		std::sort(
+			m_transformed_vertices_cache.begin(),
+			m_transformed_vertices_cache.end(),
+			[](transformed_vertices_info const& a, transformed_vertices_info const& b) { return a.last_use_invocation_number > b.last_use_invocation_number; });
+
+		m_transformed_vertices_cache.erase(m_transformed_vertices_cache.begin() + size, m_transformed_vertices_cache.end());
+	}
+}
+
+size_t geometry_stage::get_transformed_vertices_cache_size() const
+{
+	return m_transformed_vertices_cache_size;
+}
+
+void geometry_stage::invalidate_transformed_vertices_cache()
+{
+	m_transformed_vertices_cache.clear();
+}
+
+void geometry_stage::invalidate_transformed_vertices_cache(mesh const& m)
+{
+	uint64_t const mesh_version{m.get_version()};
+
+	m_transformed_vertices_cache.erase(
+		std::remove_if(
+			m_transformed_vertices_cache.begin(),
+			m_transformed_vertices_cache.end(),
+			[mesh_version](transformed_vertices_info const& info) { return info.mesh_version == mesh_version; }),
+		m_transformed_vertices_cache.end());
+}
+
+void geometry_stage::start_invocation(mesh const& mesh, size_t const index_offset, size_t const index_count)
+{
+	if (index_offset + index_count > mesh.get_indices().size())
+	{
+		throw std::out_of_range("Indices range is out of mesh indices");
+	}
+
+	++m_invocation_number;
+	if (m_invocation_number == 0)
+	{
+		std::fill(m_vertices_marks.begin(), m_vertices_marks.end(), 0);
+		m_invocation_number = 1;
+	}
+
+	m_clipped_vertices.clear();
+}
+
+void geometry_stage::collect_referenced_vertices(mesh const& mesh, size_t const index_offset, size_t const index_count)
+{
+	std::vector<unsigned int> const& indices = mesh.get_indices();
+	size_t const indices_end{index_offset + index_count};
+
+	// Vertex is marked as collected by writing current invocation number, so that marks don't need to be cleared
+	//
+
+	if (m_vertices_marks.size() < mesh.get_vertices().size())
+	{
+		m_vertices_marks.resize(mesh.get_vertices().size(), 0);
+	}
+
+	m_referenced_vertices_storage.clear();
+
+	for (size_t i{index_offset}; i < indices_end; ++i)
+	{
+		unsigned int const index{indices[i]};
+
+		unsigned int& mark = m_vertices_marks.at(index);
+		if (mark != m_invocation_number)
+		{
+			mark = m_invocation_number;
+			m_referenced_vertices_storage.push_back(index);
+		}
+	}
+}
+
+geometry_stage::transformed_vertices_info& geometry_stage::get_transformed_vertices(
+	uint64_t const mesh_version,
+	uint64_t const shader_state_version,
+	size_t const index_offset,
+	size_t const index_count,
+	unsigned int const width,
+	unsigned int const height,
+	bool const do_homogeneous_division)
+{
+	if ((m_transformed_vertices_cache_size == 0) || (shader_state_version == 0))
+	{
+		m_uncached_transformed_vertices.shader_state_version = 0;
+		return m_uncached_transformed_vertices;
+	}
+
+	transformed_vertices_info* least_recently_used{nullptr};
+
+	for (transformed_vertices_info& info : m_transformed_vertices_cache)
+	{
+		if ((info.mesh_version == mesh_version) &&
+			(info.shader_state_version == shader_state_version) &&
+			(info.index_offset == index_offset) &&
+			(info.index_count == index_count) &&
+			(info.width == width) &&
+			(info.height == height) &&
+			(info.do_homogeneous_division == do_homogeneous_division))
+		{
+			info.last_use_invocation_number = m_invocation_number;
+			return info;
+		}
+
+		if ((least_recently_used == nullptr) || (info.last_use_invocation_number < least_recently_used->last_use_invocation_number))
+		{
+			least_recently_used = &info;
+		}
+	}
+
+	// Vertices are not cached, take new storage or reuse the least recently used one
+	//
+
+	if (m_transformed_vertices_cache.size() < m_transformed_vertices_cache_size)
+	{
+		m_transformed_vertices_cache.push_back(transformed_vertices_info{});
+		least_recently_used = &m_transformed_vertices_cache.back();
+	}
+
+	transformed_vertices_info& result = *least_recently_used;
+	result.mesh_version = mesh_version;
+	result.shader_state_version = 0;
+	result.index_offset = index_offset;
+	result.index_count = index_count;
+	result.width = width;
+	result.height = height;
+	result.do_homogeneous_division = do_homogeneous_division;
+	result.last_use_invocation_number = m_invocation_number;
+
+	return result;
+}
+
+std::vector<clipped_vertex_info> const& geometry_stage::get_clipped_vertices() const
+{
+	return m_clipped_vertices;
+}
+
+bool geometry_stage::is_triangle_culled(
+	vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+	bool const do_homogeneous_division)
+{
+	// Get screen space coordinates. Vertices passed to homogeneous rasterization are not divided by w yet,
+	// but after clipping w is positive, so the division doesn't change anything but scale
+	//
+
+	float const w0_inversed{do_homogeneous_division ? 1.0f / vertex0.w : 1.0f};
+	float const w1_inversed{do_homogeneous_division ? 1.0f / vertex1.w : 1.0f};
+	float const w2_inversed{do_homogeneous_division ? 1.0f / vertex2.w : 1.0f};
+
+	float const x0{vertex0.x * w0_inversed};
+	float const y0{vertex0.y * w0_inversed};
+	float const x1{vertex1.x * w1_inversed};
+	float const y1{vertex1.y * w1_inversed};
+	float const x2{vertex2.x * w2_inversed};
+	float const y2{vertex2.y * w2_inversed};
+
+	// Screen space y axis goes down, so counterclockwise triangles in NDC have negative doubled area here
+	//
+	float const doubled_signed_area{(x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0)};
+
+	if (std::abs(doubled_signed_area) < FLOAT_EPSILON)
+	{
+		++m_counters.culled_degenerate_triangles_count;
+		return true;
+	}
+
+	if (m_face_culling != face_culling_option::none)
+	{
+		bool const is_counterclockwise{doubled_signed_area < 0.0f};
+		bool const is_front_facing{is_counterclockwise == (m_front_face_winding_order == winding_order_option::counterclockwise)};
+
+		if (is_front_facing == (m_face_culling == face_culling_option::front))
+		{
+			++m_counters.culled_by_facing_triangles_count;
+			return true;
+		}
+	}
+
+	// Pixel centers have coordinates of k + 0.5, check if there is any of them inside the bounding box
+	//
+
+	float const min_x{std::min(std::min(x0, x1), x2)};
+	float const max_x{std::max(std::max(x0, x1), x2)};
+	float const min_y{std::min(std::min(y0, y1), y2)};
+	float const max_y{std::max(std::max(y0, y1), y2)};
+
+	if ((std::ceil(min_x - 0.5f) > std::floor(max_x - 0.5f)) || (std::ceil(min_y - 0.5f) > std::floor(max_y - 0.5f)))
+	{
+		++m_counters.culled_without_pixel_centers_triangles_count;
+		return true;
+	}
+
+	++m_counters.passed_triangles_count;
+	return false;
+}
+
+unsigned int geometry_stage::clip_triangle(
+	unsigned int const index0, unsigned int const index1, unsigned int const index2,
+	unsigned int const planes_mask,
+	polygon_vertex* result) const
+{
+	// Two buffers are swapped on every plane, polygon gets at most one vertex more after each plane
+	//
+
+	polygon_vertex buffer[MAX_CLIPPED_POLYGON_SIZE];
+
+	polygon_vertex* input{result};
+	polygon_vertex* output{buffer};
+
+	input[0] = polygon_vertex{m_current_transformed_vertices->clip_space_vertices[index0], {1.0f, 0.0f, 0.0f}, index0};
+	input[1] = polygon_vertex{m_current_transformed_vertices->clip_space_vertices[index1], {0.0f, 1.0f, 0.0f}, index1};
+	input[2] = polygon_vertex{m_current_transformed_vertices->clip_space_vertices[index2], {0.0f, 0.0f, 1.0f}, index2};
+	unsigned int input_size{3};
+
+	// Near plane goes first: after it every vertex has positive w
+	//
+	unsigned int const planes_order[6]{4, 0, 1, 2, 3, 5};
+
+	for (unsigned int const plane_index : planes_order)
+	{
+		if ((planes_mask & (1 << plane_index)) == 0)
+		{
+			continue;
+		}
+
+		unsigned int output_size{0};
+
+		for (unsigned int i{0}; i < input_size; ++i)
+		{
+			polygon_vertex const& current = input[i];
+			polygon_vertex const& next = input[(i + 1) % input_size];
+
+			float const current_distance{get_plane_distance(current.position, plane_index)};
+			float const next_distance{get_plane_distance(next.position, plane_index)};
+
+			if (current_distance >= 0.0f)
+			{
+				output[output_size++] = current;
+			}
+
+			if ((current_distance >= 0.0f) != (next_distance >= 0.0f))
+			{
+				// Edge crosses the plane, add intersection point
+				//
+
+				float const t{current_distance / (current_distance - next_distance)};
+
+				polygon_vertex& intersection = output[output_size++];
+				intersection.position = vector4f{
+					current.position.x + (next.position.x - current.position.x) * t,
+					current.position.y + (next.position.y - current.position.y) * t,
+					current.position.z + (next.position.z - current.position.z) * t,
+					current.position.w + (next.position.w - current.position.w) * t};
+
+				for (unsigned int k{0}; k < 3; ++k)
+				{
+					intersection.weights[k] = current.weights[k] + (next.weights[k] - current.weights[k]) * t;
+				}
+
+				intersection.index = NOT_MESH_VERTEX_INDEX;
+			}
+		}
+
+		std::swap(input, output);
+		input_size = output_size;
+
+		if (input_size < 3)
+		{
+			return 0;
+		}
+	}
+
+	// Make sure the result is in the passed storage
+	//
+	if (input != result)
+	{
+		std::copy(input, input + input_size, result);
+	}
+
+	return input_size;
 }
\ No newline at end of file
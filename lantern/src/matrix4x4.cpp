@@ -1,6 +1,11 @@
 #include <stddef.h>
 #include "matrix4x4.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define LANTERN_MATRIX4X4_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace lantern;
 
 matrix4x4f const matrix4x4f::IDENTITY = matrix4x4f{
@@ -169,3 +174,47 @@ matrix4x4f matrix4x4f::clip_space(float const hfov, float const vfov, float cons
 			(left + right) / (left - right), (bottom + top) / (bottom - top), (far + near) / (far - near), 1.0f,
 			0.0f, 0.0f, -2.0f * near * far / (far - near), 0.0f};
 }
+
+void lantern::transform_vectors(vector4f const* const input, vector4f* const output, size_t const count, matrix4x4f const& m)
+{
+	size_t i{0};
+
+#ifdef LANTERN_MATRIX4X4_SSE2
+	static_assert(sizeof(vector4f) == 4 * sizeof(float), "vector4f is expected to be four tightly packed floats");
+
+	for (; i + 4 <= count; i += 4)
+	{
+		// Transpose four vectors so that every register holds one coordinate of all of them
+		//
+
+		__m128 xs{_mm_loadu_ps(&input[i + 0].x)};
+		__m128 ys{_mm_loadu_ps(&input[i + 1].x)};
+		__m128 zs{_mm_loadu_ps(&input[i + 2].x)};
+		__m128 ws{_mm_loadu_ps(&input[i + 3].x)};
+		_MM_TRANSPOSE4_PS(xs, ys, zs, ws);
+
+		// Terms are summed in the same order scalar multiplication uses, so that results are exactly the same
+		//
+
+		__m128 results[4];
+		for (size_t j{0}; j < 4; ++j)
+		{
+			__m128 sum{_mm_mul_ps(xs, _mm_set1_ps(m.values[0][j]))};
+			sum = _mm_add_ps(sum, _mm_mul_ps(ys, _mm_set1_ps(m.values[1][j])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(zs, _mm_set1_ps(m.values[2][j])));
+			results[j] = _mm_add_ps(sum, _mm_mul_ps(ws, _mm_set1_ps(m.values[3][j])));
+		}
+
+		_MM_TRANSPOSE4_PS(results[0], results[1], results[2], results[3]);
+		_mm_storeu_ps(&output[i + 0].x, results[0]);
+		_mm_storeu_ps(&output[i + 1].x, results[1]);
+		_mm_storeu_ps(&output[i + 2].x, results[2]);
+		_mm_storeu_ps(&output[i + 3].x, results[3]);
+	}
+#endif
+
+	for (; i < count; ++i)
+	{
+		output[i] = input[i] * m;
+	}
+}
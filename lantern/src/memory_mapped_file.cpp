@@ -0,0 +1,153 @@
+#include <stdexcept>
+#include "memory_mapped_file.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace lantern;
+
+#ifdef _WIN32
+
+memory_mapped_file::memory_mapped_file(std::string const& path)
+	: m_data{nullptr},
+	  m_size{0},
+	  m_file_handle{INVALID_HANDLE_VALUE},
+	  m_mapping_handle{nullptr}
+{
+	m_file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file_handle == INVALID_HANDLE_VALUE)
+	{
+		throw std::runtime_error("Could not open file: " + path);
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file_handle, &size))
+	{
+		close();
+		throw std::runtime_error("Could not get size of file: " + path);
+	}
+
+	m_size = static_cast<size_t>(size.QuadPart);
+
+	// Empty files can't be mapped
+	//
+	if (m_size == 0)
+	{
+		return;
+	}
+
+	m_mapping_handle = CreateFileMappingA(m_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping_handle != nullptr)
+	{
+		m_data = static_cast<char const*>(MapViewOfFile(m_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+	}
+
+	if (m_data == nullptr)
+	{
+		close();
+		throw std::runtime_error("Could not map file: " + path);
+	}
+}
+
+void memory_mapped_file::close()
+{
+	if (m_data != nullptr)
+	{
+		UnmapViewOfFile(m_data);
+		m_data = nullptr;
+	}
+
+	if (m_mapping_handle != nullptr)
+	{
+		CloseHandle(m_mapping_handle);
+		m_mapping_handle = nullptr;
+	}
+
+	if (m_file_handle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file_handle);
+		m_file_handle = INVALID_HANDLE_VALUE;
+	}
+}
+
+#else
+
+memory_mapped_file::memory_mapped_file(std::string const& path)
+	: m_data{nullptr},
+	  m_size{0},
+	  m_file_descriptor{-1}
+{
+	m_file_descriptor = open(path.c_str(), O_RDONLY);
+	if (m_file_descriptor == -1)
+	{
+		throw std::runtime_error("Could not open file: " + path);
+	}
+
+	struct stat file_status;
+	if (fstat(m_file_descriptor, &file_status) != 0)
+	{
+		close();
+		throw std::runtime_error("Could not get size of file: " + path);
+	}
+
+	m_size = static_cast<size_t>(file_status.st_size);
+
+	// Empty files can't be mapped
+	//
+	if (m_size == 0)
+	{
+		return;
+	}
+
+	void* const data{mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file_descriptor, 0)};
+	if (data == MAP_FAILED)
+	{
+		close();
+		throw std::runtime_error("Could not map file: " + path);
+	}
+
+	m_data = static_cast<char const*>(data);
+
+	// File is usually read from the beginning to the end
+	madvise(data, m_size, MADV_SEQUENTIAL);
+}
+
+void memory_mapped_file::close()
+{
+	if (m_data != nullptr)
+	{
+		munmap(const_cast<char*>(m_data), m_size);
+		m_data = nullptr;
+	}
+
+	if (m_file_descriptor != -1)
+	{
+		::close(m_file_descriptor);
+		m_file_descriptor = -1;
+	}
+}
+
+#endif
+
+memory_mapped_file::~memory_mapped_file()
+{
+	close();
+}
+
+char const* memory_mapped_file::get_data() const
+{
+	return m_data;
+}
+
+size_t memory_mapped_file::get_size() const
+{
+	return m_size;
+}
@@ -3,7 +3,10 @@
 using namespace lantern;
 
 merging_stage::merging_stage()
-	: m_alpha_blending_enabled{false}
+	: m_alpha_blending_enabled{false},
+	  m_depth_test_function{depth_test_function_option::less},
+	  m_depth_write_enabled{true},
+	  m_depth_buffer{nullptr}
 {
 
 }
@@ -16,4 +19,34 @@ bool merging_stage::get_alpha_blending_enabled() const
 void merging_stage::set_alpha_blending_enabled(bool const enabled)
 {
 	m_alpha_blending_enabled = enabled;
+}
+
+depth_test_function_option merging_stage::get_depth_test_function() const
+{
+	return m_depth_test_function;
+}
+
+void merging_stage::set_depth_test_function(depth_test_function_option const function)
+{
+	m_depth_test_function = function;
+}
+
+bool merging_stage::get_depth_write_enabled() const
+{
+	return m_depth_write_enabled;
+}
+
+void merging_stage::set_depth_write_enabled(bool const enabled)
+{
+	m_depth_write_enabled = enabled;
+}
+
+depth_buffer* merging_stage::get_depth_buffer() const
+{
+	return m_depth_buffer;
+}
+
+void merging_stage::set_depth_buffer(depth_buffer* buffer)
+{
+	m_depth_buffer = buffer;
 }
\ No newline at end of file
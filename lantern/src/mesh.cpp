@@ -1,14 +1,18 @@
+#include <stdexcept>
+#include <utility>
 #include "mesh.h"
+#include "state_version.h"
 
 using namespace lantern;
 
 mesh::mesh()
+	: m_version{get_next_state_version()}
 {
 
 }
 
 mesh::mesh(std::vector<vector3f> vertices, std::vector<unsigned int> indices)
-	: m_vertices(vertices), m_indices(indices)
+	: m_vertices(std::move(vertices)), m_indices(std::move(indices)), m_version{get_next_state_version()}
 {
 
 }
@@ -71,4 +75,201 @@ std::vector<mesh_attribute_info<vector3f>>& mesh::get_vector3f_attributes()
 std::vector<mesh_attribute_info<vector3f>> const& mesh::get_vector3f_attributes() const
 {
 	return m_vector3f_attributes;
-}
\ No newline at end of file
+}
+
+std::vector<submesh>& mesh::get_submeshes()
+{
+	return m_submeshes;
+}
+
+std::vector<submesh> const& mesh::get_submeshes() const
+{
+	return m_submeshes;
+}
+
+uint64_t mesh::get_version() const
+{
+	return m_version;
+}
+
+void mesh::mark_changed()
+{
+	m_version = get_next_state_version();
+}
+
+// Mesh compilation
+//
+
+/** Gets attribute indices of triangles corners
+* @param attribute_info Attribute to get indices of
+* @param source Mesh the attribute belongs to
+* @returns Indices going in parallel with mesh indices
+*/
+template<typename TAttr>
+static std::vector<unsigned int> const& get_corners_attribute_indices(mesh_attribute_info<TAttr> const& attribute_info, mesh const& source)
+{
+	std::vector<unsigned int> const& indices = attribute_info.get_indices();
+
+	// Attribute is already indexed by vertices indices
+	//
+	if (indices.empty())
+	{
+		return source.get_indices();
+	}
+
+	if (indices.size() != source.get_indices().size())
+	{
+		throw std::runtime_error("Attribute indices count doesn't match mesh indices count");
+	}
+
+	return indices;
+}
+
+/** Adds attributes indices of triangles corners to the list
+* @param attributes Attributes to add indices of
+* @param source Mesh the attributes belong to
+* @param corners_indices List to add indices to
+*/
+template<typename TAttr>
+static void add_corners_attributes_indices(
+	std::vector<mesh_attribute_info<TAttr>> const& attributes,
+	mesh const& source,
+	std::vector<std::vector<unsigned int> const*>& corners_indices)
+{
+	for (mesh_attribute_info<TAttr> const& attribute_info : attributes)
+	{
+		corners_indices.push_back(&get_corners_attribute_indices(attribute_info, source));
+	}
+}
+
+/** Copies attributes to compiled mesh, putting their values per vertex
+* @param attributes Source mesh attributes
+* @param source Source mesh
+* @param vertices_corners Index of the first triangle corner referencing every compiled mesh vertex
+* @param result Compiled mesh attributes storage
+*/
+template<typename TAttr>
+static void compile_attributes(
+	std::vector<mesh_attribute_info<TAttr>> const& attributes,
+	mesh const& source,
+	std::vector<unsigned int> const& vertices_corners,
+	std::vector<mesh_attribute_info<TAttr>>& result)
+{
+	for (mesh_attribute_info<TAttr> const& attribute_info : attributes)
+	{
+		std::vector<TAttr> const& data = attribute_info.get_data();
+		std::vector<unsigned int> const& corners_indices = get_corners_attribute_indices(attribute_info, source);
+
+		std::vector<TAttr> vertices_data;
+		vertices_data.reserve(vertices_corners.size());
+
+		for (unsigned int const corner : vertices_corners)
+		{
+			vertices_data.push_back(data.at(corners_indices[corner]));
+		}
+
+		result.push_back(
+			mesh_attribute_info<TAttr>{
+				attribute_info.get_id(),
+				std::move(vertices_data),
+				std::vector<unsigned int>{},
+				attribute_info.get_interpolation_option()});
+	}
+}
+
+mesh lantern::compile_mesh(mesh const& source)
+{
+	std::vector<unsigned int> const& source_indices = source.get_indices();
+	size_t const corners_count{source_indices.size()};
+
+	// Indices lists every corner is described by, position index goes first
+	//
+
+	std::vector<std::vector<unsigned int> const*> corners_indices;
+	corners_indices.push_back(&source_indices);
+	add_corners_attributes_indices(source.get_color_attributes(), source, corners_indices);
+	add_corners_attributes_indices(source.get_float_attributes(), source, corners_indices);
+	add_corners_attributes_indices(source.get_vector2f_attributes(), source, corners_indices);
+	add_corners_attributes_indices(source.get_vector3f_attributes(), source, corners_indices);
+
+	size_t const lists_count{corners_indices.size()};
+
+	// Find distinct corners using open addressing hash table of vertices,
+	// vertex is represented by the first corner referencing it
+	//
+
+	size_t table_size{1};
+	while (table_size < corners_count * 2)
+	{
+		table_size *= 2;
+	}
+
+	unsigned int const EMPTY_SLOT{0xFFFFFFFF};
+	std::vector<unsigned int> table(table_size, EMPTY_SLOT);
+
+	std::vector<unsigned int> vertices_corners;
+	std::vector<unsigned int> indices;
+	indices.reserve(corners_count);
+
+	for (size_t corner{0}; corner < corners_count; ++corner)
+	{
+		size_t hash{2166136261u};
+		for (size_t i{0}; i < lists_count; ++i)
+		{
+			hash = (hash ^ (*corners_indices[i])[corner]) * 16777619u;
+		}
+
+		size_t slot{hash & (table_size - 1)};
+		while (true)
+		{
+			unsigned int const vertex_index{table[slot]};
+			if (vertex_index == EMPTY_SLOT)
+			{
+				table[slot] = static_cast<unsigned int>(vertices_corners.size());
+				indices.push_back(table[slot]);
+				vertices_corners.push_back(static_cast<unsigned int>(corner));
+				break;
+			}
+
+			unsigned int const vertex_corner{vertices_corners[vertex_index]};
+
+			bool equal{true};
+			for (size_t i{0}; (i < lists_count) && equal; ++i)
+			{
+				equal = ((*corners_indices[i])[corner] == (*corners_indices[i])[vertex_corner]);
+			}
+
+			if (equal)
+			{
+				indices.push_back(vertex_index);
+				break;
+			}
+
+			slot = (slot + 1) & (table_size - 1);
+		}
+	}
+
+	// Build the result
+	//
+
+	std::vector<vector3f> const& source_vertices = source.get_vertices();
+
+	std::vector<vector3f> vertices;
+	vertices.reserve(vertices_corners.size());
+	for (unsigned int const corner : vertices_corners)
+	{
+		vertices.push_back(source_vertices.at(source_indices[corner]));
+	}
+
+	mesh result{std::move(vertices), std::move(indices)};
+	compile_attributes(source.get_color_attributes(), source, vertices_corners, result.get_color_attributes());
+	compile_attributes(source.get_float_attributes(), source, vertices_corners, result.get_float_attributes());
+	compile_attributes(source.get_vector2f_attributes(), source, vertices_corners, result.get_vector2f_attributes());
+	compile_attributes(source.get_vector3f_attributes(), source, vertices_corners, result.get_vector3f_attributes());
+
+	// Triangles keep their order, so do submeshes ranges
+	//
+	result.get_submeshes() = source.get_submeshes();
+
+	return result;
+}
@@ -0,0 +1,405 @@
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include "memory_mapped_file.h"
+#include "mesh_binary.h"
+
+using namespace lantern;
+
+// File layout
+//
+
+/** Identifies binary mesh files */
+static char const BINARY_MESH_SIGNATURE[8]{'L', 'N', 'T', 'M', 'E', 'S', 'H', '\0'};
+
+/** Increased every time layout changes */
+static uint32_t const BINARY_MESH_VERSION{2};
+
+/** Written in native byte order to detect files written on machines with another one */
+static uint32_t const BINARY_MESH_BYTE_ORDER_MARK{0x01020304};
+
+/** Attribute types stored in binary mesh file */
+enum class binary_mesh_attribute_type : uint32_t
+{
+	color,
+	float_value,
+	vector2f,
+	vector3f
+};
+
+/** Binary mesh file header */
+class binary_mesh_header final
+{
+public:
+	/** File signature */
+	char signature[8];
+
+	/** Layout version */
+	uint32_t version;
+
+	/** Byte order mark */
+	uint32_t byte_order_mark;
+
+	/** Information about the source file */
+	binary_mesh_source_info source_info;
+
+	/** Count of vertices */
+	uint32_t vertices_count;
+
+	/** Count of indices */
+	uint32_t indices_count;
+
+	/** Count of attributes blocks following vertices and indices */
+	uint32_t attributes_count;
+
+	/** Count of submeshes blocks following attributes blocks */
+	uint32_t submeshes_count;
+};
+
+/** Header of attribute block, followed by attribute data and indices */
+class binary_mesh_attribute_header final
+{
+public:
+	/** Type of attribute values */
+	binary_mesh_attribute_type type;
+
+	/** Size of one value in bytes */
+	uint32_t value_size;
+
+	/** Attribute id */
+	uint32_t id;
+
+	/** Interpolation option */
+	uint32_t interpolation_option;
+
+	/** Count of values */
+	uint32_t data_count;
+
+	/** Count of indices */
+	uint32_t indices_count;
+};
+
+/** Header of submesh block, followed by submesh name and material name */
+class binary_mesh_submesh_header final
+{
+public:
+	/** Index of the first mesh index in range */
+	uint32_t index_offset;
+
+	/** Count of indices in range */
+	uint32_t index_count;
+
+	/** Bounding box */
+	aabb<vector3f> bounding_box;
+
+	/** Length of name in bytes */
+	uint32_t name_length;
+
+	/** Length of material name in bytes */
+	uint32_t material_name_length;
+};
+
+// Writing
+//
+
+/** Writes array of values as is
+* @param stream Stream to write to
+* @param values Values to write
+*/
+template<typename T>
+static void write_values(std::ofstream& stream, std::vector<T> const& values)
+{
+	if (!values.empty())
+	{
+		stream.write(reinterpret_cast<char const*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+	}
+}
+
+/** Writes attributes blocks
+* @param stream Stream to write to
+* @param attributes Attributes to write
+* @param type Type of attributes values
+*/
+template<typename TAttr>
+static void write_attributes(std::ofstream& stream, std::vector<mesh_attribute_info<TAttr>> const& attributes, binary_mesh_attribute_type const type)
+{
+	for (mesh_attribute_info<TAttr> const& attribute_info : attributes)
+	{
+		binary_mesh_attribute_header const header{
+			type,
+			sizeof(TAttr),
+			attribute_info.get_id(),
+			static_cast<uint32_t>(attribute_info.get_interpolation_option()),
+			static_cast<uint32_t>(attribute_info.get_data().size()),
+			static_cast<uint32_t>(attribute_info.get_indices().size())};
+
+		stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+		write_values(stream, attribute_info.get_data());
+		write_values(stream, attribute_info.get_indices());
+	}
+}
+
+void lantern::save_mesh_to_binary(mesh const& m, std::string const& path, binary_mesh_source_info const& source_info)
+{
+	std::ofstream stream{path, std::ios::binary | std::ios::trunc};
+	if (!stream.is_open())
+	{
+		throw std::runtime_error("Could not open file for writing: " + path);
+	}
+
+	binary_mesh_header header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.signature, BINARY_MESH_SIGNATURE, sizeof(header.signature));
+	header.version = BINARY_MESH_VERSION;
+	header.byte_order_mark = BINARY_MESH_BYTE_ORDER_MARK;
+	header.source_info = source_info;
+	header.vertices_count = static_cast<uint32_t>(m.get_vertices().size());
+	header.indices_count = static_cast<uint32_t>(m.get_indices().size());
+	header.attributes_count = static_cast<uint32_t>(
+		m.get_color_attributes().size() +
+		m.get_float_attributes().size() +
+		m.get_vector2f_attributes().size() +
+		m.get_vector3f_attributes().size());
+	header.submeshes_count = static_cast<uint32_t>(m.get_submeshes().size());
+
+	stream.write(reinterpret_cast<char const*>(&header), sizeof(header));
+	write_values(stream, m.get_vertices());
+	write_values(stream, m.get_indices());
+	write_attributes(stream, m.get_color_attributes(), binary_mesh_attribute_type::color);
+	write_attributes(stream, m.get_float_attributes(), binary_mesh_attribute_type::float_value);
+	write_attributes(stream, m.get_vector2f_attributes(), binary_mesh_attribute_type::vector2f);
+	write_attributes(stream, m.get_vector3f_attributes(), binary_mesh_attribute_type::vector3f);
+
+	for (submesh const& s : m.get_submeshes())
+	{
+		binary_mesh_submesh_header const submesh_header{
+			s.index_offset,
+			s.index_count,
+			s.bounding_box,
+			static_cast<uint32_t>(s.name.size()),
+			static_cast<uint32_t>(s.material_name.size())};
+
+		stream.write(reinterpret_cast<char const*>(&submesh_header), sizeof(submesh_header));
+		stream.write(s.name.data(), static_cast<std::streamsize>(s.name.size()));
+		stream.write(s.material_name.data(), static_cast<std::streamsize>(s.material_name.size()));
+	}
+
+	if (!stream.good())
+	{
+		throw std::runtime_error("Could not write file: " + path);
+	}
+}
+
+// Reading
+//
+
+/** Sequential reader of mapped binary mesh file, checking that every block fits into the file */
+class binary_mesh_reader final
+{
+public:
+	/** Constructs reader
+	* @param file Mapped file
+	* @param path File path, used in error messages
+	*/
+	binary_mesh_reader(memory_mapped_file const& file, std::string const& path)
+		: m_position{file.get_data()}, m_end{file.get_data() + file.get_size()}, m_path(path)
+	{
+
+	}
+
+	/** Reads object copying its bytes
+	* @param value Object to read into
+	*/
+	template<typename T>
+	void read(T& value)
+	{
+		std::memcpy(&value, take(sizeof(T)), sizeof(T));
+	}
+
+	/** Reads array of values copying its bytes
+	* @param values Storage to read into
+	* @param count Count of values
+	*/
+	template<typename T>
+	void read(std::vector<T>& values, uint32_t const count)
+	{
+		char const* const data{take(static_cast<size_t>(count) * sizeof(T))};
+
+		values.resize(count);
+		if (count != 0)
+		{
+			std::memcpy(values.data(), data, static_cast<size_t>(count) * sizeof(T));
+		}
+	}
+
+	/** Throws exception about corrupted file */
+	void throw_corrupted() const
+	{
+		throw std::runtime_error("Corrupted binary mesh file: " + m_path);
+	}
+
+private:
+	/** Takes next block
+	* @param size Block size in bytes
+	* @returns Pointer to block data
+	*/
+	char const* take(size_t const size)
+	{
+		if (static_cast<size_t>(m_end - m_position) < size)
+		{
+			throw_corrupted();
+		}
+
+		char const* const data{m_position};
+		m_position += size;
+
+		return data;
+	}
+
+	/** Current position */
+	char const* m_position;
+
+	/** End of file content */
+	char const* const m_end;
+
+	/** File path */
+	std::string const m_path;
+};
+
+/** Reads and validates binary mesh header
+* @param reader Reader
+* @returns Header
+*/
+static binary_mesh_header read_header(binary_mesh_reader& reader)
+{
+	binary_mesh_header header;
+	reader.read(header);
+
+	if ((std::memcmp(header.signature, BINARY_MESH_SIGNATURE, sizeof(header.signature)) != 0) ||
+		(header.version != BINARY_MESH_VERSION) ||
+		(header.byte_order_mark != BINARY_MESH_BYTE_ORDER_MARK))
+	{
+		reader.throw_corrupted();
+	}
+
+	return header;
+}
+
+/** Reads attribute block
+* @param reader Reader
+* @param header Attribute block header
+* @param attributes Storage to add attribute to
+*/
+template<typename TAttr>
+static void read_attribute(binary_mesh_reader& reader, binary_mesh_attribute_header const& header, std::vector<mesh_attribute_info<TAttr>>& attributes)
+{
+	if ((header.value_size != sizeof(TAttr)) ||
+		(header.interpolation_option > static_cast<uint32_t>(attribute_interpolation_option::perspective_correct)))
+	{
+		reader.throw_corrupted();
+	}
+
+	std::vector<TAttr> data;
+	reader.read(data, header.data_count);
+
+	std::vector<unsigned int> indices;
+	reader.read(indices, header.indices_count);
+
+	attributes.push_back(
+		mesh_attribute_info<TAttr>{
+			header.id,
+			std::move(data),
+			std::move(indices),
+			static_cast<attribute_interpolation_option>(header.interpolation_option)});
+}
+
+mesh lantern::load_mesh_from_binary(std::string const& path)
+{
+	memory_mapped_file const file{path};
+	binary_mesh_reader reader{file, path};
+
+	binary_mesh_header const header{read_header(reader)};
+
+	std::vector<vector3f> vertices;
+	reader.read(vertices, header.vertices_count);
+
+	std::vector<unsigned int> indices;
+	reader.read(indices, header.indices_count);
+
+	mesh result{std::move(vertices), std::move(indices)};
+
+	for (uint32_t i{0}; i < header.attributes_count; ++i)
+	{
+		binary_mesh_attribute_header attribute_header;
+		reader.read(attribute_header);
+
+		switch (attribute_header.type)
+		{
+			case binary_mesh_attribute_type::color:
+				read_attribute(reader, attribute_header, result.get_color_attributes());
+				break;
+
+			case binary_mesh_attribute_type::float_value:
+				read_attribute(reader, attribute_header, result.get_float_attributes());
+				break;
+
+			case binary_mesh_attribute_type::vector2f:
+				read_attribute(reader, attribute_header, result.get_vector2f_attributes());
+				break;
+
+			case binary_mesh_attribute_type::vector3f:
+				read_attribute(reader, attribute_header, result.get_vector3f_attributes());
+				break;
+
+			default:
+				reader.throw_corrupted();
+		}
+	}
+
+	for (uint32_t i{0}; i < header.submeshes_count; ++i)
+	{
+		binary_mesh_submesh_header submesh_header;
+		reader.read(submesh_header);
+
+		if (static_cast<uint64_t>(submesh_header.index_offset) + submesh_header.index_count > header.indices_count)
+		{
+			reader.throw_corrupted();
+		}
+
+		std::vector<char> name;
+		reader.read(name, submesh_header.name_length);
+
+		std::vector<char> material_name;
+		reader.read(material_name, submesh_header.material_name_length);
+
+		result.get_submeshes().push_back(
+			submesh{
+				std::string(name.begin(), name.end()),
+				std::string(material_name.begin(), material_name.end()),
+				submesh_header.index_offset,
+				submesh_header.index_count,
+				submesh_header.bounding_box});
+	}
+
+	return result;
+}
+
+binary_mesh_source_info lantern::get_binary_mesh_source_info(std::string const& path)
+{
+	memory_mapped_file const file{path};
+	binary_mesh_reader reader{file, path};
+
+	return read_header(reader).source_info;
+}
+
+uint64_t lantern::get_content_hash(char const* const data, size_t const size)
+{
+	uint64_t hash{14695981039346656037ull};
+	for (size_t i{0}; i < size; ++i)
+	{
+		hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+	}
+
+	return hash;
+}
@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <stdexcept>
+#include "mesh_optimizer.h"
+
+using namespace lantern;
+
+/** Marks absence of a vertex */
+static unsigned int const NO_VERTEX{0xFFFFFFFF};
+
+/** Gets count of vertices triangles can reference
+* @param m Mesh
+* @returns Max of mesh vertices count and max index plus one
+*/
+static unsigned int get_referenced_vertices_count(mesh const& m)
+{
+	unsigned int count{static_cast<unsigned int>(m.get_vertices().size())};
+	for (unsigned int const index : m.get_indices())
+	{
+		count = std::max(count, index + 1);
+	}
+
+	return count;
+}
+
+/** Finds the next vertex to fan around after the traversal got into a dead-end
+* @param dead_end_stack Recently used vertices
+* @param live_triangles_counts Count of not emitted triangles of every vertex
+* @param cursor Vertex to start scanning from when there are no recently used vertices with live triangles
+* @returns Vertex index or NO_VERTEX if all the triangles are emitted
+*/
+static unsigned int skip_dead_end(
+	std::vector<unsigned int>& dead_end_stack,
+	std::vector<unsigned int> const& live_triangles_counts,
+	unsigned int& cursor)
+{
+	while (!dead_end_stack.empty())
+	{
+		unsigned int const vertex{dead_end_stack.back()};
+		dead_end_stack.pop_back();
+
+		if (live_triangles_counts[vertex] > 0)
+		{
+			return vertex;
+		}
+	}
+
+	unsigned int const vertices_count{static_cast<unsigned int>(live_triangles_counts.size())};
+	for (; cursor < vertices_count; ++cursor)
+	{
+		if (live_triangles_counts[cursor] > 0)
+		{
+			return cursor;
+		}
+	}
+
+	return NO_VERTEX;
+}
+
+/** Gets bounds of triangles ranges optimizations keep triangles inside, so that submeshes stay intact
+* @param m Mesh
+* @returns Sorted indices of the first triangle of every range, followed by count of triangles
+*/
+static std::vector<unsigned int> get_triangles_ranges_bounds(mesh const& m)
+{
+	unsigned int const triangles_count{static_cast<unsigned int>(m.get_indices().size() / 3)};
+
+	std::vector<unsigned int> bounds{0, triangles_count};
+	for (submesh const& s : m.get_submeshes())
+	{
+		bounds.push_back(std::min(s.index_offset / 3, triangles_count));
+		bounds.push_back(std::min((s.index_offset + s.index_count) / 3, triangles_count));
+	}
+
+	std::sort(bounds.begin(), bounds.end());
+	bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+	return bounds;
+}
+
+/** Reorders triangles so that vertices are reused while they're still in post-transform cache
+* @param indices Triangles indices
+* @param vertices_count Count of vertices triangles can reference
+* @param cache_size Size of FIFO vertex cache to optimize for
+* @returns Index of the first triangle of every cluster
+*/
+static std::vector<unsigned int> optimize_triangles_vertex_cache(std::vector<unsigned int>& indices, unsigned int const vertices_count, unsigned int const cache_size)
+{
+	unsigned int const triangles_count{static_cast<unsigned int>(indices.size() / 3)};
+
+	// Build vertex-triangle adjacency: triangles of vertex v are stored in [offsets[v], offsets[v + 1])
+	//
+
+	std::vector<unsigned int> live_triangles_counts(vertices_count, 0);
+	for (unsigned int i{0}; i < triangles_count * 3; ++i)
+	{
+		++live_triangles_counts[indices[i]];
+	}
+
+	std::vector<unsigned int> adjacency_offsets(vertices_count + 1, 0);
+	for (unsigned int v{0}; v < vertices_count; ++v)
+	{
+		adjacency_offsets[v + 1] = adjacency_offsets[v] + live_triangles_counts[v];
+	}
+
+	std::vector<unsigned int> adjacency(triangles_count * 3);
+	std::vector<unsigned int> adjacency_cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+	for (unsigned int i{0}; i < triangles_count * 3; ++i)
+	{
+		adjacency[adjacency_cursors[indices[i]]++] = i / 3;
+	}
+
+	// Fan around vertices, choosing the next one among the vertices of just emitted triangles
+	// which are going to stay in cache while their live triangles are emitted
+	//
+
+	std::vector<unsigned int> cache_timestamps(vertices_count, 0);
+	std::vector<unsigned char> emitted_triangles(triangles_count, 0);
+	std::vector<unsigned int> dead_end_stack;
+	std::vector<unsigned int> candidates;
+
+	std::vector<unsigned int> result;
+	result.reserve(triangles_count * 3);
+
+	std::vector<unsigned int> clusters;
+
+	unsigned int timestamp{cache_size + 1};
+	unsigned int cursor{0};
+
+	unsigned int fanning_vertex{skip_dead_end(dead_end_stack, live_triangles_counts, cursor)};
+	bool is_cluster_started{true};
+
+	while (fanning_vertex != NO_VERTEX)
+	{
+		if (is_cluster_started)
+		{
+			clusters.push_back(static_cast<unsigned int>(result.size() / 3));
+		}
+
+		candidates.clear();
+
+		for (unsigned int i{adjacency_offsets[fanning_vertex]}; i < adjacency_offsets[fanning_vertex + 1]; ++i)
+		{
+			unsigned int const triangle{adjacency[i]};
+			if (emitted_triangles[triangle] != 0)
+			{
+				continue;
+			}
+
+			for (unsigned int j{0}; j < 3; ++j)
+			{
+				unsigned int const v{indices[triangle * 3 + j]};
+
+				result.push_back(v);
+				dead_end_stack.push_back(v);
+				candidates.push_back(v);
+				--live_triangles_counts[v];
+
+				if (timestamp - cache_timestamps[v] > cache_size)
+				{
+					cache_timestamps[v] = timestamp;
+					++timestamp;
+				}
+			}
+
+			emitted_triangles[triangle] = 1;
+		}
+
+		// Prefer the oldest candidate that still will be in cache after its live triangles are emitted
+		//
+
+		unsigned int next_vertex{NO_VERTEX};
+		unsigned int best_priority{0};
+
+		for (unsigned int const v : candidates)
+		{
+			if (live_triangles_counts[v] == 0)
+			{
+				continue;
+			}
+
+			unsigned int priority{1};
+			if (timestamp - cache_timestamps[v] + 2 * live_triangles_counts[v] <= cache_size)
+			{
+				priority = timestamp - cache_timestamps[v] + 1;
+			}
+
+			if (priority > best_priority)
+			{
+				best_priority = priority;
+				next_vertex = v;
+			}
+		}
+
+		is_cluster_started = (next_vertex == NO_VERTEX);
+		if (is_cluster_started)
+		{
+			next_vertex = skip_dead_end(dead_end_stack, live_triangles_counts, cursor);
+		}
+
+		fanning_vertex = next_vertex;
+	}
+
+	// Keep incomplete triangle, if any
+	//
+	result.insert(result.end(), indices.begin() + triangles_count * 3, indices.end());
+
+	indices.swap(result);
+
+	return clusters;
+}
+
+std::vector<unsigned int> lantern::optimize_vertex_cache(mesh& m, unsigned int const cache_size)
+{
+	std::vector<unsigned int>& indices = m.get_indices();
+	unsigned int const vertices_count{get_referenced_vertices_count(m)};
+
+	std::vector<unsigned int> const bounds{get_triangles_ranges_bounds(m)};
+
+	std::vector<unsigned int> clusters;
+	for (size_t i{0}; i + 1 < bounds.size(); ++i)
+	{
+		std::vector<unsigned int> range_indices(indices.begin() + bounds[i] * 3, indices.begin() + bounds[i + 1] * 3);
+
+		for (unsigned int const cluster : optimize_triangles_vertex_cache(range_indices, vertices_count, cache_size))
+		{
+			clusters.push_back(bounds[i] + cluster);
+		}
+
+		std::copy(range_indices.begin(), range_indices.end(), indices.begin() + bounds[i] * 3);
+	}
+
+	m.mark_changed();
+
+	return clusters;
+}
+
+/** Cluster of triangles and its overdraw sorting key */
+class triangles_cluster final
+{
+public:
+	/** Index of the first triangle */
+	unsigned int first_triangle;
+
+	/** Index of the triangle after the last one */
+	unsigned int end_triangle;
+
+	/** How much cluster faces outwards from the mesh center */
+	float occlusion_potential;
+};
+
+/** Reorders clusters of triangles range so that those facing outwards from the range center go first
+* @param indices Mesh indices
+* @param vertices Mesh vertices
+* @param first_triangle Index of the first triangle of range
+* @param end_triangle Index of the triangle after the last one in range
+* @param clusters Index of the first triangle of every cluster in range, the first one should start the range
+* @param result Storage to add reordered indices of range to
+*/
+static void optimize_range_overdraw(
+	std::vector<unsigned int> const& indices,
+	std::vector<vector3f> const& vertices,
+	unsigned int const first_triangle,
+	unsigned int const end_triangle,
+	std::vector<unsigned int> const& clusters,
+	std::vector<unsigned int>& result)
+{
+	// Range center
+	//
+
+	vector3f range_center{0.0f, 0.0f, 0.0f};
+	for (unsigned int i{first_triangle * 3}; i < end_triangle * 3; ++i)
+	{
+		range_center += vertices.at(indices[i]);
+	}
+	range_center /= static_cast<float>(std::max((end_triangle - first_triangle) * 3, 1u));
+
+	// Calculate occlusion potential of every cluster: dot product of
+	// the direction from range center to cluster center and cluster average normal
+	//
+
+	std::vector<triangles_cluster> sorted_clusters;
+	sorted_clusters.reserve(clusters.size());
+
+	for (size_t i{0}; i < clusters.size(); ++i)
+	{
+		unsigned int const cluster_first_triangle{clusters[i]};
+		unsigned int const cluster_end_triangle{(i + 1 < clusters.size()) ? clusters[i + 1] : end_triangle};
+
+		vector3f normal{0.0f, 0.0f, 0.0f};
+		vector3f weighted_center{0.0f, 0.0f, 0.0f};
+		vector3f center{0.0f, 0.0f, 0.0f};
+		float doubled_area{0.0f};
+
+		for (unsigned int t{cluster_first_triangle}; t < cluster_end_triangle; ++t)
+		{
+			vector3f const& v0 = vertices[indices[t * 3 + 0]];
+			vector3f const& v1 = vertices[indices[t * 3 + 1]];
+			vector3f const& v2 = vertices[indices[t * 3 + 2]];
+
+			vector3f const triangle_normal{(v1 - v0).cross(v2 - v0)};
+			float const triangle_doubled_area{triangle_normal.length()};
+			vector3f const triangle_center{(v0 + v1 + v2) / 3.0f};
+
+			normal += triangle_normal;
+			weighted_center += triangle_center * triangle_doubled_area;
+			center += triangle_center;
+			doubled_area += triangle_doubled_area;
+		}
+
+		center = (doubled_area > 0.0f) ? weighted_center / doubled_area : center / static_cast<float>(cluster_end_triangle - cluster_first_triangle);
+
+		float const normal_length{normal.length()};
+		float const occlusion_potential{(normal_length > 0.0f) ? (center - range_center).dot(normal / normal_length) : 0.0f};
+
+		sorted_clusters.push_back(triangles_cluster{cluster_first_triangle, cluster_end_triangle, occlusion_potential});
+	}
+
+	std::stable_sort(
+		sorted_clusters.begin(),
+		sorted_clusters.end(),
+		[](triangles_cluster const& a, triangles_cluster const& b) { return a.occlusion_potential > b.occlusion_potential; });
+
+	for (triangles_cluster const& cluster : sorted_clusters)
+	{
+		result.insert(result.end(), indices.begin() + cluster.first_triangle * 3, indices.begin() + cluster.end_triangle * 3);
+	}
+}
+
+void lantern::optimize_overdraw(mesh& m, std::vector<unsigned int> const& clusters)
+{
+	std::vector<unsigned int>& indices = m.get_indices();
+	unsigned int const triangles_count{static_cast<unsigned int>(indices.size() / 3)};
+
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	// Clusters are reordered inside submeshes only. Every range starts a new cluster
+	//
+
+	std::vector<unsigned int> const bounds{get_triangles_ranges_bounds(m)};
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+
+	std::vector<unsigned int> range_clusters;
+	size_t cluster_index{0};
+
+	for (size_t i{0}; i + 1 < bounds.size(); ++i)
+	{
+		range_clusters.assign(1, bounds[i]);
+
+		while ((cluster_index < clusters.size()) && (clusters[cluster_index] < bounds[i + 1]))
+		{
+			if (clusters[cluster_index] > bounds[i])
+			{
+				range_clusters.push_back(clusters[cluster_index]);
+			}
+
+			++cluster_index;
+		}
+
+		optimize_range_overdraw(indices, m.get_vertices(), bounds[i], bounds[i + 1], range_clusters, result);
+	}
+
+	result.insert(result.end(), indices.begin() + triangles_count * 3, indices.end());
+
+	indices.swap(result);
+	m.mark_changed();
+}
+
+/** Reorders attributes values or indices to match reordered vertices
+* @param attributes Attributes to reorder
+* @param remap New index of every vertex
+*/
+template<typename TAttr>
+static void reorder_attributes(std::vector<mesh_attribute_info<TAttr>>& attributes, std::vector<unsigned int> const& remap)
+{
+	size_t const vertices_count{remap.size()};
+
+	for (mesh_attribute_info<TAttr>& attribute_info : attributes)
+	{
+		std::vector<TAttr>& data = attribute_info.get_data();
+		std::vector<unsigned int>& indices = attribute_info.get_indices();
+
+		if (indices.empty())
+		{
+			// Values are stored per vertex
+			//
+
+			std::vector<TAttr> reordered_data(data);
+			for (size_t v{0}; v < vertices_count; ++v)
+			{
+				reordered_data.at(remap[v]) = data.at(v);
+			}
+
+			data.swap(reordered_data);
+		}
+		else
+		{
+			std::vector<unsigned int> reordered_indices(indices);
+			for (size_t v{0}; v < vertices_count; ++v)
+			{
+				reordered_indices.at(remap[v]) = indices.at(v);
+			}
+
+			indices.swap(reordered_indices);
+		}
+	}
+}
+
+void lantern::optimize_vertex_fetch(mesh& m)
+{
+	std::vector<unsigned int>& indices = m.get_indices();
+	std::vector<vector3f>& vertices = m.get_vertices();
+	unsigned int const vertices_count{static_cast<unsigned int>(vertices.size())};
+
+	// Number vertices in order of their first use
+	//
+
+	std::vector<unsigned int> remap(vertices_count, NO_VERTEX);
+	unsigned int next_index{0};
+
+	for (unsigned int& index : indices)
+	{
+		unsigned int& new_index = remap.at(index);
+		if (new_index == NO_VERTEX)
+		{
+			new_index = next_index++;
+		}
+
+		index = new_index;
+	}
+
+	for (unsigned int& new_index : remap)
+	{
+		if (new_index == NO_VERTEX)
+		{
+			new_index = next_index++;
+		}
+	}
+
+	// Move vertices and attributes
+	//
+
+	std::vector<vector3f> reordered_vertices(vertices_count);
+	for (unsigned int v{0}; v < vertices_count; ++v)
+	{
+		reordered_vertices[remap[v]] = vertices[v];
+	}
+	vertices.swap(reordered_vertices);
+
+	reorder_attributes(m.get_color_attributes(), remap);
+	reorder_attributes(m.get_float_attributes(), remap);
+	reorder_attributes(m.get_vector2f_attributes(), remap);
+	reorder_attributes(m.get_vector3f_attributes(), remap);
+
+	m.mark_changed();
+}
+
+void lantern::optimize_mesh(mesh& m)
+{
+	std::vector<unsigned int> const clusters{optimize_vertex_cache(m, DEFAULT_VERTEX_CACHE_SIZE)};
+	optimize_overdraw(m, clusters);
+	optimize_vertex_fetch(m);
+}
+
+float lantern::get_average_cache_miss_ratio(std::vector<unsigned int> const& indices, unsigned int const cache_size)
+{
+	size_t const triangles_count{indices.size() / 3};
+	if (triangles_count == 0)
+	{
+		return 0.0f;
+	}
+
+	// Vertex is in FIFO cache if less than cache size misses happened after it was put there
+	//
+
+	unsigned int vertices_count{0};
+	for (unsigned int const index : indices)
+	{
+		vertices_count = std::max(vertices_count, index + 1);
+	}
+
+	std::vector<unsigned int> cache_timestamps(vertices_count, 0);
+	unsigned int misses_count{0};
+
+	for (size_t i{0}; i < triangles_count * 3; ++i)
+	{
+		unsigned int& timestamp = cache_timestamps[indices[i]];
+		if ((timestamp == 0) || (misses_count + 1 - timestamp > cache_size))
+		{
+			++misses_count;
+			timestamp = misses_count;
+		}
+	}
+
+	return static_cast<float>(misses_count) / static_cast<float>(triangles_count);
+}
@@ -1,202 +1,610 @@
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <exception>
 #include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include "memory_mapped_file.h"
+#include "mesh_binary.h"
 #include "obj_import.h"
 
 using namespace lantern;
 
-void obj_reader::read(std::string const& path)
+// Tokenizer. Works on raw characters without locale and allocations
+//
+
+/** Checks if character separates tokens in a line
+* @param c Character to check
+* @returns True for spaces and tabs
+*/
+static bool is_space(char const c)
 {
-	// Open file
-	//
-	std::ifstream file_stream{path};
-	if (!file_stream.is_open())
+	return (c == ' ') || (c == '\t');
+}
+
+/** Checks if character ends a line
+* @param c Character to check
+* @returns True for line feed and carriage return
+*/
+static bool is_line_end(char const c)
+{
+	return (c == '\n') || (c == '\r');
+}
+
+/** Checks if character is a decimal digit
+* @param c Character to check
+* @returns True for digits
+*/
+static bool is_digit(char const c)
+{
+	return (c >= '0') && (c <= '9');
+}
+
+/** Skips spaces and tabs
+* @param p Current position
+* @param end End of content
+*/
+static void skip_spaces(char const*& p, char const* const end)
+{
+	while ((p < end) && is_space(*p))
+	{
+		++p;
+	}
+}
+
+/** Skips the rest of the line including line end characters
+* @param p Current position
+* @param end End of content
+*/
+static void skip_line(char const*& p, char const* const end)
+{
+	while ((p < end) && (*p != '\n'))
 	{
-		throw std::runtime_error("Could not open file: " + path);
+		++p;
 	}
 
-	on_reading_started();
+	if (p < end)
+	{
+		++p;
+	}
+}
+
+/** Parses unsigned integer
+* @param p Current position, moved after the number if it's parsed
+* @param end End of content
+* @param value Parsed value
+* @returns False if there is no number at current position
+*/
+static bool parse_unsigned_int(char const*& p, char const* const end, unsigned int& value)
+{
+	char const* s{p};
 
-	// Read line-by-line
+	unsigned int result{0};
+	while ((s < end) && is_digit(*s))
+	{
+		result = result * 10 + static_cast<unsigned int>(*s - '0');
+		++s;
+	}
+
+	if (s == p)
+	{
+		return false;
+	}
+
+	value = result;
+	p = s;
+
+	return true;
+}
+
+/** Parses float in decimal fixed or scientific notation
+* @param p Current position, moved after the number if it's parsed
+* @param end End of content
+* @param value Parsed value
+* @returns False if there is no number at current position
+*/
+static bool parse_float(char const*& p, char const* const end, float& value)
+{
+	// Exact powers of ten representable by double
+	//
+	static double const powers_of_ten[]{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	char const* s{p};
+
+	bool negative{false};
+	if ((s < end) && ((*s == '-') || (*s == '+')))
+	{
+		negative = (*s == '-');
+		++s;
+	}
+
+	// Collect up to 19 significant digits into integer mantissa, the rest only affect the exponent
 	//
-	std::string line;
-	parse_face_function parse_face{nullptr};
 
-	while(std::getline(file_stream, line))
+	uint64_t mantissa{0};
+	int significant_digits_count{0};
+	int exponent{0};
+	bool has_digits{false};
+
+	while ((s < end) && is_digit(*s))
 	{
-		// Skip comments
-		//
-		if (line[0] == '#')
+		if (significant_digits_count < 19)
 		{
-			continue;
+			mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+			significant_digits_count += (mantissa != 0) ? 1 : 0;
+		}
+		else
+		{
+			++exponent;
 		}
 
-		// Get line definition type
-		//
+		has_digits = true;
+		++s;
+	}
 
-		std::istringstream line_stream{line};
+	if ((s < end) && (*s == '.'))
+	{
+		++s;
 
-		std::string definition_type;
-		line_stream >> definition_type;
+		while ((s < end) && is_digit(*s))
+		{
+			if (significant_digits_count < 19)
+			{
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*s - '0');
+				significant_digits_count += (mantissa != 0) ? 1 : 0;
+				--exponent;
+			}
 
-		// Process each definition
-		//
+			has_digits = true;
+			++s;
+		}
+	}
 
-		if (definition_type == "v")
+	if (!has_digits)
+	{
+		return false;
+	}
+
+	// Exponent part is taken only if it has digits
+	//
+	if ((s < end) && ((*s == 'e') || (*s == 'E')))
+	{
+		char const* e{s + 1};
+
+		bool negative_exponent{false};
+		if ((e < end) && ((*e == '-') || (*e == '+')))
 		{
-			float x, y, z;
-			line_stream >> x >> y >> z;
-			on_vertex_def(x, y, z);
+			negative_exponent = (*e == '-');
+			++e;
 		}
-		else if (definition_type == "vn")
+
+		unsigned int explicit_exponent;
+		if (parse_unsigned_int(e, end, explicit_exponent))
 		{
-			float x, y, z;
-			line_stream >> x >> y >> z;
-			on_normal_def(x, y, z);
+			exponent += negative_exponent ? -static_cast<int>(explicit_exponent) : static_cast<int>(explicit_exponent);
+			s = e;
 		}
-		else if (definition_type == "vt")
+	}
+
+	double result{static_cast<double>(mantissa)};
+	if ((exponent >= -22) && (exponent < 0))
+	{
+		result /= powers_of_ten[-exponent];
+	}
+	else if ((exponent >= 0) && (exponent <= 22))
+	{
+		result *= powers_of_ten[exponent];
+	}
+	else
+	{
+		result *= std::pow(10.0, exponent);
+	}
+
+	value = static_cast<float>(negative ? -result : result);
+	p = s;
+
+	return true;
+}
+
+/** Parses space separated floats
+* @param p Current position, moved after the last parsed number
+* @param end End of content
+* @param values Storage for parsed values
+* @param count Count of floats to parse
+* @returns False if there are less numbers than required
+*/
+static bool parse_floats(char const*& p, char const* const end, float* const values, unsigned int const count)
+{
+	for (unsigned int i{0}; i < count; ++i)
+	{
+		skip_spaces(p, end);
+
+		if (!parse_float(p, end, values[i]))
 		{
-			float x, y;
-			line_stream >> x >> y;
-			on_texcoord_def(x, y);
+			return false;
 		}
-		else if (definition_type == "f")
-		{
-			if (parse_face == nullptr)
-			{
-				parse_face = get_parse_function(line);
-			}
+	}
 
-			on_face_def_started();
+	return true;
+}
 
-			(this->*parse_face)(line_stream);
+/** Parses .obj index and converts it to 0-based one.
+* Positive indices are 1-based, negative ones are relative to the end of elements defined so far
+* @param p Current position, moved after the index if it's parsed
+* @param end End of content
+* @param defined_count Count of elements defined so far
+* @param index Parsed index
+* @param has_relative_indices Set to true if index is negative, even if it's invalid, kept untouched otherwise
+* @returns False if there is no valid index at current position
+*/
+static bool parse_index(char const*& p, char const* const end, unsigned int const defined_count, unsigned int& index, bool& has_relative_indices)
+{
+	bool const is_relative{(p < end) && (*p == '-')};
+	has_relative_indices = has_relative_indices || is_relative;
 
-			on_face_def_ended();
+	char const* s{is_relative ? p + 1 : p};
+
+	unsigned int value;
+	if (!parse_unsigned_int(s, end, value) || (value == 0))
+	{
+		return false;
+	}
+
+	if (is_relative)
+	{
+		if (value > defined_count)
+		{
+			return false;
 		}
 
-		file_stream >> std::ws;
+		index = defined_count - value;
+	}
+	else
+	{
+		index = value - 1;
 	}
 
-	on_reading_ended();
+	p = s;
+
+	return true;
 }
 
-obj_reader::parse_face_function obj_reader::get_parse_function(std::string face_definition)
+/** Face vertex definition */
+class obj_face_vertex final
 {
-	std::istringstream stream{face_definition};
-
-	char c;
-	unsigned int ui;
+public:
+	/** Vertex index */
+	unsigned int vertex_index;
+
+	/** Texcoord index */
+	unsigned int texcoord_index;
+
+	/** Normal index */
+	unsigned int normal_index;
+
+	/** Is texcoord index defined */
+	bool has_texcoord;
+
+	/** Is normal index defined */
+	bool has_normal;
+};
+
+/** Parses face vertex definition: v, v/vt, v//vn or v/vt/vn
+* @param p Current position, moved after the definition if it's parsed
+* @param end End of content
+* @param defined_counts Counts of elements defined so far, relative indices are resolved against them
+* @param vertex Parsed definition
+* @param has_relative_indices Set to true if any index is negative, even if it's invalid, kept untouched otherwise
+* @returns False if definition is malformed
+*/
+static bool parse_face_vertex(
+	char const*& p, char const* const end,
+	obj_elements_counts const& defined_counts,
+	obj_face_vertex& vertex,
+	bool& has_relative_indices)
+{
+	vertex.has_texcoord = false;
+	vertex.has_normal = false;
 
-	// Skip "f"
-	stream >> c;
+	if (!parse_index(p, end, defined_counts.vertices_count, vertex.vertex_index, has_relative_indices))
+	{
+		return false;
+	}
 
-	// First number is vertex index anyway, skip it together with preceding whitespaces
-	stream >> std::skipws >> ui >> std::noskipws;
+	if ((p == end) || (*p != '/'))
+	{
+		return true;
+	}
+	++p;
 
-	stream >> c;
-	if (c == ' ')
+	if ((p < end) && (*p != '/'))
 	{
-		// Whitespace immediately after vertex index => no uv, no normals
-		return &obj_reader::parse_face_vertex;
+		if (!parse_index(p, end, defined_counts.texcoords_count, vertex.texcoord_index, has_relative_indices))
+		{
+			return false;
+		}
+
+		vertex.has_texcoord = true;
 	}
 
-	// Otherwise, it's '/'
+	if ((p == end) || (*p != '/'))
+	{
+		return true;
+	}
+	++p;
 
-	stream >> ui;
-	if (stream.fail())
+	if (!parse_index(p, end, defined_counts.normals_count, vertex.normal_index, has_relative_indices))
 	{
-		// Definition us "v//n"
-		return &obj_reader::parse_face_vertex_normal;
+		return false;
 	}
 
-	stream >> c;
-	if (c == '/')
+	vertex.has_normal = true;
+
+	return true;
+}
+
+/** Parses the rest of the line as a name, without trailing spaces and comment
+* @param p Current position, moved to the end of the name
+* @param end End of content
+* @returns Name, empty if there is none
+*/
+static std::string parse_name(char const*& p, char const* const end)
+{
+	skip_spaces(p, end);
+
+	char const* const name{p};
+	char const* name_end{p};
+
+	while ((p < end) && !is_line_end(*p) && (*p != '#'))
 	{
-		// Definition is "v/uv/n"
-		return &obj_reader::parse_face_vertex_texcoord_normal;
+		++p;
+
+		if (!is_space(*(p - 1)))
+		{
+			name_end = p;
+		}
 	}
 
-	// Definition is "v/uv"
-	return &obj_reader::parse_face_vertex_texcoord;
+	return std::string(name, name_end);
 }
 
-void obj_reader::parse_face_vertex(std::istringstream& stream)
+/** Checks if token equals to a keyword
+* @param token Token start
+* @param token_end Token end
+* @param keyword Null-terminated keyword
+* @returns True if they are equal
+*/
+static bool is_token_equal(char const* token, char const* const token_end, char const* keyword)
 {
-	unsigned int index0, index1, index2;
-	stream >> index0 >> index1 >> index2;
+	while ((token < token_end) && (*keyword != '\0'))
+	{
+		if (*token != *keyword)
+		{
+			return false;
+		}
+
+		++token;
+		++keyword;
+	}
 
-	on_face_pos_def(index0 - 1, index1 - 1, index2 - 1);
+	return (token == token_end) && (*keyword == '\0');
 }
 
-void obj_reader::parse_face_vertex_normal(std::istringstream& stream)
+/** Throws exception describing malformed line
+* @param line_number Line number, starting from one
+*/
+static void throw_malformed_line(unsigned int const line_number)
 {
-	unsigned int vertex_index0, vertex_index1, vertex_index2;
-	unsigned int normal_index0, normal_index1, normal_index2;
+	throw std::runtime_error("Malformed .obj definition at line " + std::to_string(line_number));
+}
 
-	stream >> vertex_index0;
-	stream.ignore(2);
-	stream >> normal_index0;
+// obj_reader
+//
 
-	stream >> vertex_index1;
-	stream.ignore(2);
-	stream >> normal_index1;
+obj_reader::obj_reader()
+	: m_read_elements_counts{0, 0, 0}, m_has_skipped_faces{false}
+{
 
-	stream >> vertex_index2;
-	stream.ignore(2);
-	stream >> normal_index2;
+}
+
+void obj_reader::read(std::string const& path)
+{
+	memory_mapped_file const file{path};
+	parse(file.get_data(), file.get_size());
+}
 
-	on_face_pos_def(vertex_index0 - 1, vertex_index1 - 1, vertex_index2 - 1);
-	on_face_normal_def(normal_index0 - 1, normal_index1 - 1, normal_index2 - 1);
+void obj_reader::parse(char const* const data, size_t const size)
+{
+	parse(data, size, obj_elements_counts{0, 0, 0}, true);
 }
 
-void obj_reader::parse_face_vertex_texcoord(std::istringstream& stream)
+void obj_reader::parse(char const* const data, size_t const size, obj_elements_counts const& preceding_counts, bool const are_preceding_counts_known)
 {
-	unsigned int vertex_index0, vertex_index1, vertex_index2;
-	unsigned int texcoord_index0, texcoord_index1, texcoord_index2;
+	m_read_elements_counts = obj_elements_counts{0, 0, 0};
+	m_has_skipped_faces = false;
 
-	stream >> vertex_index0;
-	stream.ignore();
-	stream >> texcoord_index0;
+	on_reading_started();
 
-	stream >> vertex_index1;
-	stream.ignore();
-	stream >> texcoord_index1;
+	char const* p{data};
+	char const* const end{data + size};
+	unsigned int line_number{0};
 
-	stream >> vertex_index2;
-	stream.ignore();
-	stream >> texcoord_index2;
+	// Counts of elements defined so far, including preceding ones
+	//
+	obj_elements_counts defined_counts{preceding_counts};
 
-	on_face_pos_def(vertex_index0 - 1, vertex_index1 - 1, vertex_index2 - 1);
-	on_face_texcoord_def(texcoord_index0 - 1, texcoord_index1 - 1, texcoord_index2 - 1);
-}
+	while (p < end)
+	{
+		++line_number;
 
-void obj_reader::parse_face_vertex_texcoord_normal(std::istringstream& stream)
-{
-	unsigned int vertex_index0, vertex_index1, vertex_index2;
-	unsigned int normal_index0, normal_index1, normal_index2;
-	unsigned int texcoord_index0, texcoord_index1, texcoord_index2;
+		skip_spaces(p, end);
+
+		// Skip empty lines and comments
+		//
+		if ((p == end) || is_line_end(*p) || (*p == '#'))
+		{
+			skip_line(p, end);
+			continue;
+		}
+
+		// Get line definition type
+		//
+
+		char const* const token{p};
+		while ((p < end) && !is_space(*p) && !is_line_end(*p))
+		{
+			++p;
+		}
+		char const* const token_end{p};
+
+		// Process each definition. Whatever follows the parsed values is ignored
+		//
+
+		if (is_token_equal(token, token_end, "v"))
+		{
+			float values[3];
+			if (!parse_floats(p, end, values, 3))
+			{
+				throw_malformed_line(line_number);
+			}
+
+			++defined_counts.vertices_count;
+			on_vertex_def(values[0], values[1], values[2]);
+		}
+		else if (is_token_equal(token, token_end, "vn"))
+		{
+			float values[3];
+			if (!parse_floats(p, end, values, 3))
+			{
+				throw_malformed_line(line_number);
+			}
+
+			++defined_counts.normals_count;
+			on_normal_def(values[0], values[1], values[2]);
+		}
+		else if (is_token_equal(token, token_end, "vt"))
+		{
+			float values[2];
+			if (!parse_floats(p, end, values, 2))
+			{
+				throw_malformed_line(line_number);
+			}
+
+			++defined_counts.texcoords_count;
+			on_texcoord_def(values[0], values[1]);
+		}
+		else if (is_token_equal(token, token_end, "f") && !m_has_skipped_faces)
+		{
+			// Face is triangulated as a fan around its first vertex while its vertices are parsed,
+			// so faces of any size are processed without storing them.
+			// Texcoords and normals of a triangle are reported only if all its vertices define them
+			//
+
+			obj_face_vertex first_vertex;
+			obj_face_vertex previous_vertex;
+			obj_face_vertex vertex;
+
+			bool has_relative_indices{false};
+			unsigned int vertices_count{0};
+
+			while (true)
+			{
+				skip_spaces(p, end);
+
+				if ((p == end) || is_line_end(*p) || (*p == '#'))
+				{
+					break;
+				}
+
+				bool const is_vertex_parsed{parse_face_vertex(p, end, defined_counts, vertex, has_relative_indices)};
+
+				// Relative indices can't be resolved yet. The rest of faces isn't needed because content is going to be parsed again
+				//
+				if (has_relative_indices && !are_preceding_counts_known)
+				{
+					m_has_skipped_faces = true;
+					break;
+				}
+
+				if (!is_vertex_parsed)
+				{
+					throw_malformed_line(line_number);
+				}
+
+				++vertices_count;
+
+				if (vertices_count >= 3)
+				{
+					on_face_def_started();
+
+					on_face_pos_def(first_vertex.vertex_index, previous_vertex.vertex_index, vertex.vertex_index);
+
+					if (first_vertex.has_texcoord && previous_vertex.has_texcoord && vertex.has_texcoord)
+					{
+						on_face_texcoord_def(first_vertex.texcoord_index, previous_vertex.texcoord_index, vertex.texcoord_index);
+					}
+
+					if (first_vertex.has_normal && previous_vertex.has_normal && vertex.has_normal)
+					{
+						on_face_normal_def(first_vertex.normal_index, previous_vertex.normal_index, vertex.normal_index);
+					}
+
+					on_face_def_ended();
+				}
+				else if (vertices_count == 1)
+				{
+					first_vertex = vertex;
+				}
+
+				previous_vertex = vertex;
+			}
+
+			if ((vertices_count < 3) && !m_has_skipped_faces)
+			{
+				throw_malformed_line(line_number);
+			}
+		}
+
+		else if (is_token_equal(token, token_end, "o"))
+		{
+			on_object_def(parse_name(p, end));
+		}
+		else if (is_token_equal(token, token_end, "g"))
+		{
+			on_group_def(parse_name(p, end));
+		}
+		else if (is_token_equal(token, token_end, "usemtl"))
+		{
+			on_material_usage_def(parse_name(p, end));
+		}
+		else if (is_token_equal(token, token_end, "mtllib"))
+		{
+			on_material_library_def(parse_name(p, end));
+		}
 
-	stream >> vertex_index0;
-	stream.ignore();
-	stream >> texcoord_index0;
-	stream.ignore();
-	stream >> normal_index0;
+		skip_line(p, end);
+	}
 
-	stream >> vertex_index1;
-	stream.ignore();
-	stream >> texcoord_index1;
-	stream.ignore();
-	stream >> normal_index1;
+	m_read_elements_counts = obj_elements_counts{
+		defined_counts.vertices_count - preceding_counts.vertices_count,
+		defined_counts.texcoords_count - preceding_counts.texcoords_count,
+		defined_counts.normals_count - preceding_counts.normals_count};
 
-	stream >> vertex_index2;
-	stream.ignore();
-	stream >> texcoord_index2;
-	stream.ignore();
-	stream >> normal_index2;
+	on_reading_ended();
+}
+
+obj_elements_counts const& obj_reader::get_read_elements_counts() const
+{
+	return m_read_elements_counts;
+}
 
-	on_face_pos_def(vertex_index0 - 1, vertex_index1 - 1, vertex_index2 - 1);
-	on_face_texcoord_def(texcoord_index0 - 1, texcoord_index1 - 1, texcoord_index2 - 1);
-	on_face_normal_def(normal_index0 - 1, normal_index1 - 1, normal_index2 - 1);
+bool obj_reader::has_skipped_faces() const
+{
+	return m_has_skipped_faces;
 }
 
 void obj_reader::on_reading_started()
@@ -249,11 +657,33 @@ void obj_reader::on_face_normal_def(unsigned int normal_index0, unsigned int nor
 
 }
 
+void obj_reader::on_object_def(std::string const& name)
+{
+
+}
+
+void obj_reader::on_group_def(std::string const& name)
+{
+
+}
+
+void obj_reader::on_material_usage_def(std::string const& name)
+{
+
+}
+
+void obj_reader::on_material_library_def(std::string const& names)
+{
+
+}
+
 // obj_mesh_importer
 //
 
 obj_mesh_importer::obj_mesh_importer(bool const read_texcoords, bool const read_normals)
-	: m_read_texcoords(read_texcoords), m_read_normals(read_normals)
+	: m_read_texcoords(read_texcoords), m_read_normals(read_normals),
+	  m_is_object_name_defined{false}, m_is_material_name_defined{false},
+	  m_object_name_inheriting_submeshes_count{0}, m_material_name_inheriting_submeshes_count{0}
 {
 
 }
@@ -264,19 +694,312 @@ mesh obj_mesh_importer::get_mesh() const
 
 	if (m_read_texcoords)
 	{
-		mesh_attribute_info<vector2f> texcoords_info{TEXCOORD_ATTR_ID, m_texcoords, m_texcoords_indices, attribute_interpolation_option::perspective_correct};
-		m.get_vector2f_attributes().push_back(texcoords_info);
+		m.get_vector2f_attributes().push_back(
+			mesh_attribute_info<vector2f>{TEXCOORD_ATTR_ID, m_texcoords, m_texcoords_indices, attribute_interpolation_option::perspective_correct});
 	};
 
 	if (m_read_normals)
 	{
-		mesh_attribute_info<vector3f> normals_info{NORMAL_ATTR_ID, m_normals, m_normals_indices, attribute_interpolation_option::linear};
-		m.get_vector3f_attributes().push_back(normals_info);
+		m.get_vector3f_attributes().push_back(
+			mesh_attribute_info<vector3f>{NORMAL_ATTR_ID, m_normals, m_normals_indices, attribute_interpolation_option::linear});
 	}
 
+	add_submeshes(m);
+
+	return m;
+}
+
+mesh obj_mesh_importer::take_mesh()
+{
+	mesh m{std::move(m_vertices), std::move(m_indices)};
+	add_submeshes(m);
+
+	if (m_read_texcoords)
+	{
+		m.get_vector2f_attributes().push_back(
+			mesh_attribute_info<vector2f>{TEXCOORD_ATTR_ID, std::move(m_texcoords), std::move(m_texcoords_indices), attribute_interpolation_option::perspective_correct});
+	};
+
+	if (m_read_normals)
+	{
+		m.get_vector3f_attributes().push_back(
+			mesh_attribute_info<vector3f>{NORMAL_ATTR_ID, std::move(m_normals), std::move(m_normals_indices), attribute_interpolation_option::linear});
+	}
+
+	// Moved-from vectors are valid but unspecified
+	//
+	on_reading_started();
+
 	return m;
 }
 
+size_t const obj_mesh_importer::MIN_PARALLEL_CHUNK_SIZE;
+
+void obj_mesh_importer::read_parallel(std::string const& path, thread_pool& pool)
+{
+	if (pool.get_threads_count() == 1)
+	{
+		read(path);
+		return;
+	}
+
+	memory_mapped_file const file{path};
+
+	char const* const data{file.get_data()};
+	size_t const size{file.get_size()};
+
+	// Split content into chunks ending with line ends, a few chunks per thread to balance the load
+	//
+
+	size_t const chunks_count_limit{pool.get_threads_count() * 4};
+	size_t const chunk_size{std::max(MIN_PARALLEL_CHUNK_SIZE, size / chunks_count_limit + 1)};
+
+	std::vector<size_t> chunks_offsets{0};
+	while (chunks_offsets.back() < size)
+	{
+		size_t offset{std::min(chunks_offsets.back() + chunk_size, size)};
+		while ((offset < size) && (data[offset - 1] != '\n'))
+		{
+			++offset;
+		}
+
+		chunks_offsets.push_back(offset);
+	}
+
+	unsigned int const chunks_count{static_cast<unsigned int>(chunks_offsets.size() - 1)};
+
+	// Parse chunks. Counts of elements defined before a chunk are not known until preceding chunks are parsed,
+	// so chunks with relative indices in faces are parsed once again when they are.
+	// Exceptions can't leave worker threads, so they're rethrown afterwards
+	//
+
+	std::vector<obj_mesh_importer> chunks_importers(chunks_count, obj_mesh_importer{m_read_texcoords, m_read_normals});
+	std::vector<obj_elements_counts> chunks_preceding_counts(chunks_count, obj_elements_counts{0, 0, 0});
+	std::vector<std::exception_ptr> chunks_exceptions(chunks_count);
+
+	auto parse_chunks = [&](bool const are_preceding_counts_known)
+	{
+		pool.run(
+			chunks_count,
+			[&](unsigned int const task_index, unsigned int const worker_index)
+			{
+				obj_mesh_importer& chunk_importer = chunks_importers[task_index];
+				if (are_preceding_counts_known && !chunk_importer.has_skipped_faces())
+				{
+					return;
+				}
+
+				try
+				{
+					chunk_importer.parse(
+						data + chunks_offsets[task_index],
+						chunks_offsets[task_index + 1] - chunks_offsets[task_index],
+						chunks_preceding_counts[task_index],
+						are_preceding_counts_known || (task_index == 0));
+				}
+				catch (...)
+				{
+					chunks_exceptions[task_index] = std::current_exception();
+				}
+			});
+
+		for (std::exception_ptr const& exception : chunks_exceptions)
+		{
+			if (exception != nullptr)
+			{
+				std::rethrow_exception(exception);
+			}
+		}
+	};
+
+	parse_chunks(false);
+
+	bool has_skipped_faces{false};
+	for (unsigned int i{1}; i < chunks_count; ++i)
+	{
+		obj_elements_counts const& previous_chunk_counts = chunks_importers[i - 1].get_read_elements_counts();
+		obj_elements_counts const& previous_chunk_preceding_counts = chunks_preceding_counts[i - 1];
+
+		chunks_preceding_counts[i] = obj_elements_counts{
+			previous_chunk_preceding_counts.vertices_count + previous_chunk_counts.vertices_count,
+			previous_chunk_preceding_counts.texcoords_count + previous_chunk_counts.texcoords_count,
+			previous_chunk_preceding_counts.normals_count + previous_chunk_counts.normals_count};
+
+		has_skipped_faces = has_skipped_faces || chunks_importers[i].has_skipped_faces();
+	}
+
+	if (has_skipped_faces)
+	{
+		parse_chunks(true);
+	}
+
+	// Merge chunks, every chunk is copied to its place by its own task.
+	// All face indices are absolute by now, so they don't need any adjustments
+	//
+
+	std::vector<definitions_counts> chunks_offsets_in_result(chunks_count + 1, definitions_counts{0, 0, 0, 0, 0, 0});
+	for (unsigned int i{0}; i < chunks_count; ++i)
+	{
+		definitions_counts const chunk_counts{chunks_importers[i].get_definitions_counts()};
+		definitions_counts const& offsets = chunks_offsets_in_result[i];
+
+		chunks_offsets_in_result[i + 1] = definitions_counts{
+			offsets.vertices_count + chunk_counts.vertices_count,
+			offsets.indices_count + chunk_counts.indices_count,
+			offsets.texcoords_count + chunk_counts.texcoords_count,
+			offsets.texcoords_indices_count + chunk_counts.texcoords_indices_count,
+			offsets.normals_count + chunk_counts.normals_count,
+			offsets.normals_indices_count + chunk_counts.normals_indices_count};
+	}
+
+	on_reading_started();
+
+	definitions_counts const& total_counts = chunks_offsets_in_result.back();
+	m_vertices.resize(total_counts.vertices_count);
+	m_indices.resize(total_counts.indices_count);
+	m_texcoords.resize(total_counts.texcoords_count);
+	m_texcoords_indices.resize(total_counts.texcoords_indices_count);
+	m_normals.resize(total_counts.normals_count);
+	m_normals_indices.resize(total_counts.normals_indices_count);
+
+	pool.run(
+		chunks_count,
+		[&](unsigned int const task_index, unsigned int const worker_index)
+		{
+			obj_mesh_importer const& chunk_importer = chunks_importers[task_index];
+			definitions_counts const& offsets = chunks_offsets_in_result[task_index];
+
+			std::copy(chunk_importer.m_vertices.begin(), chunk_importer.m_vertices.end(), m_vertices.begin() + offsets.vertices_count);
+			std::copy(chunk_importer.m_indices.begin(), chunk_importer.m_indices.end(), m_indices.begin() + offsets.indices_count);
+			std::copy(chunk_importer.m_texcoords.begin(), chunk_importer.m_texcoords.end(), m_texcoords.begin() + offsets.texcoords_count);
+			std::copy(chunk_importer.m_texcoords_indices.begin(), chunk_importer.m_texcoords_indices.end(), m_texcoords_indices.begin() + offsets.texcoords_indices_count);
+			std::copy(chunk_importer.m_normals.begin(), chunk_importer.m_normals.end(), m_normals.begin() + offsets.normals_count);
+			std::copy(chunk_importer.m_normals_indices.begin(), chunk_importer.m_normals_indices.end(), m_normals_indices.begin() + offsets.normals_indices_count);
+		});
+
+	// Merge submeshes. Leading submeshes of a chunk take names not defined in it from preceding chunks,
+	// and the first one continues the last submesh of preceding chunks if it doesn't define any name
+	//
+
+	for (unsigned int i{0}; i < chunks_count; ++i)
+	{
+		obj_mesh_importer const& chunk_importer = chunks_importers[i];
+		unsigned int const index_offset{static_cast<unsigned int>(chunks_offsets_in_result[i].indices_count)};
+
+		for (size_t j{0}; j < chunk_importer.m_submeshes.size(); ++j)
+		{
+			bool const is_object_name_inherited{j < chunk_importer.m_object_name_inheriting_submeshes_count};
+			bool const is_material_name_inherited{j < chunk_importer.m_material_name_inheriting_submeshes_count};
+
+			submesh const& chunk_submesh = chunk_importer.m_submeshes[j];
+
+			if ((j == 0) && is_object_name_inherited && is_material_name_inherited && !m_submeshes.empty())
+			{
+				m_submeshes.back().index_count += chunk_submesh.index_count;
+				continue;
+			}
+
+			m_submeshes.push_back(
+				submesh{
+					is_object_name_inherited ? m_object_name : chunk_submesh.name,
+					is_material_name_inherited ? m_material_name : chunk_submesh.material_name,
+					index_offset + chunk_submesh.index_offset,
+					chunk_submesh.index_count,
+					aabb<vector3f>{}});
+		}
+
+		if (chunk_importer.m_is_object_name_defined)
+		{
+			m_object_name = chunk_importer.m_object_name;
+		}
+
+		if (chunk_importer.m_is_material_name_defined)
+		{
+			m_material_name = chunk_importer.m_material_name;
+		}
+
+		m_material_libraries.insert(m_material_libraries.end(), chunk_importer.m_material_libraries.begin(), chunk_importer.m_material_libraries.end());
+	}
+
+	on_reading_ended();
+}
+
+obj_mesh_importer::definitions_counts obj_mesh_importer::get_definitions_counts() const
+{
+	return definitions_counts{
+		m_vertices.size(),
+		m_indices.size(),
+		m_texcoords.size(),
+		m_texcoords_indices.size(),
+		m_normals.size(),
+		m_normals_indices.size()};
+}
+
+std::vector<std::string> const& obj_mesh_importer::get_material_libraries() const
+{
+	return m_material_libraries;
+}
+
+void obj_mesh_importer::start_submesh()
+{
+	if (m_submeshes.empty() || (m_submeshes.back().index_count != 0))
+	{
+		m_submeshes.push_back(
+			submesh{m_object_name, m_material_name, static_cast<unsigned int>(m_indices.size()), 0, aabb<vector3f>{}});
+	}
+	else
+	{
+		m_submeshes.back().name = m_object_name;
+		m_submeshes.back().material_name = m_material_name;
+	}
+
+	size_t const submeshes_count{m_submeshes.size()};
+	m_object_name_inheriting_submeshes_count =
+		m_is_object_name_defined ? std::min(m_object_name_inheriting_submeshes_count, submeshes_count - 1) : submeshes_count;
+	m_material_name_inheriting_submeshes_count =
+		m_is_material_name_defined ? std::min(m_material_name_inheriting_submeshes_count, submeshes_count - 1) : submeshes_count;
+}
+
+void obj_mesh_importer::add_submeshes(mesh& m) const
+{
+	std::vector<vector3f> const& vertices = m.get_vertices();
+	std::vector<unsigned int> const& indices = m.get_indices();
+
+	for (submesh const& s : m_submeshes)
+	{
+		if (s.index_count == 0)
+		{
+			continue;
+		}
+
+		submesh result{s};
+		result.bounding_box = aabb<vector3f>{vector3f{0.0f, 0.0f, 0.0f}, vector3f{0.0f, 0.0f, 0.0f}};
+
+		bool is_box_empty{true};
+		for (unsigned int i{s.index_offset}; i < s.index_offset + s.index_count; ++i)
+		{
+			// Indices are not validated while reading
+			//
+			if (indices[i] >= vertices.size())
+			{
+				continue;
+			}
+
+			vector3f const& v = vertices[indices[i]];
+			if (is_box_empty)
+			{
+				result.bounding_box = aabb<vector3f>{v, v};
+				is_box_empty = false;
+			}
+
+			result.bounding_box.from = vector3f{std::min(result.bounding_box.from.x, v.x), std::min(result.bounding_box.from.y, v.y), std::min(result.bounding_box.from.z, v.z)};
+			result.bounding_box.to = vector3f{std::max(result.bounding_box.to.x, v.x), std::max(result.bounding_box.to.y, v.y), std::max(result.bounding_box.to.z, v.z)};
+		}
+
+		m.get_submeshes().push_back(result);
+	}
+}
+
 void obj_mesh_importer::on_reading_started()
 {
 	m_vertices.clear();
@@ -287,6 +1010,16 @@ void obj_mesh_importer::on_reading_started()
 
 	m_normals.clear();
 	m_normals_indices.clear();
+
+	m_submeshes.clear();
+	m_object_name.clear();
+	m_material_name.clear();
+	m_is_object_name_defined = false;
+	m_is_material_name_defined = false;
+	m_object_name_inheriting_submeshes_count = 0;
+	m_material_name_inheriting_submeshes_count = 0;
+
+	m_material_libraries.clear();
 }
 
 void obj_mesh_importer::on_vertex_def(float const x, float const y, float const z)
@@ -312,6 +1045,12 @@ void obj_mesh_importer::on_normal_def(float const x, float const y, float const
 
 void obj_mesh_importer::on_face_pos_def(unsigned int vertex_index0, unsigned int vertex_index1, unsigned int vertex_index2)
 {
+	if (m_submeshes.empty())
+	{
+		start_submesh();
+	}
+	m_submeshes.back().index_count += 3;
+
 	m_indices.push_back(vertex_index0);
 	m_indices.push_back(vertex_index1);
 	m_indices.push_back(vertex_index2);
@@ -337,6 +1076,51 @@ void obj_mesh_importer::on_face_normal_def(unsigned int normal_index0, unsigned
 	}
 }
 
+void obj_mesh_importer::on_object_def(std::string const& name)
+{
+	m_object_name = name;
+	m_is_object_name_defined = true;
+
+	start_submesh();
+}
+
+void obj_mesh_importer::on_group_def(std::string const& name)
+{
+	// Groups split mesh the same way objects do
+	//
+	on_object_def(name);
+}
+
+void obj_mesh_importer::on_material_usage_def(std::string const& name)
+{
+	m_material_name = name;
+	m_is_material_name_defined = true;
+
+	start_submesh();
+}
+
+void obj_mesh_importer::on_material_library_def(std::string const& names)
+{
+	char const* p{names.data()};
+	char const* const end{p + names.size()};
+
+	while (p < end)
+	{
+		skip_spaces(p, end);
+
+		char const* const name{p};
+		while ((p < end) && !is_space(*p))
+		{
+			++p;
+		}
+
+		if (p != name)
+		{
+			m_material_libraries.push_back(std::string(name, p));
+		}
+	}
+}
+
 // Helper functions
 //
 
@@ -345,5 +1129,191 @@ mesh lantern::load_mesh_from_obj(std::string const& path, bool const read_texcoo
 	obj_mesh_importer importer{read_texcoords, read_normals};
 	importer.read(path);
 
-	return importer.get_mesh();
+	return importer.take_mesh();
+}
+
+/** Gets directory part of file path
+* @param path File path
+* @returns Directory with trailing separator, empty if path has no directory
+*/
+static std::string get_directory(std::string const& path)
+{
+	size_t const separator_position{path.find_last_of("/\\")};
+
+	return (separator_position == std::string::npos) ? std::string{} : path.substr(0, separator_position + 1);
+}
+
+/** Checks if file path is absolute
+* @param path File path
+* @returns True if path starts from root or drive letter
+*/
+static bool is_absolute_path(std::string const& path)
+{
+	return (!path.empty() && ((path[0] == '/') || (path[0] == '\\'))) || ((path.size() > 1) && (path[1] == ':'));
+}
+
+std::vector<obj_material> lantern::load_materials_from_mtl(std::string const& path)
+{
+	memory_mapped_file const file{path};
+	std::string const directory{get_directory(path)};
+
+	std::vector<obj_material> materials;
+
+	char const* p{file.get_data()};
+	char const* const end{p + file.get_size()};
+	unsigned int line_number{0};
+
+	while (p < end)
+	{
+		++line_number;
+
+		skip_spaces(p, end);
+
+		char const* const token{p};
+		while ((p < end) && !is_space(*p) && !is_line_end(*p))
+		{
+			++p;
+		}
+		char const* const token_end{p};
+
+		if (is_token_equal(token, token_end, "newmtl"))
+		{
+			materials.push_back(obj_material{parse_name(p, end), color{1.0f, 1.0f, 1.0f, 1.0f}, std::string{}});
+		}
+		else if (is_token_equal(token, token_end, "Kd") && !materials.empty())
+		{
+			float values[3];
+			if (!parse_floats(p, end, values, 3))
+			{
+				throw std::runtime_error("Malformed .mtl definition at line " + std::to_string(line_number));
+			}
+
+			materials.back().diffuse_color = color{values[0], values[1], values[2], 1.0f};
+		}
+		else if (is_token_equal(token, token_end, "map_Kd") && !materials.empty())
+		{
+			// Texture path goes after options, which start with '-' and have arguments
+			//
+			std::string texture_path{parse_name(p, end)};
+			if (!texture_path.empty() && (texture_path[0] == '-'))
+			{
+				texture_path = texture_path.substr(texture_path.find_last_of(" \t") + 1);
+			}
+
+			materials.back().diffuse_texture_path = is_absolute_path(texture_path) ? texture_path : directory + texture_path;
+		}
+
+		skip_line(p, end);
+	}
+
+	return materials;
+}
+
+mesh lantern::load_mesh_from_obj(std::string const& path, bool const read_texcoords, bool const read_normals, std::vector<obj_material>& materials)
+{
+	obj_mesh_importer importer{read_texcoords, read_normals};
+	importer.read(path);
+
+	std::string const directory{get_directory(path)};
+	for (std::string const& library : importer.get_material_libraries())
+	{
+		std::vector<obj_material> const library_materials{load_materials_from_mtl(is_absolute_path(library) ? library : directory + library)};
+		materials.insert(materials.end(), library_materials.begin(), library_materials.end());
+	}
+
+	return importer.take_mesh();
+}
+
+mesh lantern::load_mesh_from_obj(std::string const& path, bool const read_texcoords, bool const read_normals, thread_pool& pool)
+{
+	obj_mesh_importer importer{read_texcoords, read_normals};
+	importer.read_parallel(path, pool);
+
+	return importer.take_mesh();
+}
+
+/** Gets file modification time
+* @param path File path
+* @param time Modification time
+* @returns False if file doesn't exist
+*/
+static bool get_modification_time(std::string const& path, time_t& time)
+{
+	struct stat file_status;
+	if (stat(path.c_str(), &file_status) != 0)
+	{
+		return false;
+	}
+
+	time = file_status.st_mtime;
+
+	return true;
+}
+
+mesh lantern::load_mesh_from_obj_cached(std::string const& path, bool const read_texcoords, bool const read_normals, obj_cache_validation_option const validation)
+{
+	std::string const cache_path{path + ".lmesh"};
+
+	memory_mapped_file const file{path};
+
+	binary_mesh_source_info source_info{
+		file.get_size(),
+		0,
+		(read_texcoords ? 1u : 0u) | (read_normals ? 2u : 0u)};
+
+	bool const is_content_hash_validation{validation == obj_cache_validation_option::content_hash};
+	if (is_content_hash_validation)
+	{
+		source_info.content_hash = get_content_hash(file.get_data(), file.get_size());
+	}
+
+	// Try the cache. Missing or corrupted cache is rebuilt
+	//
+
+	time_t obj_time;
+	time_t cache_time;
+	bool const is_cache_fresh{
+		is_content_hash_validation ||
+		(get_modification_time(path, obj_time) && get_modification_time(cache_path, cache_time) && (cache_time >= obj_time))};
+
+	if (is_cache_fresh)
+	{
+		try
+		{
+			binary_mesh_source_info const cached_source_info{get_binary_mesh_source_info(cache_path)};
+
+			if ((cached_source_info.size == source_info.size) &&
+				(cached_source_info.flags == source_info.flags) &&
+				(!is_content_hash_validation || (cached_source_info.content_hash == source_info.content_hash)))
+			{
+				return load_mesh_from_binary(cache_path);
+			}
+		}
+		catch (std::runtime_error const&)
+		{
+		}
+	}
+
+	// Import .obj and save the cache. Hash is stored anyway so that the cache can be validated by content later
+	//
+
+	obj_mesh_importer importer{read_texcoords, read_normals};
+	importer.parse(file.get_data(), file.get_size());
+	mesh result{importer.take_mesh()};
+
+	if (!is_content_hash_validation)
+	{
+		source_info.content_hash = get_content_hash(file.get_data(), file.get_size());
+	}
+
+	try
+	{
+		save_mesh_to_binary(result, cache_path, source_info);
+	}
+	catch (std::runtime_error const&)
+	{
+		// Caching is optional, e.g. assets directory may be read-only
+	}
+
+	return result;
 }
@@ -3,7 +3,8 @@
 using namespace lantern;
 
 rasterizing_stage::rasterizing_stage()
-	: m_rasterization_algorithm{rasterization_algorithm_option::homogeneous}
+	: m_rasterization_algorithm{rasterization_algorithm_option::homogeneous},
+	  m_scissor_enabled{false}
 {
 
 }
@@ -16,4 +17,15 @@ void rasterizing_stage::set_rasterization_algorithm(rasterization_algorithm_opti
 rasterization_algorithm_option rasterizing_stage::get_rasterization_algorithm() const
 {
 	return m_rasterization_algorithm;
+}
+
+void rasterizing_stage::set_scissor_rectangle(aabb<vector2ui> const& rectangle)
+{
+	m_scissor_enabled = true;
+	m_scissor_rectangle = rectangle;
+}
+
+void rasterizing_stage::reset_scissor_rectangle()
+{
+	m_scissor_enabled = false;
 }
\ No newline at end of file
@@ -1,8 +1,14 @@
+#include <cmath>
 #include "renderer.h"
+#include "math_common.h"
 
 using namespace lantern;
 
 renderer::renderer()
+	: m_rendering_mode{rendering_mode_option::serial},
+	  m_tile_size{64},
+	  m_threads_count{thread_pool::get_hardware_threads_count()},
+	  m_tiles_row_size{0}
 {
 
 }
@@ -20,4 +26,94 @@ rasterizing_stage& renderer::get_rasterizing_stage()
 merging_stage& renderer::get_merging_stage()
 {
 	return m_merging_stage;
+}
+
+void renderer::set_rendering_mode(rendering_mode_option const mode)
+{
+	m_rendering_mode = mode;
+}
+
+rendering_mode_option renderer::get_rendering_mode() const
+{
+	return m_rendering_mode;
+}
+
+void renderer::set_tile_size(unsigned int const size)
+{
+	m_tile_size = size;
+}
+
+unsigned int renderer::get_tile_size() const
+{
+	return m_tile_size;
+}
+
+void renderer::set_threads_count(unsigned int const count)
+{
+	m_threads_count = count;
+}
+
+unsigned int renderer::get_threads_count() const
+{
+	return m_threads_count;
+}
+
+void renderer::bin_triangle(binned_triangle const& triangle, bool const homogeneous, texture const& target_texture)
+{
+	unsigned int const triangle_index{static_cast<unsigned int>(m_binned_triangles.size())};
+	m_binned_triangles.push_back(triangle);
+
+	unsigned int const tiles_count{static_cast<unsigned int>(m_tiles_triangles.size())};
+	unsigned int const tiles_column_size{tiles_count / m_tiles_row_size};
+
+	// Find screen space bounding box. Homogeneous rasterizer gets vertices before division,
+	// if one of them is close to the eye plane it's not possible to bound the triangle, so it goes to every tile
+	//
+
+	vector2f screen_points[3];
+	vector4f const* vertices[3]{&triangle.vertex0, &triangle.vertex1, &triangle.vertex2};
+	for (unsigned int i{0}; i < 3; ++i)
+	{
+		vector4f const& v = *vertices[i];
+
+		if (homogeneous)
+		{
+			if (v.w < FLOAT_EPSILON)
+			{
+				for (std::vector<unsigned int>& tile_triangles : m_tiles_triangles)
+				{
+					tile_triangles.push_back(triangle_index);
+				}
+
+				return;
+			}
+
+			screen_points[i] = vector2f{v.x / v.w, v.y / v.w};
+		}
+		else
+		{
+			screen_points[i] = vector2f{v.x, v.y};
+		}
+	}
+
+	float const min_x{std::min(std::min(screen_points[0].x, screen_points[1].x), screen_points[2].x)};
+	float const max_x{std::max(std::max(screen_points[0].x, screen_points[1].x), screen_points[2].x)};
+	float const min_y{std::min(std::min(screen_points[0].y, screen_points[1].y), screen_points[2].y)};
+	float const max_y{std::max(std::max(screen_points[0].y, screen_points[1].y), screen_points[2].y)};
+
+	// Expand bounding box by one pixel to be conservative about precision
+	//
+	float const tile_size{static_cast<float>(m_tile_size)};
+	int const from_tile_x{std::max(static_cast<int>(std::floor((min_x - 1.0f) / tile_size)), 0)};
+	int const from_tile_y{std::max(static_cast<int>(std::floor((min_y - 1.0f) / tile_size)), 0)};
+	int const to_tile_x{std::min(static_cast<int>(std::floor((max_x + 1.0f) / tile_size)), static_cast<int>(m_tiles_row_size) - 1)};
+	int const to_tile_y{std::min(static_cast<int>(std::floor((max_y + 1.0f) / tile_size)), static_cast<int>(tiles_column_size) - 1)};
+
+	for (int y{from_tile_y}; y <= to_tile_y; ++y)
+	{
+		for (int x{from_tile_x}; x <= to_tile_x; ++x)
+		{
+			m_tiles_triangles[y * m_tiles_row_size + x].push_back(triangle_index);
+		}
+	}
 }
\ No newline at end of file
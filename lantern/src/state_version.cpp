@@ -0,0 +1,12 @@
+#include <atomic>
+#include "state_version.h"
+
+using namespace lantern;
+
+/** The last generated version */
+static std::atomic<uint64_t> last_state_version{0};
+
+uint64_t lantern::get_next_state_version()
+{
+	return ++last_state_version;
+}
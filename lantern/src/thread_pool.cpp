@@ -0,0 +1,122 @@
+#include "thread_pool.h"
+
+using namespace lantern;
+
+thread_pool::thread_pool(unsigned int const threads_count)
+	: m_task{nullptr},
+	  m_tasks_count{0},
+	  m_next_task_index{0},
+	  m_batch_generation{0},
+	  m_busy_workers_count{0},
+	  m_stopping{false}
+{
+	// Calling thread is the worker with zero index
+	//
+	for (unsigned int i{1}; i < threads_count; ++i)
+	{
+		m_threads.push_back(std::thread{&thread_pool::worker_loop, this, i});
+	}
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+		m_stopping = true;
+	}
+	m_batch_started.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+unsigned int thread_pool::get_threads_count() const
+{
+	return static_cast<unsigned int>(m_threads.size()) + 1;
+}
+
+void thread_pool::run(unsigned int const tasks_count, task_function const& task)
+{
+	if (m_threads.empty())
+	{
+		for (unsigned int i{0}; i < tasks_count; ++i)
+		{
+			task(i, 0);
+		}
+
+		return;
+	}
+
+	// Publish the batch
+	//
+	{
+		std::lock_guard<std::mutex> lock{m_mutex};
+
+		m_task = &task;
+		m_tasks_count = tasks_count;
+		m_next_task_index = 0;
+		m_busy_workers_count = static_cast<unsigned int>(m_threads.size());
+		++m_batch_generation;
+	}
+	m_batch_started.notify_all();
+
+	// Take part in execution
+	execute_tasks(0);
+
+	// Wait for the others
+	//
+	std::unique_lock<std::mutex> lock{m_mutex};
+	m_batch_finished.wait(lock, [this] { return m_busy_workers_count == 0; });
+
+	m_task = nullptr;
+}
+
+unsigned int thread_pool::get_hardware_threads_count()
+{
+	unsigned int const count{std::thread::hardware_concurrency()};
+	return (count == 0) ? 1 : count;
+}
+
+void thread_pool::worker_loop(unsigned int const worker_index)
+{
+	unsigned int last_batch_generation{0};
+
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock{m_mutex};
+			m_batch_started.wait(lock, [this, last_batch_generation] { return m_stopping || (m_batch_generation != last_batch_generation); });
+
+			if (m_stopping)
+			{
+				return;
+			}
+
+			last_batch_generation = m_batch_generation;
+		}
+
+		execute_tasks(worker_index);
+
+		{
+			std::lock_guard<std::mutex> lock{m_mutex};
+			--m_busy_workers_count;
+		}
+		m_batch_finished.notify_one();
+	}
+}
+
+void thread_pool::execute_tasks(unsigned int const worker_index)
+{
+	while (true)
+	{
+		unsigned int const task_index{m_next_task_index++};
+		if (task_index >= m_tasks_count)
+		{
+			return;
+		}
+
+		(*m_task)(task_index, worker_index);
+	}
+}
\ No newline at end of file
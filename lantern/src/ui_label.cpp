@@ -1,3 +1,4 @@
+#include <utility>
 #include "ui_label.h"
 
 using namespace lantern;
@@ -113,7 +114,7 @@ void ui_label::update_mesh()
 		char_mesh.get_vector2f_attributes().push_back(mesh_attribute_info<vector2f>{TEXCOORD_ATTR_ID, quad_uvs, quad_uvs_indices, attribute_interpolation_option::linear});
 
 		// Save it
-		m_meshes.push_back(char_mesh);
+		m_meshes.push_back(std::move(char_mesh));
 	}
 
 }
\ No newline at end of file
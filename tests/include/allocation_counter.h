@@ -0,0 +1,10 @@
+#ifndef LANTERN_ALLOCATION_COUNTER_H
+#define LANTERN_ALLOCATION_COUNTER_H
+
+/** Gets count of heap allocations made with operator new since the tests start.
+* Tests executable replaces global operator new to count them
+* @returns Allocations count
+*/
+unsigned long long get_allocations_count();
+
+#endif // LANTERN_ALLOCATION_COUNTER_H
@@ -0,0 +1,49 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "allocation_counter.h"
+
+static std::atomic<unsigned long long> allocations_count{0};
+
+unsigned long long get_allocations_count()
+{
+	return allocations_count.load();
+}
+
+void* operator new(std::size_t size)
+{
+	++allocations_count;
+
+	void* const memory{std::malloc(size == 0 ? 1 : size)};
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc{};
+	}
+
+	return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
@@ -0,0 +1,240 @@
+#include <vector>
+#include "assert_utils.h"
+#include "draw_list.h"
+
+using namespace lantern;
+
+/** Shader recording order in which draws get shaded, it's copied into draw list so writes into external log */
+class logging_shader final
+{
+public:
+	logging_shader(unsigned int const id, std::vector<unsigned int>* const log)
+		: m_id{id}, m_log{log}
+	{
+
+	}
+
+	static shader_bind_points<logging_shader, color> get_color_bind_points()
+	{
+		return shader_bind_points<logging_shader, color>{};
+	}
+
+	static shader_bind_points<logging_shader, float> get_float_bind_points()
+	{
+		return shader_bind_points<logging_shader, float>{};
+	}
+
+	static shader_bind_points<logging_shader, vector2f> get_vector2f_bind_points()
+	{
+		return shader_bind_points<logging_shader, vector2f>{};
+	}
+
+	static shader_bind_points<logging_shader, vector3f> get_vector3f_bind_points()
+	{
+		return shader_bind_points<logging_shader, vector3f>{};
+	}
+
+	vector4f process_vertex(vector4f const& vertex)
+	{
+		return vertex;
+	}
+
+	color process_pixel(vector2ui const&)
+	{
+		if (m_log->empty() || (m_log->back() != m_id))
+		{
+			m_log->push_back(m_id);
+		}
+
+		return color::WHITE;
+	}
+
+private:
+	unsigned int m_id;
+	std::vector<unsigned int>* m_log;
+};
+
+/** The same shader of another type */
+class other_logging_shader final
+{
+public:
+	other_logging_shader(unsigned int const id, std::vector<unsigned int>* const log)
+		: m_shader{id, log}
+	{
+
+	}
+
+	static shader_bind_points<other_logging_shader, color> get_color_bind_points()
+	{
+		return shader_bind_points<other_logging_shader, color>{};
+	}
+
+	static shader_bind_points<other_logging_shader, float> get_float_bind_points()
+	{
+		return shader_bind_points<other_logging_shader, float>{};
+	}
+
+	static shader_bind_points<other_logging_shader, vector2f> get_vector2f_bind_points()
+	{
+		return shader_bind_points<other_logging_shader, vector2f>{};
+	}
+
+	static shader_bind_points<other_logging_shader, vector3f> get_vector3f_bind_points()
+	{
+		return shader_bind_points<other_logging_shader, vector3f>{};
+	}
+
+	vector4f process_vertex(vector4f const& vertex)
+	{
+		return vertex;
+	}
+
+	color process_pixel(vector2ui const& pixel)
+	{
+		return m_shader.process_pixel(pixel);
+	}
+
+private:
+	logging_shader m_shader;
+};
+
+/** Builds square covering the whole viewport
+* @param z Depth of the square
+* @returns Mesh
+*/
+static mesh create_square_mesh(float const z)
+{
+	return mesh{
+		std::vector<vector3f>{vector3f{-1.0f, -1.0f, z}, vector3f{1.0f, -1.0f, z}, vector3f{-1.0f, 1.0f, z}, vector3f{1.0f, 1.0f, z}},
+		std::vector<unsigned int>{0, 1, 2, 2, 1, 3}};
+}
+
+TEST(draw_list, draws_are_executed_in_sorted_order)
+{
+	renderer r;
+	texture target{8, 8};
+	depth_buffer depth{8, 8};
+
+	mesh const near_square{create_square_mesh(-0.5f)};
+	mesh const middle_square{create_square_mesh(0.0f)};
+	mesh const far_square{create_square_mesh(0.5f)};
+
+	std::vector<unsigned int> log;
+
+	draw_settings const opaque{&target, &depth, false, 0, 0.0f};
+	draw_settings const transparent{&target, nullptr, true, 0, 0.0f};
+	draw_settings const overlay{&target, nullptr, false, 1, 0.0f};
+
+	// Recorded in the worst order: overlay first, far objects first, transparent objects from near to far
+	//
+
+	draw_list list;
+	list.add_mesh(near_square, logging_shader{0, &log}, overlay);
+
+	draw_settings far_opaque{opaque};
+	far_opaque.depth = 3.0f;
+	list.add_mesh(far_square, logging_shader{1, &log}, far_opaque);
+
+	draw_settings near_opaque{opaque};
+	near_opaque.depth = 1.0f;
+	list.add_mesh(near_square, logging_shader{2, &log}, near_opaque);
+
+	draw_settings near_transparent{transparent};
+	near_transparent.depth = 1.5f;
+	list.add_mesh(middle_square, logging_shader{3, &log}, near_transparent);
+
+	draw_settings far_transparent{transparent};
+	far_transparent.depth = 2.5f;
+	list.add_mesh(middle_square, logging_shader{4, &log}, far_transparent);
+
+	ASSERT_EQ(list.size(), 5);
+
+	target.clear(0);
+	depth.clear(depth_buffer::FAR_DEPTH);
+	r.get_merging_stage().set_alpha_blending_enabled(false);
+	list.execute(r);
+
+	// Far opaque square is hidden by the near one drawn before it, so it's never shaded
+	//
+	ASSERT_TRUE(log == (std::vector<unsigned int>{2, 4, 3, 0}));
+
+	// List is cleared, blending mode is restored
+	//
+	ASSERT_EQ(list.size(), 0);
+	ASSERT_FALSE(r.get_merging_stage().get_alpha_blending_enabled());
+
+	log.clear();
+	list.execute(r);
+	ASSERT_TRUE(log.empty());
+}
+
+TEST(draw_list, opaque_draws_are_grouped_by_shader_type)
+{
+	renderer r;
+	texture target{8, 8};
+	depth_buffer depth{8, 8};
+
+	mesh const square{create_square_mesh(0.0f)};
+
+	std::vector<unsigned int> log;
+
+	// Depth of close objects matters less than switching between shaders
+	//
+	draw_settings const settings{&target, &depth, false, 0, 10.0f};
+	draw_settings slightly_farther{settings};
+	slightly_farther.depth = 10.001f;
+
+	draw_list list;
+	list.add_mesh(square, logging_shader{0, &log}, settings);
+	list.add_mesh(square, other_logging_shader{1, &log}, settings);
+	list.add_mesh(square, logging_shader{2, &log}, slightly_farther);
+	list.add_mesh(square, other_logging_shader{3, &log}, settings);
+
+	// Depth write is disabled for every draw to be shaded
+	//
+	target.clear(0);
+	depth.clear(depth_buffer::FAR_DEPTH);
+	r.get_merging_stage().set_depth_write_enabled(false);
+	list.execute(r);
+	r.get_merging_stage().set_depth_write_enabled(true);
+
+	// Equal keys keep recording order
+	//
+	ASSERT_TRUE(log == (std::vector<unsigned int>{0, 2, 1, 3}));
+}
+
+TEST(draw_list, sort_key)
+{
+	texture target{1, 1};
+	depth_buffer depth{1, 1};
+
+	draw_settings const opaque{&target, &depth, false, 0, 0.0f};
+	draw_settings const transparent{&target, nullptr, true, 0, 0.0f};
+
+	draw_settings near_opaque{opaque};
+	near_opaque.depth = 0.5f;
+	draw_settings far_opaque{opaque};
+	far_opaque.depth = 100.0f;
+	draw_settings near_transparent{transparent};
+	near_transparent.depth = 0.5f;
+	draw_settings far_transparent{transparent};
+	far_transparent.depth = 100.0f;
+
+	ASSERT_LT(draw_list::get_sort_key(0, near_opaque, 0), draw_list::get_sort_key(0, far_opaque, 0));
+	ASSERT_LT(draw_list::get_sort_key(0, far_opaque, 0), draw_list::get_sort_key(0, far_transparent, 0));
+	ASSERT_LT(draw_list::get_sort_key(0, far_transparent, 0), draw_list::get_sort_key(0, near_transparent, 0));
+
+	// Objects behind the camera go first among opaque draws
+	//
+	draw_settings behind_opaque{opaque};
+	behind_opaque.depth = -1.0f;
+	ASSERT_EQ(draw_list::get_sort_key(0, behind_opaque, 0), draw_list::get_sort_key(0, opaque, 0));
+	ASSERT_LT(draw_list::get_sort_key(0, behind_opaque, 0), draw_list::get_sort_key(0, near_opaque, 0));
+
+	// Targets and layers come before depth
+	//
+	draw_settings overlay{near_transparent};
+	overlay.layer = 1;
+	ASSERT_LT(draw_list::get_sort_key(0, near_transparent, 0), draw_list::get_sort_key(0, overlay, 0));
+	ASSERT_LT(draw_list::get_sort_key(0, overlay, 0), draw_list::get_sort_key(1, far_opaque, 0));
+}
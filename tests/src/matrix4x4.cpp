@@ -1,3 +1,4 @@
+#include <vector>
 #include "assert_utils.h"
 #include "matrix4x4.h"
 
@@ -109,3 +110,36 @@ TEST(matrix4x4f, rotation)
 	vector4f const v_rotated_around_axis{v * m_rotation_around_axis};
 	assert_vectors4_near(v_rotated_around_axis, vector4f{1.3837f, -0.0864f, 0.5725f, v.w});
 }
+
+TEST(matrix4x4f, vectors_array_transformation)
+{
+	matrix4x4f const m{matrix4x4f::rotation_around_axis(vector3f{0.3f, -1.0f, 0.5f}, 0.7f) * matrix4x4f::translation(1.5f, -2.0f, 0.25f)};
+
+	// Count that is not a multiple of four, so that vectors are transformed both by groups and one by one
+	//
+	std::vector<vector4f> vectors;
+	for (unsigned int i{0}; i < 11; ++i)
+	{
+		vectors.push_back(vector4f{static_cast<float>(i), -0.5f * static_cast<float>(i), 3.0f - static_cast<float>(i), (i % 2 == 0) ? 1.0f : 0.0f});
+	}
+
+	std::vector<vector4f> transformed(vectors.size());
+	transform_vectors(vectors.data(), transformed.data(), vectors.size(), m);
+
+	for (size_t i{0}; i < vectors.size(); ++i)
+	{
+		vector4f const expected{vectors[i] * m};
+		ASSERT_EQ(transformed[i].x, expected.x);
+		ASSERT_EQ(transformed[i].y, expected.y);
+		ASSERT_EQ(transformed[i].z, expected.z);
+		ASSERT_EQ(transformed[i].w, expected.w);
+	}
+
+	// Vectors can be transformed in place
+	//
+	transform_vectors(vectors.data(), vectors.data(), vectors.size(), m);
+	for (size_t i{0}; i < vectors.size(); ++i)
+	{
+		assert_vectors4_near(vectors[i], transformed[i]);
+	}
+}
@@ -0,0 +1,67 @@
+#include "assert_utils.h"
+#include "obj_import.h"
+
+using namespace lantern;
+
+static mesh_attribute_info<vector2f> const& get_texcoords(mesh const& m)
+{
+	return m.get_vector2f_attributes().at(0);
+}
+
+static mesh_attribute_info<vector3f> const& get_normals(mesh const& m)
+{
+	return m.get_vector3f_attributes().at(0);
+}
+
+TEST(mesh, compile_mesh)
+{
+	mesh const source{load_mesh_from_obj("resources/unit_cube_pos_texcoord_normal.obj", true, true)};
+	mesh const compiled{compile_mesh(source)};
+
+	std::vector<unsigned int> const& source_indices = source.get_indices();
+	std::vector<unsigned int> const& compiled_indices = compiled.get_indices();
+
+	ASSERT_EQ(compiled_indices.size(), source_indices.size());
+
+	// Cube corners shared by triangles of the same face become shared vertices
+	//
+	ASSERT_LT(compiled.get_vertices().size(), source_indices.size());
+	ASSERT_GT(compiled.get_vertices().size(), source.get_vertices().size());
+
+	// Attributes are stored per vertex
+	//
+	ASSERT_TRUE(get_texcoords(compiled).get_indices().empty());
+	ASSERT_EQ(get_texcoords(compiled).get_data().size(), compiled.get_vertices().size());
+	ASSERT_TRUE(get_normals(compiled).get_indices().empty());
+	ASSERT_EQ(get_normals(compiled).get_data().size(), compiled.get_vertices().size());
+	ASSERT_EQ(get_texcoords(compiled).get_interpolation_option(), get_texcoords(source).get_interpolation_option());
+
+	// Every triangle corner keeps its values
+	//
+	for (size_t i{0}; i < source_indices.size(); ++i)
+	{
+		unsigned int const vertex_index{compiled_indices[i]};
+
+		assert_vectors3_near(source.get_vertices()[source_indices[i]], compiled.get_vertices()[vertex_index]);
+
+		assert_vectors2_near(
+			get_texcoords(source).get_data()[get_texcoords(source).get_indices()[i]],
+			get_texcoords(compiled).get_data()[vertex_index]);
+
+		assert_vectors3_near(
+			get_normals(source).get_data()[get_normals(source).get_indices()[i]],
+			get_normals(compiled).get_data()[vertex_index]);
+	}
+}
+
+TEST(mesh, compile_mesh_with_mismatching_attribute_indices)
+{
+	mesh source{
+		std::vector<vector3f>{vector3f{0.0f, 0.0f, 0.0f}, vector3f{1.0f, 0.0f, 0.0f}, vector3f{0.0f, 1.0f, 0.0f}},
+		std::vector<unsigned int>{0, 1, 2}};
+
+	source.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, std::vector<color>{color::RED}, std::vector<unsigned int>{0}, attribute_interpolation_option::linear});
+
+	ASSERT_THROW(compile_mesh(source), std::runtime_error);
+}
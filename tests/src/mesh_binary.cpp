@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <fstream>
+#include "assert_utils.h"
+#include "mesh_binary.h"
+#include "obj_import.h"
+
+using namespace lantern;
+
+/** Checks that meshes are exactly the same
+* @param expected Expected mesh
+* @param actual Actual mesh
+*/
+static void assert_meshes_equal(mesh const& expected, mesh const& actual)
+{
+	ASSERT_EQ(actual.get_vertices().size(), expected.get_vertices().size());
+	for (size_t i{0}; i < expected.get_vertices().size(); ++i)
+	{
+		ASSERT_TRUE(actual.get_vertices()[i] == expected.get_vertices()[i]);
+	}
+
+	ASSERT_TRUE(actual.get_indices() == expected.get_indices());
+
+	ASSERT_EQ(actual.get_vector2f_attributes().size(), expected.get_vector2f_attributes().size());
+	for (size_t i{0}; i < expected.get_vector2f_attributes().size(); ++i)
+	{
+		mesh_attribute_info<vector2f> const& expected_attribute = expected.get_vector2f_attributes()[i];
+		mesh_attribute_info<vector2f> const& actual_attribute = actual.get_vector2f_attributes()[i];
+
+		ASSERT_EQ(actual_attribute.get_id(), expected_attribute.get_id());
+		ASSERT_EQ(actual_attribute.get_interpolation_option(), expected_attribute.get_interpolation_option());
+		ASSERT_TRUE(actual_attribute.get_data() == expected_attribute.get_data());
+		ASSERT_TRUE(actual_attribute.get_indices() == expected_attribute.get_indices());
+	}
+
+	ASSERT_EQ(actual.get_vector3f_attributes().size(), expected.get_vector3f_attributes().size());
+	for (size_t i{0}; i < expected.get_vector3f_attributes().size(); ++i)
+	{
+		mesh_attribute_info<vector3f> const& expected_attribute = expected.get_vector3f_attributes()[i];
+		mesh_attribute_info<vector3f> const& actual_attribute = actual.get_vector3f_attributes()[i];
+
+		ASSERT_EQ(actual_attribute.get_id(), expected_attribute.get_id());
+		ASSERT_EQ(actual_attribute.get_interpolation_option(), expected_attribute.get_interpolation_option());
+		ASSERT_TRUE(actual_attribute.get_data() == expected_attribute.get_data());
+		ASSERT_TRUE(actual_attribute.get_indices() == expected_attribute.get_indices());
+	}
+}
+
+TEST(mesh_binary, save_and_load)
+{
+	std::string const path{"mesh_binary_test.lmesh"};
+
+	mesh m{load_mesh_from_obj("resources/unit_cube_pos_texcoord_normal.obj", true, true)};
+	m.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, std::vector<color>{color::RED, color::GREEN}, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+	m.get_submeshes().push_back(
+		submesh{"cube", "stone", 6, 12, aabb<vector3f>{vector3f{0.0f, 0.0f, 0.0f}, vector3f{1.0f, 1.0f, 1.0f}}});
+
+	save_mesh_to_binary(m, path, binary_mesh_source_info{1, 2, 3});
+
+	mesh const loaded{load_mesh_from_binary(path)};
+	assert_meshes_equal(m, loaded);
+	ASSERT_EQ(loaded.get_color_attributes().size(), 1);
+	ASSERT_TRUE(loaded.get_color_attributes()[0].get_data() == m.get_color_attributes()[0].get_data());
+
+	ASSERT_EQ(loaded.get_submeshes().size(), m.get_submeshes().size());
+	ASSERT_EQ(loaded.get_submeshes().back().name, "cube");
+	ASSERT_EQ(loaded.get_submeshes().back().material_name, "stone");
+	ASSERT_EQ(loaded.get_submeshes().back().index_offset, 6);
+	ASSERT_EQ(loaded.get_submeshes().back().index_count, 12);
+	assert_vectors3_near(loaded.get_submeshes().back().bounding_box.to, vector3f{1.0f, 1.0f, 1.0f});
+
+	binary_mesh_source_info const source_info{get_binary_mesh_source_info(path)};
+	ASSERT_EQ(source_info.size, 1);
+	ASSERT_EQ(source_info.content_hash, 2);
+	ASSERT_EQ(source_info.flags, 3);
+
+	// Truncated file is detected
+	//
+	{
+		std::ofstream truncated{path, std::ios::binary | std::ios::trunc};
+		truncated << "LNTMESH";
+	}
+	ASSERT_THROW(load_mesh_from_binary(path), std::runtime_error);
+
+	std::remove(path.c_str());
+}
+
+TEST(mesh_binary, obj_cache)
+{
+	std::string const obj_path{"mesh_binary_cache_test.obj"};
+	std::string const cache_path{obj_path + ".lmesh"};
+
+	std::string const content{
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\n"
+		"vt 0 0\nvt 1 1\n"
+		"f 1/1 2/2 3/1\nf 2/2 4/1 3/2\n"};
+	{
+		std::ofstream file{obj_path, std::ios::binary | std::ios::trunc};
+		file << content;
+	}
+
+	std::remove(cache_path.c_str());
+
+	for (obj_cache_validation_option const validation : {obj_cache_validation_option::modification_time, obj_cache_validation_option::content_hash})
+	{
+		mesh const imported{load_mesh_from_obj(obj_path, true, false)};
+
+		// The first load creates the cache, the second one reads it
+		//
+		assert_meshes_equal(imported, load_mesh_from_obj_cached(obj_path, true, false, validation));
+		ASSERT_EQ(get_binary_mesh_source_info(cache_path).content_hash, get_content_hash(content.data(), content.size()));
+		assert_meshes_equal(imported, load_mesh_from_obj_cached(obj_path, true, false, validation));
+
+		// Different import params rebuild the cache
+		//
+		assert_meshes_equal(load_mesh_from_obj(obj_path, false, false), load_mesh_from_obj_cached(obj_path, false, false, validation));
+	}
+
+	// Cache built from different content of the same size is not used with content validation
+	//
+	std::string const changed_content{
+		"v 0 0 0\nv 2 0 0\nv 0 1 0\nv 1 1 0\n"
+		"vt 0 0\nvt 1 1\n"
+		"f 1/1 2/2 3/1\nf 2/2 4/1 3/2\n"};
+	{
+		std::ofstream file{obj_path, std::ios::binary | std::ios::trunc};
+		file << changed_content;
+	}
+
+	mesh const changed{load_mesh_from_obj_cached(obj_path, true, false, obj_cache_validation_option::content_hash)};
+	assert_floats_near(changed.get_vertices()[1].x, 2.0f);
+
+	std::remove(obj_path.c_str());
+	std::remove(cache_path.c_str());
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <utility>
+#include "assert_utils.h"
+#include "mesh_optimizer.h"
+
+using namespace lantern;
+
+/** Builds grid mesh of size x size quads with triangles in random order and x-coordinate stored as a float attribute
+* @param size Count of quads along every side
+* @returns Mesh
+*/
+static mesh create_shuffled_grid_mesh(unsigned int const size)
+{
+	std::vector<vector3f> vertices;
+	std::vector<float> xs;
+
+	for (unsigned int y{0}; y <= size; ++y)
+	{
+		for (unsigned int x{0}; x <= size; ++x)
+		{
+			vertices.push_back(vector3f{static_cast<float>(x), static_cast<float>(y), static_cast<float>((x * y) % 3)});
+			xs.push_back(static_cast<float>(x));
+		}
+	}
+
+	std::vector<unsigned int> indices;
+	for (unsigned int y{0}; y < size; ++y)
+	{
+		for (unsigned int x{0}; x < size; ++x)
+		{
+			unsigned int const corner{y * (size + 1) + x};
+
+			indices.insert(indices.end(), {corner, corner + 1, corner + size + 1});
+			indices.insert(indices.end(), {corner + 1, corner + size + 2, corner + size + 1});
+		}
+	}
+
+	unsigned int random_state{42};
+	unsigned int const triangles_count{static_cast<unsigned int>(indices.size() / 3)};
+	for (unsigned int i{triangles_count - 1}; i > 0; --i)
+	{
+		random_state = random_state * 1103515245 + 12345;
+		unsigned int const j{(random_state >> 8) % (i + 1)};
+
+		for (unsigned int k{0}; k < 3; ++k)
+		{
+			std::swap(indices[i * 3 + k], indices[j * 3 + k]);
+		}
+	}
+
+	mesh result{vertices, indices};
+	result.get_float_attributes().push_back(
+		mesh_attribute_info<float>{0, xs, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+
+	return result;
+}
+
+/** Gets triangles as sorted list of their vertices positions, which doesn't depend on triangles and vertices order
+* @param m Mesh
+* @returns Triangles
+*/
+static std::vector<std::vector<float>> get_sorted_triangles(mesh const& m)
+{
+	std::vector<std::vector<float>> triangles;
+
+	std::vector<unsigned int> const& indices = m.get_indices();
+	for (size_t i{0}; i < indices.size(); i += 3)
+	{
+		std::vector<float> triangle;
+		for (size_t j{0}; j < 3; ++j)
+		{
+			vector3f const& v = m.get_vertices()[indices[i + j]];
+			triangle.insert(triangle.end(), {v.x, v.y, v.z});
+		}
+
+		triangles.push_back(triangle);
+	}
+
+	std::sort(triangles.begin(), triangles.end());
+
+	return triangles;
+}
+
+TEST(mesh_optimizer, optimize_mesh)
+{
+	mesh const source{create_shuffled_grid_mesh(32)};
+
+	mesh optimized{source};
+	optimize_mesh(optimized);
+
+	// Triangles are the same, their vertices go in the same order
+	//
+	ASSERT_EQ(optimized.get_vertices().size(), source.get_vertices().size());
+	ASSERT_TRUE(get_sorted_triangles(optimized) == get_sorted_triangles(source));
+
+	// Attributes follow vertices
+	//
+	std::vector<float> const& xs = optimized.get_float_attributes().at(0).get_data();
+	for (size_t i{0}; i < optimized.get_vertices().size(); ++i)
+	{
+		assert_floats_near(xs[i], optimized.get_vertices()[i].x);
+	}
+
+	// Vertices are used in order
+	//
+	unsigned int next_new_vertex{0};
+	for (unsigned int const index : optimized.get_indices())
+	{
+		ASSERT_LE(index, next_new_vertex);
+		next_new_vertex = std::max(next_new_vertex, index + 1);
+	}
+
+	// Regular grid gets close to the optimum of 0.5
+	//
+	ASSERT_GT(get_average_cache_miss_ratio(source.get_indices(), DEFAULT_VERTEX_CACHE_SIZE), 2.0f);
+	ASSERT_LT(get_average_cache_miss_ratio(optimized.get_indices(), DEFAULT_VERTEX_CACHE_SIZE), 0.8f);
+}
+
+TEST(mesh_optimizer, average_cache_miss_ratio)
+{
+	// Quad: the second triangle reuses two vertices
+	//
+	assert_floats_near(get_average_cache_miss_ratio(std::vector<unsigned int>{0, 1, 2, 2, 1, 3}, 16), 2.0f);
+
+	// Cache of 3 vertices evicts the first one before it is used again
+	//
+	assert_floats_near(get_average_cache_miss_ratio(std::vector<unsigned int>{0, 1, 2, 3, 4, 0}, 3), 3.0f);
+	assert_floats_near(get_average_cache_miss_ratio(std::vector<unsigned int>{0, 1, 2, 3, 4, 0}, 5), 2.5f);
+}
+
+TEST(mesh_optimizer, submeshes_stay_intact)
+{
+	mesh source{create_shuffled_grid_mesh(16)};
+
+	unsigned int const split_offset{static_cast<unsigned int>(source.get_indices().size() / 3 / 2 * 3)};
+	unsigned int const indices_count{static_cast<unsigned int>(source.get_indices().size())};
+	source.get_submeshes().push_back(submesh{"first", "", 0, split_offset, aabb<vector3f>{}});
+	source.get_submeshes().push_back(submesh{"second", "", split_offset, indices_count - split_offset, aabb<vector3f>{}});
+
+	mesh optimized{source};
+	optimize_mesh(optimized);
+
+	// Every submesh consists of the same triangles
+	//
+	for (submesh const& s : source.get_submeshes())
+	{
+		mesh source_part{source.get_vertices(), std::vector<unsigned int>(source.get_indices().begin() + s.index_offset, source.get_indices().begin() + s.index_offset + s.index_count)};
+		mesh optimized_part{optimized.get_vertices(), std::vector<unsigned int>(optimized.get_indices().begin() + s.index_offset, optimized.get_indices().begin() + s.index_offset + s.index_count)};
+
+		ASSERT_TRUE(get_sorted_triangles(optimized_part) == get_sorted_triangles(source_part));
+	}
+
+	ASSERT_LT(
+		get_average_cache_miss_ratio(optimized.get_indices(), DEFAULT_VERTEX_CACHE_SIZE),
+		get_average_cache_miss_ratio(source.get_indices(), DEFAULT_VERTEX_CACHE_SIZE) / 2.0f);
+}
@@ -1,3 +1,6 @@
+#include <cstdio>
+#include <fstream>
+#include "allocation_counter.h"
 #include "assert_utils.h"
 #include "obj_import.h"
 
@@ -164,3 +167,259 @@ TEST(obj_import, import_obj_mesh)
 	assert_obj_texcoords(unit_cube_mesh_pos_texcoord_normal);
 	assert_obj_normals(unit_cube_mesh_pos_texcoord_normal);
 }
+
+TEST(obj_import, parse_formatting_variations)
+{
+	// Tabs, Windows line endings, comments, signs and scientific notation
+	//
+	std::string const content{
+		"# comment\r\n"
+		"v\t1.5 -2 +3e-1\r\n"
+		"v .25 1E2 -0.0 # trailing comment\r\n"
+		"\r\n"
+		"  v 7 8 9\n"
+		"vt 0.5 1 0\n"
+		"vn 0 0 -1\n"
+		"o unused\n"
+		"f 1/1/1\t2/1/1 3/1/1\n"
+		"f 3//1 2//1 1//1"};
+
+	obj_mesh_importer importer{true, true};
+	importer.parse(content.data(), content.size());
+	mesh const m{importer.get_mesh()};
+
+	ASSERT_EQ(m.get_vertices().size(), 3);
+	assert_vectors3_near(m.get_vertices()[0], vector3f{1.5f, -2.0f, 0.3f});
+	assert_vectors3_near(m.get_vertices()[1], vector3f{0.25f, 100.0f, 0.0f});
+	assert_vectors3_near(m.get_vertices()[2], vector3f{7.0f, 8.0f, 9.0f});
+
+	ASSERT_TRUE(m.get_indices() == (std::vector<unsigned int>{0, 1, 2, 2, 1, 0}));
+
+	assert_vectors2_near(m.get_vector2f_attributes().at(0).get_data().at(0), vector2f{0.5f, 1.0f});
+	assert_vectors3_near(m.get_vector3f_attributes().at(0).get_data().at(0), vector3f{0.0f, 0.0f, -1.0f});
+	ASSERT_EQ(m.get_vector3f_attributes().at(0).get_indices().size(), 6);
+}
+
+TEST(obj_import, parse_polygons_and_relative_indices)
+{
+	// Quad and pentagon with relative indices, faces of different formats go one after another
+	//
+	std::string const content{
+		"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+		"vt 0 0\nvt 1 1\n"
+		"vn 0 0 1\n"
+		"f 1/1/1 2/2/1 3/1/1 4/2/1\n"
+		"v 2 2 0\n"
+		"f -5/-2 -4/-1 -3/-2 -2/-1 -1/-2\n"
+		"f -1//-1 1//1 2//1\n"};
+
+	obj_mesh_importer importer{true, true};
+	importer.parse(content.data(), content.size());
+	mesh const m{importer.get_mesh()};
+
+	ASSERT_TRUE(m.get_indices() == (std::vector<unsigned int>{0, 1, 2, 0, 2, 3, 0, 1, 2, 0, 2, 3, 0, 3, 4, 4, 0, 1}));
+	ASSERT_TRUE(m.get_vector2f_attributes().at(0).get_indices() == (std::vector<unsigned int>{0, 1, 0, 0, 0, 1, 0, 1, 0, 0, 0, 1, 0, 1, 0}));
+	ASSERT_TRUE(m.get_vector3f_attributes().at(0).get_indices() == (std::vector<unsigned int>{0, 0, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST(obj_import, parse_malformed_definitions)
+{
+	std::string const missing_coordinate{"v 1 2\n"};
+	std::string const zero_index{"v 1 2 3\nf 0 1 1\n"};
+	std::string const two_vertices_face{"v 1 2 3\nv 1 2 3\nf 1 2\n"};
+	std::string const relative_index_out_of_range{"v 1 2 3\nv 1 2 3\nf 1 2 -3\n"};
+
+	obj_mesh_importer importer{false, false};
+	ASSERT_THROW(importer.parse(missing_coordinate.data(), missing_coordinate.size()), std::runtime_error);
+	ASSERT_THROW(importer.parse(zero_index.data(), zero_index.size()), std::runtime_error);
+	ASSERT_THROW(importer.parse(two_vertices_face.data(), two_vertices_face.size()), std::runtime_error);
+	ASSERT_THROW(importer.parse(relative_index_out_of_range.data(), relative_index_out_of_range.size()), std::runtime_error);
+	ASSERT_THROW(importer.read("resources/missing.obj"), std::runtime_error);
+}
+
+TEST(obj_import, parallel_reading_matches_serial)
+{
+	// Generate a file large enough to be split into many chunks, with faces of different formats and sizes.
+	// Vertices go in between faces, so that relative indices depend on definitions in preceding chunks
+	//
+
+	std::string const path{"parallel_reading_test.obj"};
+	{
+		std::ofstream file{path};
+
+		unsigned int const vertices_count{20000};
+		for (unsigned int i{0}; i < vertices_count; ++i)
+		{
+			file << "v " << i * 0.5f << " " << -(i * 0.25f) << " " << i % 7 << "\n";
+			file << "vt " << (i % 11) / 11.0f << " " << (i % 13) / 13.0f << "\n";
+			file << "vn 0 " << (i % 2) << " 1\n";
+
+			if (i % 1000 == 0)
+			{
+				file << "o object" << i / 3000 << "\n";
+			}
+			if (i % 1500 == 0)
+			{
+				file << "usemtl material" << i / 1500 << "\n";
+			}
+
+			if (i < 4)
+			{
+				continue;
+			}
+
+			int const i0{static_cast<int>(i) - 3};
+			if (i % 3 == 0)
+			{
+				file << "f " << i0 << "/" << i0 << "/" << i0 << " " << i0 + 1 << "/" << i0 + 1 << "/" << i0 + 1 << " " << i0 + 2 << "/" << i0 + 2 << "/" << i0 + 2 << "\n";
+			}
+			else if (i % 3 == 1)
+			{
+				file << "f -4//-4 -2//-2 -3//-3\n";
+			}
+			else
+			{
+				file << "f " << i0 << "/" << i0 << " " << i0 + 1 << "/" << i0 + 1 << " -1/-1 " << i0 + 2 << "/" << i0 + 2 << "\n";
+			}
+		}
+	}
+
+	mesh const serial_mesh{load_mesh_from_obj(path, true, true)};
+
+	thread_pool pool{4};
+	mesh const parallel_mesh{load_mesh_from_obj(path, true, true, pool)};
+
+	std::remove(path.c_str());
+
+	ASSERT_EQ(parallel_mesh.get_vertices().size(), serial_mesh.get_vertices().size());
+	for (size_t i{0}; i < serial_mesh.get_vertices().size(); ++i)
+	{
+		ASSERT_TRUE(parallel_mesh.get_vertices()[i] == serial_mesh.get_vertices()[i]);
+	}
+
+	ASSERT_TRUE(parallel_mesh.get_indices() == serial_mesh.get_indices());
+	ASSERT_TRUE(parallel_mesh.get_vector2f_attributes().at(0).get_indices() == serial_mesh.get_vector2f_attributes().at(0).get_indices());
+	ASSERT_TRUE(parallel_mesh.get_vector3f_attributes().at(0).get_indices() == serial_mesh.get_vector3f_attributes().at(0).get_indices());
+	ASSERT_EQ(parallel_mesh.get_vector2f_attributes().at(0).get_data().size(), serial_mesh.get_vector2f_attributes().at(0).get_data().size());
+	ASSERT_EQ(parallel_mesh.get_vector3f_attributes().at(0).get_data().size(), serial_mesh.get_vector3f_attributes().at(0).get_data().size());
+
+	ASSERT_EQ(parallel_mesh.get_submeshes().size(), serial_mesh.get_submeshes().size());
+	for (size_t i{0}; i < serial_mesh.get_submeshes().size(); ++i)
+	{
+		submesh const& parallel_submesh = parallel_mesh.get_submeshes()[i];
+		submesh const& serial_submesh = serial_mesh.get_submeshes()[i];
+
+		ASSERT_EQ(parallel_submesh.name, serial_submesh.name);
+		ASSERT_EQ(parallel_submesh.material_name, serial_submesh.material_name);
+		ASSERT_EQ(parallel_submesh.index_offset, serial_submesh.index_offset);
+		ASSERT_EQ(parallel_submesh.index_count, serial_submesh.index_count);
+		ASSERT_TRUE(parallel_submesh.bounding_box.from == serial_submesh.bounding_box.from);
+		ASSERT_TRUE(parallel_submesh.bounding_box.to == serial_submesh.bounding_box.to);
+	}
+}
+
+TEST(obj_import, mesh_is_moved_out_of_importer)
+{
+	std::string const path{"resources/unit_cube_pos_texcoord_normal.obj"};
+
+	obj_mesh_importer importer{true, true};
+	importer.read(path);
+
+	// Copying mesh allocates every array again, taking it allocates only attributes and submeshes lists
+	//
+
+	unsigned long long allocations_before{get_allocations_count()};
+	mesh const copied_mesh{importer.get_mesh()};
+	ASSERT_GE(get_allocations_count() - allocations_before, 8);
+
+	allocations_before = get_allocations_count();
+	mesh const taken_mesh{importer.take_mesh()};
+	ASSERT_EQ(get_allocations_count() - allocations_before, 3);
+
+	assert_obj_vertices(taken_mesh);
+	assert_obj_texcoords(taken_mesh);
+	assert_obj_normals(taken_mesh);
+
+	// Loading costs exactly as much as reading plus taking the mesh
+	//
+
+	allocations_before = get_allocations_count();
+	{
+		obj_mesh_importer reading_importer{true, true};
+		reading_importer.read(path);
+	}
+	unsigned long long const reading_allocations_count{get_allocations_count() - allocations_before};
+
+	allocations_before = get_allocations_count();
+	mesh const loaded_mesh{load_mesh_from_obj(path, true, true)};
+	ASSERT_EQ(get_allocations_count() - allocations_before, reading_allocations_count + 3);
+}
+
+TEST(obj_import, objects_and_materials)
+{
+	std::string const obj_path{"objects_and_materials_test.obj"};
+	std::string const mtl_path{"objects_and_materials_test.mtl"};
+
+	{
+		std::ofstream file{mtl_path};
+		file <<
+			"newmtl red\n"
+			"Kd 1 0 0\n"
+			"newmtl textured\n"
+			"map_Kd -s 1 1 1 textures/bricks.png\n";
+	}
+
+	{
+		std::ofstream file{obj_path};
+		file <<
+			"mtllib " << mtl_path << "\n"
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+			"v 5 5 5\nv 6 5 5\nv 6 7 5\n"
+			"f 1 2 3\n"
+			"o box  \n"
+			"usemtl red\n"
+			"f 1 2 3 4\n"
+			"usemtl textured\n"
+			"g body # comment\n"
+			"f 5 6 7\n"
+			"usemtl red\n";
+	}
+
+	std::vector<obj_material> materials;
+	mesh const m{load_mesh_from_obj(obj_path, false, false, materials)};
+
+	// Faces before any definitions form a submesh without names, submesh without faces is dropped
+	//
+	std::vector<submesh> const& submeshes = m.get_submeshes();
+	ASSERT_EQ(submeshes.size(), 3);
+
+	ASSERT_EQ(submeshes[0].name, "");
+	ASSERT_EQ(submeshes[0].material_name, "");
+	ASSERT_EQ(submeshes[0].index_offset, 0);
+	ASSERT_EQ(submeshes[0].index_count, 3);
+
+	ASSERT_EQ(submeshes[1].name, "box");
+	ASSERT_EQ(submeshes[1].material_name, "red");
+	ASSERT_EQ(submeshes[1].index_offset, 3);
+	ASSERT_EQ(submeshes[1].index_count, 6);
+	assert_vectors3_near(submeshes[1].bounding_box.from, vector3f{0.0f, 0.0f, 0.0f});
+	assert_vectors3_near(submeshes[1].bounding_box.to, vector3f{1.0f, 1.0f, 0.0f});
+
+	ASSERT_EQ(submeshes[2].name, "body");
+	ASSERT_EQ(submeshes[2].material_name, "textured");
+	ASSERT_EQ(submeshes[2].index_offset, 9);
+	ASSERT_EQ(submeshes[2].index_count, 3);
+	assert_vectors3_near(submeshes[2].bounding_box.from, vector3f{5.0f, 5.0f, 5.0f});
+	assert_vectors3_near(submeshes[2].bounding_box.to, vector3f{6.0f, 7.0f, 5.0f});
+
+	ASSERT_EQ(materials.size(), 2);
+	ASSERT_EQ(materials[0].name, "red");
+	ASSERT_TRUE(materials[0].diffuse_color == (color{1.0f, 0.0f, 0.0f, 1.0f}));
+	ASSERT_TRUE(materials[0].diffuse_texture_path.empty());
+	ASSERT_EQ(materials[1].name, "textured");
+	ASSERT_TRUE(materials[1].diffuse_color == (color{1.0f, 1.0f, 1.0f, 1.0f}));
+	ASSERT_EQ(materials[1].diffuse_texture_path, "textures/bricks.png");
+
+	std::remove(obj_path.c_str());
+	std::remove(mtl_path.c_str());
+}
@@ -1,6 +1,8 @@
-#include <assert_utils.h>
+#include <cmath>
 #include "assert_utils.h"
-#include "pipeline.h"
+#include "allocation_counter.h"
+#include "renderer.h"
+#include "color_shader.h"
 
 using namespace lantern;
 
@@ -8,37 +10,42 @@ class test_shader final
 {
 public:
 	test_shader(color const& c, texture const* target_texture)
-		: m_color(c), m_target_texture{target_texture}
+		: m_color(c), m_target_texture{target_texture}, m_invocations_count{0}, m_vertex_invocations_count{0}, m_vertex_state_version{get_next_state_version()}
 	{
 
 	}
 
-	std::vector<shader_bind_point_info<color>> get_color_bind_points()
+	static shader_bind_points<test_shader, color> get_color_bind_points()
 	{
-		return std::vector<shader_bind_point_info<color>>{};
+		return shader_bind_points<test_shader, color>{};
 	}
 
-	std::vector<shader_bind_point_info<float>> get_float_bind_points()
+	static shader_bind_points<test_shader, float> get_float_bind_points()
 	{
-		return std::vector<shader_bind_point_info<float>>{};
+		return shader_bind_points<test_shader, float>{};
 	}
-	std::vector<shader_bind_point_info<vector2f>> get_vector2f_bind_points()
+
+	static shader_bind_points<test_shader, vector2f> get_vector2f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector2f>>{};
+		return shader_bind_points<test_shader, vector2f>{};
 	}
 
-	std::vector<shader_bind_point_info<vector3f>> get_vector3f_bind_points()
+	static shader_bind_points<test_shader, vector3f> get_vector3f_bind_points()
 	{
-		return std::vector<shader_bind_point_info<vector3f>>{};
+		return shader_bind_points<test_shader, vector3f>{};
 	}
 
 	vector4f process_vertex(vector4f const& vertex)
 	{
+		++m_vertex_invocations_count;
+
 		return vertex;
 	}
 
 	color process_pixel(vector2ui const& pixel)
 	{
+		++m_invocations_count;
+
 		color const current_color = m_target_texture->get_pixel_color(pixel);
 
 		if (current_color != color::BLACK)
@@ -51,12 +58,35 @@ public:
 		}
 	}
 
+	unsigned int get_invocations_count() const
+	{
+		return m_invocations_count;
+	}
+
+	unsigned int get_vertex_invocations_count() const
+	{
+		return m_vertex_invocations_count;
+	}
+
+	uint64_t get_vertex_state_version() const
+	{
+		return m_vertex_state_version;
+	}
+
+	void change_vertex_state()
+	{
+		m_vertex_state_version = get_next_state_version();
+	}
+
 private:
 	color const m_color;
 	texture const* m_target_texture;
+	unsigned int m_invocations_count;
+	unsigned int m_vertex_invocations_count;
+	uint64_t m_vertex_state_version;
 };
 
-static void assert_pixel_centers_are_lit_no_ambiguities(pipeline& p)
+static void assert_pixel_centers_are_lit_no_ambiguities(renderer& r)
 {
 	// Rasterizes triangle that doesn't have any pixel centers on edge
 	// Picture: rasterization_no_ambiguities_test_case.png
@@ -70,7 +100,7 @@ static void assert_pixel_centers_are_lit_no_ambiguities(pipeline& p)
 	std::vector<unsigned int> const triangle_indices{0, 1, 2};
 	mesh triangle_mesh{triangle_vertices, triangle_indices};
 	texture.clear(0);
-	p.draw(triangle_mesh, shader_white, texture);
+	r.render_mesh(triangle_mesh, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -81,7 +111,7 @@ static void assert_pixel_centers_are_lit_no_ambiguities(pipeline& p)
 		color::BLACK);
 }
 
-static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
+static void assert_pixel_centers_are_lit_top_left_rule(renderer& r)
 {
 	// Rasterizes triangle with pixel centers at the edges to check top-left filling rule
 	//
@@ -97,7 +127,7 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		vector3f{-0.8f, 0.8f, 0.0f}, vector3f{-0.8f, -0.8f, 0.0f}, vector3f{0.8f, 0.8f, 0.0f}};
 	mesh triangle_mesh_1{triangle_vertices, triangle_indices};
 	texture.clear(0);
-	p.draw(triangle_mesh_1, shader_white, texture);
+	r.render_mesh(triangle_mesh_1, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -114,7 +144,7 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		vector3f{0.8f, 0.8f, 0.0f}, vector3f{-0.8f, 0.8f, 0.0f}, vector3f{0.8f, -0.8f, 0.0f}};
 	mesh triangle_mesh_2{triangle_vertices, triangle_indices};
 	texture.clear(0);
-	p.draw(triangle_mesh_2, shader_white, texture);
+	r.render_mesh(triangle_mesh_2, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -131,7 +161,7 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		vector3f{0.8f, 0.8f, 0.0f}, vector3f{-0.8f, -0.8f, 0.0f}, vector3f{0.8f, -0.8f, 0.0f}};
 	mesh triangle_mesh_3{triangle_vertices, triangle_indices};
 	texture.clear(0);
-	p.draw(triangle_mesh_3, shader_white, texture);
+	r.render_mesh(triangle_mesh_3, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -147,7 +177,7 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		vector3f{-0.8f, 0.8f, 0.0f}, vector3f{-0.8f, -0.8f, 0.0f}, vector3f{0.8f, -0.8f, 0.0f}};
 	mesh triangle_mesh_4{triangle_vertices, triangle_indices};
 	texture.clear(0);
-	p.draw(triangle_mesh_4, shader_white, texture);
+	r.render_mesh(triangle_mesh_4, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -168,7 +198,7 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		3, 0, 4};
 	mesh rect_mesh{rect_vertices, rect_indices};
 	texture.clear(0);
-	p.draw(rect_mesh, shader_white, texture);
+	r.render_mesh(rect_mesh, shader_white, texture);
 	assert_pixels_two_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -185,8 +215,8 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 	test_shader shader_blue{color::BLUE, &texture};
 
 	texture.clear(0);
-	p.draw(triangle_mesh_4, shader_white, texture);
-	p.draw(triangle_mesh_2, shader_blue, texture);
+	r.render_mesh(triangle_mesh_4, shader_white, texture);
+	r.render_mesh(triangle_mesh_2, shader_blue, texture);
 	assert_pixels_colors(
 		texture,
 		std::vector<vector2ui>{
@@ -204,62 +234,802 @@ static void assert_pixel_centers_are_lit_top_left_rule(pipeline& p)
 		color::WHITE);
 }
 
-TEST(pipeline, mesh_rasterization_traversal_aabb)
+static void assert_occluded_pixels_are_not_shaded(renderer& r)
 {
-	pipeline p;
+	// Draws two squares covering the whole texture at different depths
+	//
+
+	texture texture{5, 5};
+	depth_buffer depth{5, 5};
+
+	std::vector<unsigned int> const rect_indices{
+		0, 1, 4,
+		1, 2, 4,
+		2, 3, 4,
+		3, 0, 4};
+
+	std::vector<vector3f> const near_rect_vertices{
+		vector3f{0.8f, 0.8f, -0.5f}, vector3f{-0.8f, 0.8f, -0.5f}, vector3f{-0.8f, -0.8f, -0.5f}, vector3f{0.8f, -0.8f, -0.5f}, vector3f{0.0f, 0.0f, -0.5f}};
+	mesh near_rect_mesh{near_rect_vertices, rect_indices};
+
+	std::vector<vector3f> const far_rect_vertices{
+		vector3f{0.8f, 0.8f, 0.5f}, vector3f{-0.8f, 0.8f, 0.5f}, vector3f{-0.8f, -0.8f, 0.5f}, vector3f{0.8f, -0.8f, 0.5f}, vector3f{0.0f, 0.0f, 0.5f}};
+	mesh far_rect_mesh{far_rect_vertices, rect_indices};
+
+	std::vector<vector2ui> const rect_pixels{
+		vector2ui{0, 0}, vector2ui{0, 1}, vector2ui{0, 2}, vector2ui{0, 3},
+		vector2ui{1, 0}, vector2ui{1, 1}, vector2ui{1, 2}, vector2ui{1, 3},
+		vector2ui{2, 0}, vector2ui{2, 1}, vector2ui{2, 2}, vector2ui{2, 3},
+		vector2ui{3, 0}, vector2ui{3, 1}, vector2ui{3, 2}, vector2ui{3, 3}};
+
+	// Far square drawn after the near one must be rejected before shading
+	//
+
+	test_shader shader_blue{color::BLUE, &texture};
+	test_shader shader_white{color::WHITE, &texture};
+
+	texture.clear(0);
+	depth.clear(depth_buffer::FAR_DEPTH);
+	r.render_mesh(near_rect_mesh, shader_blue, texture, depth);
+	r.render_mesh(far_rect_mesh, shader_white, texture, depth);
+	assert_pixels_two_colors(texture, rect_pixels, color::BLUE, color::BLACK);
+	ASSERT_EQ(shader_white.get_invocations_count(), 0);
+	assert_floats_near(depth.get_depth(vector2ui{2, 2}), -0.5f);
+
+	// Depth test works with depth buffer that was set explicitly, and with disabled depth write
+	// near square doesn't hide the square drawn after it (test shader outputs red when it shades already lit pixel)
+	//
 
-	p.set_face_culling(face_culling_option::counter_clockwise);
-	p.set_fill_mode(fill_mode_option::solid);
+	texture.clear(0);
+	depth.clear(depth_buffer::FAR_DEPTH);
+	r.get_merging_stage().set_depth_buffer(&depth);
+	r.get_merging_stage().set_depth_write_enabled(false);
+	r.render_mesh(near_rect_mesh, shader_white, texture);
+	r.get_merging_stage().set_depth_write_enabled(true);
+	r.render_mesh(far_rect_mesh, shader_blue, texture);
+	r.get_merging_stage().set_depth_buffer(nullptr);
+	assert_pixels_two_colors(texture, rect_pixels, color::RED, color::BLACK);
+	assert_floats_near(depth.get_depth(vector2ui{2, 2}), 0.5f);
+
+	// Inverted comparison function keeps the farthest square
+	//
 
-	p.set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
-	assert_pixel_centers_are_lit_no_ambiguities(p);
-	assert_pixel_centers_are_lit_top_left_rule(p);
+	test_shader shader_green{color::GREEN, &texture};
+
+	texture.clear(0);
+	depth.clear(-depth_buffer::FAR_DEPTH);
+	r.get_merging_stage().set_depth_test_function(depth_test_function_option::greater);
+	r.render_mesh(far_rect_mesh, shader_green, texture, depth);
+	r.render_mesh(near_rect_mesh, shader_white, texture, depth);
+	r.get_merging_stage().set_depth_test_function(depth_test_function_option::less);
+	assert_pixels_two_colors(texture, rect_pixels, color::GREEN, color::BLACK);
 }
 
-TEST(pipeline, mesh_rasterization_traversal_backtracking)
+static void assert_shared_edges_are_watertight(renderer& r)
 {
-	pipeline p;
+	// Rasterizes a grid of triangles with jittered inner vertices.
+	// Every pixel center inside the grid must be lit exactly once (test shader outputs red when it shades already lit pixel)
+	//
+
+	texture texture{64, 64};
+	test_shader shader_white{color::WHITE, &texture};
+
+	unsigned int const cells_count{8};
+
+	std::vector<vector3f> vertices;
+	for (unsigned int j{0}; j <= cells_count; ++j)
+	{
+		for (unsigned int i{0}; i <= cells_count; ++i)
+		{
+			float x{-0.9f + 1.8f * i / cells_count};
+			float y{-0.9f + 1.8f * j / cells_count};
+
+			if ((i != 0) && (j != 0) && (i != cells_count) && (j != cells_count))
+			{
+				x += 0.08f * std::sin(i * 12.9898f + j * 78.233f);
+				y += 0.08f * std::cos(i * 39.3468f + j * 11.135f);
+			}
+
+			vertices.push_back(vector3f{x, y, 0.0f});
+		}
+	}
+
+	std::vector<unsigned int> indices;
+	for (unsigned int j{0}; j < cells_count; ++j)
+	{
+		for (unsigned int i{0}; i < cells_count; ++i)
+		{
+			unsigned int const i00{j * (cells_count + 1) + i};
+			unsigned int const i10{i00 + 1};
+			unsigned int const i01{i00 + cells_count + 1};
+			unsigned int const i11{i01 + 1};
 
-	p.set_face_culling(face_culling_option::counter_clockwise);
-	p.set_fill_mode(fill_mode_option::solid);
+			indices.insert(indices.end(), {i00, i10, i11, i00, i11, i01});
+		}
+	}
 
-	p.set_rasterization_algorithm(rasterization_algorithm_option::traversal_backtracking);
-	assert_pixel_centers_are_lit_no_ambiguities(p);
-	assert_pixel_centers_are_lit_top_left_rule(p);
+	mesh grid_mesh{vertices, indices};
+	texture.clear(0);
+	r.render_mesh(grid_mesh, shader_white, texture);
+
+	// Grid border goes through pixels 3.2 and 60.8
+	//
+	for (unsigned int y{0}; y < texture.get_height(); ++y)
+	{
+		for (unsigned int x{0}; x < texture.get_width(); ++x)
+		{
+			bool const inside{(x >= 3) && (x <= 60) && (y >= 3) && (y <= 60)};
+			assert_pixel_color(texture, vector2ui{x, y}, inside ? color::WHITE : color::BLACK);
+		}
+	}
+}
+
+static void assert_triangles_are_clipped(renderer& r)
+{
+	// Triangle crossing the near plane: only the part in front of it is rasterized.
+	// Intersection with the near plane goes through y = -0.2667 in NDC, which is 12.67 in screen space
+	//
+
+	texture texture{20, 20};
+	test_shader shader_white{color::WHITE, &texture};
+
+	std::vector<vector3f> const near_crossing_vertices{
+		vector3f{-0.8f, -0.8f, 0.0f}, vector3f{0.8f, -0.8f, 0.0f}, vector3f{0.0f, 0.8f, -3.0f}};
+	std::vector<unsigned int> const triangle_indices{0, 1, 2};
+	mesh near_crossing_mesh{near_crossing_vertices, triangle_indices};
+
+	texture.clear(0);
+	r.render_mesh(near_crossing_mesh, shader_white, texture);
+	assert_pixel_color(texture, vector2ui{10, 16}, color::WHITE);
+	assert_pixel_color(texture, vector2ui{10, 13}, color::WHITE);
+	assert_pixel_color(texture, vector2ui{10, 12}, color::BLACK);
+	assert_pixel_color(texture, vector2ui{10, 5}, color::BLACK);
+
+	// Square much larger than the screen covers every pixel exactly once
+	// (test shader outputs red when it shades already lit pixel), with correctly interpolated attributes
+	//
+
+	std::vector<vector3f> const large_rect_vertices{
+		vector3f{3.0f, 3.0f, 0.0f}, vector3f{-3.0f, 3.0f, 0.0f}, vector3f{-3.0f, -3.0f, 0.0f}, vector3f{3.0f, -3.0f, 0.0f}};
+	std::vector<unsigned int> const large_rect_indices{0, 1, 2, 0, 2, 3};
+	mesh large_rect_mesh{large_rect_vertices, large_rect_indices};
+
+	texture.clear(0);
+	r.render_mesh(large_rect_mesh, shader_white, texture);
+	for (unsigned int y{0}; y < texture.get_height(); ++y)
+	{
+		for (unsigned int x{0}; x < texture.get_width(); ++x)
+		{
+			assert_pixel_color(texture, vector2ui{x, y}, color::WHITE);
+		}
+	}
+
+	// Red channel goes from 0 to 1 along x axis, clipped vertices get values in between
+	//
+	std::vector<color> const large_rect_colors{
+		color{1.0f, 0.0f, 0.0f, 1.0f}, color{0.0f, 0.0f, 0.0f, 1.0f}, color{0.0f, 0.0f, 0.0f, 1.0f}, color{1.0f, 0.0f, 0.0f, 1.0f}};
+	large_rect_mesh.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, large_rect_colors, std::vector<unsigned int>{0, 1, 2, 3}, attribute_interpolation_option::linear});
+
+	color_shader shader_gradient;
+	shader_gradient.set_mvp_matrix(matrix4x4f::IDENTITY);
+
+	texture.clear(0);
+	r.render_mesh(large_rect_mesh, shader_gradient, texture);
+	for (unsigned int x{0}; x < texture.get_width(); ++x)
+	{
+		float const ndc_x{(x + 0.5f) / texture.get_width() * 2.0f - 1.0f};
+		ASSERT_NEAR(texture.get_pixel_color(vector2ui{x, 7}).r, (ndc_x + 3.0f) / 6.0f, 0.01f);
+	}
+}
+
+static void assert_tiled_rendering_matches_serial(rasterization_algorithm_option const algorithm)
+{
+	// Renders a bunch of overlapping triangles with interpolated colors and depth test
+	// in serial and tiled modes, tiles are small so that most of triangles cross several of them
+	//
+
+	unsigned int const triangles_count{200};
+
+	std::vector<vector3f> vertices;
+	std::vector<unsigned int> indices;
+	std::vector<color> colors;
+
+	unsigned int random_state{12345};
+	auto next_random = [&random_state]()
+	{
+		random_state = random_state * 1103515245 + 12345;
+		return static_cast<float>((random_state >> 8) & 0xFFFF) / 65535.0f;
+	};
+
+	for (unsigned int i{0}; i < triangles_count * 3; ++i)
+	{
+		vertices.push_back(vector3f{next_random() * 1.8f - 0.9f, next_random() * 1.8f - 0.9f, next_random() * 1.8f - 0.9f});
+		colors.push_back(color{next_random(), next_random(), next_random(), 1.0f});
+		indices.push_back(i);
+	}
+
+	mesh triangles_mesh{vertices, indices};
+	triangles_mesh.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, indices, attribute_interpolation_option::linear});
+
+	color_shader shader;
+	shader.set_mvp_matrix(matrix4x4f::IDENTITY);
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(algorithm);
+
+	texture serial_texture{101, 77};
+	depth_buffer serial_depth{101, 77};
+	serial_texture.clear(0);
+	r.render_mesh(triangles_mesh, shader, serial_texture, serial_depth);
+
+	texture tiled_texture{101, 77};
+	depth_buffer tiled_depth{101, 77};
+	tiled_texture.clear(0);
+	r.set_rendering_mode(rendering_mode_option::tiled);
+	r.set_tile_size(16);
+	r.set_threads_count(4);
+	r.render_mesh(triangles_mesh, shader, tiled_texture, tiled_depth);
+
+	for (unsigned int y{0}; y < serial_texture.get_height(); ++y)
+	{
+		for (unsigned int x{0}; x < serial_texture.get_width(); ++x)
+		{
+			vector2ui const pixel{x, y};
+			ASSERT_TRUE(serial_texture.get_pixel_color(pixel) == tiled_texture.get_pixel_color(pixel));
+			ASSERT_EQ(serial_depth.get_depth(pixel), tiled_depth.get_depth(pixel));
+		}
+	}
+}
+
+TEST(pipeline, mesh_rasterization_traversal_aabb)
+{
+	renderer r;
+
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+}
+
+TEST(pipeline, mesh_rasterization_traversal_backtracking)
+{
+	renderer r;
+
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_backtracking);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
 }
 
 TEST(pipeline, mesh_rasterization_traversal_zigzag)
 {
-	pipeline p;
+	renderer r;
 
-	p.set_face_culling(face_culling_option::counter_clockwise);
-	p.set_fill_mode(fill_mode_option::solid);
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_zigzag);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+}
+
+TEST(pipeline, mesh_rasterization_traversal_aabb_fixed_point)
+{
+	renderer r;
 
-	p.set_rasterization_algorithm(rasterization_algorithm_option::traversal_zigzag);
-	assert_pixel_centers_are_lit_no_ambiguities(p);
-	assert_pixel_centers_are_lit_top_left_rule(p);
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb_fixed_point);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+	assert_shared_edges_are_watertight(r);
 }
 
-TEST(pipeline, mesh_rasterization_inversed_slope)
+TEST(pipeline, mesh_rasterization_traversal_aabb_simd)
 {
-	pipeline p;
+	renderer r;
 
-	p.set_face_culling(face_culling_option::counter_clockwise);
-	p.set_fill_mode(fill_mode_option::solid);
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb_simd);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+}
+
+TEST(pipeline, mesh_rasterization_traversal_hierarchical)
+{
+	renderer r;
 
-	p.set_rasterization_algorithm(rasterization_algorithm_option::inversed_slope);
-	assert_pixel_centers_are_lit_no_ambiguities(p);
-	assert_pixel_centers_are_lit_top_left_rule(p);
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_hierarchical);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+	assert_shared_edges_are_watertight(r);
+}
+
+TEST(pipeline, mesh_rasterization_inversed_slope)
+{
+	renderer r;
+
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::inversed_slope);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
 }
 
 TEST(pipeline, mesh_rasterization_homogeneous)
 {
-	pipeline p;
+	renderer r;
+
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::homogeneous);
+	assert_pixel_centers_are_lit_no_ambiguities(r);
+	assert_pixel_centers_are_lit_top_left_rule(r);
+	assert_occluded_pixels_are_not_shaded(r);
+	assert_triangles_are_clipped(r);
+}
+
+TEST(pipeline, tiled_rendering_matches_serial)
+{
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_aabb);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_backtracking);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_zigzag);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_aabb_fixed_point);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_aabb_simd);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::traversal_hierarchical);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::inversed_slope);
+	assert_tiled_rendering_matches_serial(rasterization_algorithm_option::homogeneous);
+}
+
+TEST(pipeline, face_culling)
+{
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::homogeneous);
+
+	texture texture{5, 5};
+	test_shader shader_white{color::WHITE, &texture};
+
+	// Counterclockwise triangle at the left, clockwise one at the right, degenerate one and a tiny one between pixel centers
+	//
+	std::vector<vector3f> const vertices{
+		vector3f{-0.9f, -0.9f, 0.0f}, vector3f{-0.1f, -0.9f, 0.0f}, vector3f{-0.9f, 0.9f, 0.0f},
+		vector3f{0.1f, -0.9f, 0.0f}, vector3f{0.9f, 0.9f, 0.0f}, vector3f{0.9f, -0.9f, 0.0f},
+		vector3f{-0.5f, 0.5f, 0.0f}, vector3f{0.0f, 0.5f, 0.0f}, vector3f{0.5f, 0.5f, 0.0f},
+		vector3f{0.01f, 0.01f, 0.0f}, vector3f{0.15f, 0.01f, 0.0f}, vector3f{0.01f, 0.15f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	mesh triangles_mesh{vertices, indices};
+
+	// Nothing is culled by facing by default
+	//
+	texture.clear(0);
+	r.render_mesh(triangles_mesh, shader_white, texture);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().culled_by_facing_triangles_count, 0);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().culled_degenerate_triangles_count, 1);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().culled_without_pixel_centers_triangles_count, 1);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().passed_triangles_count, 2);
+
+	// Back faces culling with default counterclockwise front faces keeps the left triangle only
+	//
+	r.get_geometry_stage().reset_counters();
+	r.get_geometry_stage().set_face_culling(face_culling_option::back);
+	texture.clear(0);
+	r.render_mesh(triangles_mesh, shader_white, texture);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().culled_by_facing_triangles_count, 1);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().passed_triangles_count, 1);
+	assert_pixel_color(texture, vector2ui{0, 3}, color::WHITE);
+	assert_pixel_color(texture, vector2ui{4, 3}, color::BLACK);
+
+	// Front faces culling with clockwise front faces keeps the left triangle too
+	//
+	r.get_geometry_stage().reset_counters();
+	r.get_geometry_stage().set_face_culling(face_culling_option::front);
+	r.get_geometry_stage().set_front_face_winding_order(winding_order_option::clockwise);
+	texture.clear(0);
+	r.render_mesh(triangles_mesh, shader_white, texture);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().culled_by_facing_triangles_count, 1);
+	ASSERT_EQ(r.get_geometry_stage().get_counters().passed_triangles_count, 1);
+	assert_pixel_color(texture, vector2ui{0, 3}, color::WHITE);
+	assert_pixel_color(texture, vector2ui{4, 3}, color::BLACK);
+}
+TEST(pipeline, triangles_are_classified_by_outcodes)
+{
+	// Triangle inside the frustum, triangle to the right of it, triangle crossing its left plane,
+	// and triangle having every vertex outside of some plane, but not of the same one
+	//
+	std::vector<vector3f> const vertices{
+		vector3f{-0.5f, -0.5f, 0.0f}, vector3f{0.5f, -0.5f, 0.0f}, vector3f{0.0f, 0.5f, 0.0f},
+		vector3f{1.5f, -0.5f, 0.0f}, vector3f{2.5f, -0.5f, 0.0f}, vector3f{2.0f, 0.5f, 0.0f},
+		vector3f{-1.5f, -0.5f, 0.0f}, vector3f{0.5f, -0.5f, 0.0f}, vector3f{0.0f, 0.5f, 0.0f},
+		vector3f{-3.0f, -0.5f, 0.0f}, vector3f{3.0f, -0.5f, 0.0f}, vector3f{0.0f, 3.0f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+	mesh triangles_mesh{vertices, indices};
+
+	renderer r;
+	texture target_texture{8, 8};
+	test_shader shader{color::WHITE, &target_texture};
+
+	target_texture.clear(0);
+	r.render_mesh(triangles_mesh, shader, target_texture);
+
+	geometry_stage_counters const& counters = r.get_geometry_stage().get_counters();
+	ASSERT_EQ(counters.trivially_accepted_triangles_count, 1);
+	ASSERT_EQ(counters.trivially_rejected_triangles_count, 1);
+	ASSERT_EQ(counters.clipped_triangles_count, 2);
+
+	r.get_geometry_stage().reset_counters();
+	ASSERT_EQ(counters.trivially_accepted_triangles_count, 0);
+	ASSERT_EQ(counters.trivially_rejected_triangles_count, 0);
+	ASSERT_EQ(counters.clipped_triangles_count, 0);
+}
+
+TEST(pipeline, compile_time_algorithm_matches_runtime)
+{
+	std::vector<vector3f> const vertices{
+		vector3f{-0.9f, -0.8f, 0.0f}, vector3f{0.7f, -0.6f, 0.0f}, vector3f{-0.2f, 0.9f, 0.0f},
+		vector3f{-0.5f, 0.1f, 0.0f}, vector3f{0.9f, 0.2f, 0.0f}, vector3f{0.3f, 0.8f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 3, 4, 5};
+	std::vector<color> const colors{
+		color{1.0f, 0.0f, 0.0f, 1.0f}, color{0.0f, 1.0f, 0.0f, 0.5f}, color{0.0f, 0.0f, 1.0f, 1.0f},
+		color{1.0f, 1.0f, 0.0f, 0.5f}, color{0.0f, 1.0f, 1.0f, 0.5f}, color{1.0f, 0.0f, 1.0f, 0.5f}};
+
+	mesh triangles_mesh{vertices, indices};
+	triangles_mesh.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, indices, attribute_interpolation_option::linear});
+
+	color_shader shader;
+	shader.set_mvp_matrix(matrix4x4f::IDENTITY);
+
+	for (bool const alpha_blending_enabled : {false, true})
+	{
+		renderer runtime_renderer;
+		runtime_renderer.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb_fixed_point);
+		runtime_renderer.get_merging_stage().set_alpha_blending_enabled(alpha_blending_enabled);
+
+		texture runtime_texture{37, 29};
+		runtime_texture.clear(0);
+		runtime_renderer.render_mesh(triangles_mesh, shader, runtime_texture);
+
+		// Runtime algorithm setting is left as default and must be ignored
+		//
+		renderer compile_time_renderer;
+		compile_time_renderer.get_merging_stage().set_alpha_blending_enabled(alpha_blending_enabled);
+
+		texture compile_time_texture{37, 29};
+		compile_time_texture.clear(0);
+		compile_time_renderer.render_mesh<rasterization_algorithm_option::traversal_aabb_fixed_point>(triangles_mesh, shader, compile_time_texture);
+
+		for (unsigned int y{0}; y < runtime_texture.get_height(); ++y)
+		{
+			for (unsigned int x{0}; x < runtime_texture.get_width(); ++x)
+			{
+				vector2ui const pixel{x, y};
+				ASSERT_TRUE(runtime_texture.get_pixel_color(pixel) == compile_time_texture.get_pixel_color(pixel));
+			}
+		}
+	}
+}
+
+TEST(pipeline, repeated_draws_reuse_attributes_binding)
+{
+	std::vector<vector3f> const vertices{vector3f{-0.9f, -0.9f, 0.0f}, vector3f{0.9f, -0.9f, 0.0f}, vector3f{0.0f, 0.9f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2};
+	std::vector<color> const colors{color::RED, color::GREEN, color::BLUE};
 
-	p.set_face_culling(face_culling_option::counter_clockwise);
-	p.set_fill_mode(fill_mode_option::solid);
+	mesh triangle_mesh{vertices, indices};
+	triangle_mesh.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, indices, attribute_interpolation_option::linear});
+
+	color_shader shader;
+	shader.set_mvp_matrix(matrix4x4f::IDENTITY);
+
+	renderer r;
+	r.get_rasterizing_stage().set_rasterization_algorithm(rasterization_algorithm_option::traversal_aabb);
+
+	texture target_texture{16, 16};
+	r.render_mesh(triangle_mesh, shader, target_texture);
+
+	// Neither shader bind points nor binding are created again
+	//
+	unsigned long long const allocations_before{get_allocations_count()};
+	for (unsigned int i{0}; i < 10; ++i)
+	{
+		r.render_mesh(triangle_mesh, shader, target_texture);
+	}
+	ASSERT_EQ(get_allocations_count(), allocations_before);
+
+	// Another shader instance gets its own binding
+	//
+	color_shader another_shader{shader};
+	target_texture.clear(0);
+	r.render_mesh(triangle_mesh, another_shader, target_texture);
+	ASSERT_TRUE(target_texture.get_pixel_color(vector2ui{8, 8}) != color::BLACK);
+
+	// Mesh without required attribute can't be rendered even if it's placed at the same address
+	//
+	triangle_mesh.get_color_attributes().clear();
+	ASSERT_THROW(r.render_mesh(triangle_mesh, shader, target_texture), std::runtime_error);
+}
+
+TEST(pipeline, referenced_vertices_are_processed_once)
+{
+	// Two triangles share an edge, the last vertex is not referenced at all
+	//
+	std::vector<vector3f> const vertices{
+		vector3f{-0.9f, -0.9f, 0.0f}, vector3f{0.9f, -0.9f, 0.0f}, vector3f{-0.9f, 0.9f, 0.0f},
+		vector3f{0.9f, 0.9f, 0.0f}, vector3f{0.0f, 0.0f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 2, 1, 3};
+	mesh quad_mesh{vertices, indices};
+
+	renderer r;
+	texture target_texture{8, 8};
+	test_shader shader{color::WHITE, &target_texture};
+
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 4);
+
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 8);
+}
+
+TEST(pipeline, transformed_vertices_are_cached)
+{
+	std::vector<vector3f> const vertices{
+		vector3f{-0.9f, -0.9f, 0.0f}, vector3f{0.9f, -0.9f, 0.0f}, vector3f{-0.9f, 0.9f, 0.0f}, vector3f{0.9f, 0.9f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 2, 1, 3};
+	mesh quad_mesh{vertices, indices};
+	mesh another_quad_mesh{vertices, indices};
+	mesh third_quad_mesh{vertices, indices};
+
+	renderer r;
+	texture target_texture{8, 8};
+	texture bigger_target_texture{16, 16};
+	test_shader shader{color::WHITE, &target_texture};
+
+	// Cache is disabled by default
+	//
+	ASSERT_EQ(r.get_geometry_stage().get_transformed_vertices_cache_size(), 0);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 8);
+
+	// The same mesh with the same state is not processed again, but still rendered
+	//
+	r.get_geometry_stage().set_transformed_vertices_cache_size(2);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 12);
+
+	target_texture.clear(0);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 12);
+	ASSERT_TRUE(target_texture.get_pixel_color(vector2ui{4, 4}) == color::WHITE);
+
+	// Any part of the key changes
+	//
+	r.render_mesh(quad_mesh, shader, bigger_target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 16);
+
+	shader.change_vertex_state();
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 20);
+
+	quad_mesh.mark_changed();
+	r.render_mesh(quad_mesh, shader, target_texture);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 24);
+
+	// Two meshes fit into the cache, the third one evicts the least recently used of them
+	//
+	r.render_mesh(another_quad_mesh, shader, target_texture);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	r.render_mesh(another_quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 28);
+
+	r.render_mesh(third_quad_mesh, shader, target_texture);
+	r.render_mesh(another_quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 32);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 36);
+
+	// Explicit invalidation
+	//
+	r.get_geometry_stage().invalidate_transformed_vertices_cache(quad_mesh);
+	r.render_mesh(another_quad_mesh, shader, target_texture);
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 40);
 
-	p.set_rasterization_algorithm(rasterization_algorithm_option::homogeneous);
-	assert_pixel_centers_are_lit_no_ambiguities(p);
-	assert_pixel_centers_are_lit_top_left_rule(p);
-}
\ No newline at end of file
+	r.get_geometry_stage().invalidate_transformed_vertices_cache();
+	r.render_mesh(quad_mesh, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 44);
+}
+
+TEST(pipeline, instanced_rendering_matches_separate_draws)
+{
+	std::vector<vector3f> const vertices{
+		vector3f{-0.5f, -0.5f, 0.0f}, vector3f{0.5f, -0.5f, 0.1f}, vector3f{-0.5f, 0.5f, 0.2f}, vector3f{0.5f, 0.5f, 0.3f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 2, 1, 3};
+	std::vector<color> const colors{
+		color{1.0f, 0.0f, 0.0f, 1.0f}, color{0.0f, 1.0f, 0.0f, 1.0f}, color{0.0f, 0.0f, 1.0f, 1.0f}, color{1.0f, 1.0f, 1.0f, 1.0f}};
+
+	mesh quad_mesh{vertices, indices};
+	quad_mesh.get_color_attributes().push_back(
+		mesh_attribute_info<color>{COLOR_ATTR_ID, colors, std::vector<unsigned int>{}, attribute_interpolation_option::linear});
+
+	// Overlapping instances, the first one is clipped, so that its clipped vertices must survive processing of the others
+	//
+	std::vector<matrix4x4f> const instances{
+		matrix4x4f::translation(0.8f, 0.1f, 0.0f),
+		matrix4x4f::uniform_scale(0.5f) * matrix4x4f::translation(-0.3f, -0.2f, 0.0f),
+		matrix4x4f::rotation_around_z_axis(0.5f) * matrix4x4f::translation(0.1f, 0.3f, -0.2f),
+		matrix4x4f::uniform_scale(0.7f) * matrix4x4f::translation(-0.5f, 0.4f, 0.1f)};
+
+	color_shader shader;
+
+	for (rendering_mode_option const mode : {rendering_mode_option::serial, rendering_mode_option::tiled})
+	{
+		renderer r;
+		r.set_rendering_mode(mode);
+		r.set_tile_size(8);
+		r.set_threads_count(3);
+
+		texture separate_texture{61, 47};
+		depth_buffer separate_depth{61, 47};
+		separate_texture.clear(0);
+		for (matrix4x4f const& instance : instances)
+		{
+			shader.set_mvp_matrix(instance);
+			r.render_mesh(quad_mesh, shader, separate_texture, separate_depth);
+		}
+
+		texture instanced_texture{61, 47};
+		depth_buffer instanced_depth{61, 47};
+		instanced_texture.clear(0);
+		r.get_geometry_stage().reset_counters();
+		r.render_mesh_instanced(quad_mesh, shader, instances, instanced_texture, instanced_depth);
+
+		ASSERT_EQ(r.get_geometry_stage().get_counters().clipped_triangles_count, 2);
+		ASSERT_FALSE(r.get_geometry_stage().get_clipped_vertices().empty());
+
+		for (unsigned int y{0}; y < separate_texture.get_height(); ++y)
+		{
+			for (unsigned int x{0}; x < separate_texture.get_width(); ++x)
+			{
+				vector2ui const pixel{x, y};
+				ASSERT_TRUE(separate_texture.get_pixel_color(pixel) == instanced_texture.get_pixel_color(pixel));
+			}
+		}
+	}
+}
+
+TEST(pipeline, submeshes_are_rendered_separately)
+{
+	// Left and right halves of the texture are separate submeshes, the right one references its own vertices
+	//
+	std::vector<vector3f> const vertices{
+		vector3f{-1.0f, -1.0f, 0.0f}, vector3f{0.0f, -1.0f, 0.0f}, vector3f{-1.0f, 1.0f, 0.0f}, vector3f{0.0f, 1.0f, 0.0f},
+		vector3f{0.0f, -1.0f, 0.0f}, vector3f{1.0f, -1.0f, 0.0f}, vector3f{0.0f, 1.0f, 0.0f}, vector3f{1.0f, 1.0f, 0.0f}};
+	std::vector<unsigned int> const indices{0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7};
+	mesh halves_mesh{vertices, indices};
+
+	submesh const left_half{"left", "", 0, 6, aabb<vector3f>{vector3f{-1.0f, -1.0f, 0.0f}, vector3f{0.0f, 1.0f, 0.0f}}};
+	submesh const right_half{"right", "", 6, 6, aabb<vector3f>{vector3f{0.0f, -1.0f, 0.0f}, vector3f{1.0f, 1.0f, 0.0f}}};
+
+	renderer r;
+	texture target_texture{8, 8};
+	test_shader shader{color::WHITE, &target_texture};
+
+	target_texture.clear(0);
+	r.render_mesh(halves_mesh, right_half, shader, target_texture);
+	ASSERT_EQ(shader.get_vertex_invocations_count(), 4);
+	ASSERT_TRUE(target_texture.get_pixel_color(vector2ui{1, 4}) == color::BLACK);
+	ASSERT_TRUE(target_texture.get_pixel_color(vector2ui{6, 4}) == color::WHITE);
+
+	r.render_mesh(halves_mesh, left_half, shader, target_texture);
+	ASSERT_TRUE(target_texture.get_pixel_color(vector2ui{1, 4}) == color::WHITE);
+
+	// Range going out of mesh indices is not rendered
+	//
+	submesh const broken{"broken", "", 6, 12, right_half.bounding_box};
+	ASSERT_THROW(r.render_mesh(halves_mesh, broken, shader, target_texture), std::out_of_range);
+
+	// Boxes are checked against the frustum
+	//
+	matrix4x4f const shift_right{matrix4x4f::translation(1.5f, 0.0f, 0.0f)};
+	ASSERT_FALSE(geometry_stage::is_box_outside_frustum(left_half.bounding_box, shift_right));
+	ASSERT_TRUE(geometry_stage::is_box_outside_frustum(right_half.bounding_box, shift_right));
+}
+
+/** Shader transforming vertices one by one, without batch method */
+class per_vertex_matrix_shader final
+{
+public:
+	per_vertex_matrix_shader(matrix4x4f const& mvp)
+		: m_mvp(mvp)
+	{
+
+	}
+
+	vector4f process_vertex(vector4f const& vertex)
+	{
+		return vertex * m_mvp;
+	}
+
+private:
+	matrix4x4f const m_mvp;
+};
+
+/** Collects triangles passed by geometry stage */
+class geometry_stage_results_collector final
+{
+public:
+	template<typename TShader>
+	void process_geometry_stage_result(
+		vector4f const& vertex0, vector4f const& vertex1, vector4f const& vertex2,
+		unsigned int const index0, unsigned int const index1, unsigned int const index2,
+		TShader& shader,
+		texture& target_texture)
+	{
+		vertices.insert(vertices.end(), {vertex0, vertex1, vertex2});
+		indices.insert(indices.end(), {index0, index1, index2});
+	}
+
+	std::vector<vector4f> vertices;
+	std::vector<unsigned int> indices;
+};
+
+TEST(pipeline, batched_vertex_processing_matches_per_vertex)
+{
+	// More vertices than fit into one batch, some of triangles are clipped or outside of the frustum
+	//
+	std::vector<vector3f> vertices;
+	std::vector<unsigned int> indices;
+
+	unsigned int random_state{777};
+	auto next_random = [&random_state]()
+	{
+		random_state = random_state * 1103515245 + 12345;
+		return static_cast<float>((random_state >> 8) & 0xFFFF) / 65535.0f * 3.0f - 1.5f;
+	};
+
+	for (unsigned int i{0}; i < 1000; ++i)
+	{
+		vertices.push_back(vector3f{next_random(), next_random(), next_random()});
+		indices.push_back(i);
+	}
+	mesh random_mesh{vertices, indices};
+
+	matrix4x4f const mvp{matrix4x4f::rotation_around_y_axis(0.3f) * matrix4x4f::translation(0.1f, 0.0f, 2.5f) * matrix4x4f::clip_space(1.2f, 1.0f, 1.0f, 5.0f)};
+
+	color_shader batched_shader;
+	batched_shader.set_mvp_matrix(mvp);
+	per_vertex_matrix_shader per_vertex_shader{mvp};
+
+	texture target_texture{64, 48};
+
+	for (bool const do_homogeneous_division : {false, true})
+	{
+		geometry_stage batched_stage;
+		geometry_stage_results_collector batched_results;
+		batched_stage.invoke(random_mesh, 0, indices.size(), batched_shader, do_homogeneous_division, target_texture, batched_results);
+
+		geometry_stage per_vertex_stage;
+		geometry_stage_results_collector per_vertex_results;
+		per_vertex_stage.invoke(random_mesh, 0, indices.size(), per_vertex_shader, do_homogeneous_division, target_texture, per_vertex_results);
+
+		ASSERT_FALSE(batched_results.indices.empty());
+		ASSERT_FALSE(batched_stage.get_clipped_vertices().empty());
+		ASSERT_TRUE(batched_results.indices == per_vertex_results.indices);
+		ASSERT_EQ(batched_stage.get_clipped_vertices().size(), per_vertex_stage.get_clipped_vertices().size());
+
+		for (size_t i{0}; i < batched_results.vertices.size(); ++i)
+		{
+			ASSERT_EQ(batched_results.vertices[i].x, per_vertex_results.vertices[i].x);
+			ASSERT_EQ(batched_results.vertices[i].y, per_vertex_results.vertices[i].y);
+			ASSERT_EQ(batched_results.vertices[i].z, per_vertex_results.vertices[i].z);
+			ASSERT_EQ(batched_results.vertices[i].w, per_vertex_results.vertices[i].w);
+		}
+	}
+}
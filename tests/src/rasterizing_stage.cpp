@@ -0,0 +1,107 @@
+#include "assert_utils.h"
+#include "allocation_counter.h"
+#include "rasterizing_stage.h"
+
+using namespace lantern;
+
+class interpolated_shader final
+{
+public:
+	color interpolated_color;
+	float interpolated_float;
+	vector2f interpolated_uv;
+	vector3f interpolated_normal;
+};
+
+class pixels_counter final
+{
+public:
+	template<typename TShader>
+	void process_rasterizing_stage_result(vector2ui const& pixel_coordinates, vector3f const& sample_point, TShader& shader, texture& target_texture)
+	{
+		++pixels_count;
+	}
+
+	unsigned int pixels_count;
+};
+
+static void assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option const algorithm, bool const homogeneous)
+{
+	texture target_texture{64, 64};
+
+	// Clip space triangles transformed the same way geometry stage does it:
+	// homogeneous algorithm expects vertices before division by w
+	//
+	std::vector<vector4f> vertices{
+		vector4f{-0.9f, -0.9f, 0.5f, 1.0f}, vector4f{0.8f, -0.7f, 0.5f, 1.0f}, vector4f{-0.1f, 0.9f, 0.5f, 1.0f},
+		vector4f{-0.2f, 0.1f, 0.2f, 0.5f}, vector4f{0.1f, 0.1f, 0.2f, 0.5f}, vector4f{0.0f, 0.3f, 0.2f, 0.5f}};
+
+	for (vector4f& v : vertices)
+	{
+		if (homogeneous)
+		{
+			v = vector4f{(v.x + v.w) * 32.0f, (v.w - v.y) * 32.0f, v.z, v.w};
+		}
+		else
+		{
+			v = vector4f{(v.x / v.w + 1.0f) * 32.0f, (1.0f - v.y / v.w) * 32.0f, v.z / v.w, 1.0f / v.w};
+		}
+	}
+
+	std::vector<unsigned int> const indices{0, 1, 2, 3, 4, 5};
+	mesh_attribute_info<color> const colors{
+		0, std::vector<color>(6, color::RED), indices, attribute_interpolation_option::linear};
+	mesh_attribute_info<float> const floats{
+		1, std::vector<float>(6, 1.0f), indices, attribute_interpolation_option::perspective_correct};
+	mesh_attribute_info<vector2f> const uvs{
+		2, std::vector<vector2f>(6, vector2f{0.5f, 0.5f}), indices, attribute_interpolation_option::perspective_correct};
+	mesh_attribute_info<vector3f> const normals{
+		3, std::vector<vector3f>(6, vector3f{0.0f, 0.0f, 1.0f}), indices, attribute_interpolation_option::linear};
+
+	interpolated_shader shader;
+	std::vector<clipped_vertex_info> const clipped_vertices;
+
+	binded_mesh_attributes binded_attributes;
+	binded_attributes.color_attributes.push_back(binded_mesh_attribute_info<color>{colors, &shader.interpolated_color, &clipped_vertices});
+	binded_attributes.float_attributes.push_back(binded_mesh_attribute_info<float>{floats, &shader.interpolated_float, &clipped_vertices});
+	binded_attributes.vector2f_attributes.push_back(binded_mesh_attribute_info<vector2f>{uvs, &shader.interpolated_uv, &clipped_vertices});
+	binded_attributes.vector3f_attributes.push_back(binded_mesh_attribute_info<vector3f>{normals, &shader.interpolated_normal, &clipped_vertices});
+
+	rasterizing_stage stage;
+	stage.set_rasterization_algorithm(algorithm);
+
+	pixels_counter counter{0};
+
+	auto rasterize_triangles = [&]()
+	{
+		for (unsigned int i{0}; i < vertices.size(); i += 3)
+		{
+			stage.invoke(vertices[i], vertices[i + 1], vertices[i + 2], i, i + 1, i + 2, shader, binded_attributes, target_texture, counter);
+		}
+	};
+
+	// The first pass may allocate intermediate storages, the next ones must reuse them
+	//
+	rasterize_triangles();
+
+	unsigned long long const allocations_before{get_allocations_count()};
+	for (unsigned int i{0}; i < 10; ++i)
+	{
+		rasterize_triangles();
+	}
+
+	ASSERT_EQ(get_allocations_count(), allocations_before);
+	ASSERT_GT(counter.pixels_count, 0u);
+}
+
+TEST(rasterizing_stage, steady_state_rasterization_does_not_allocate)
+{
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_aabb, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_backtracking, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_zigzag, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_aabb_fixed_point, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_aabb_simd, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::traversal_hierarchical, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::inversed_slope, false);
+	assert_steady_state_rasterization_does_not_allocate(rasterization_algorithm_option::homogeneous, true);
+}